@@ -138,18 +138,182 @@
 //  2016-04-23: 1. Incremented version.
 //              2. Added added more diagnostics to deal with exp(prevariable(nan)) problems,
 //                  which seem to be linked to asclogistic5095 parameterization.
+//  2016-04-25: 1. Incremented version.
+//              2. Added "-retroPeels N" command line option to run retrospective peels 0:N
+//                  from a single driver process. Each peel runs in a forked worker
+//                  (sub-folder retro.p) and is warm-started from the previous peel's par file.
+//                  Results and Mohn's rho are written to TCSAM2015.retroPeels.csv.
+//  2016-04-26: 1. Incremented version.
+//              2. Added "-jitterRuns nRuns nWorkers [nConverged]" command line option to run
+//                  an ensemble of jittered model runs in concurrent forked workers (sub-folders
+//                  jitter.r) after all inputs have been parsed. Results are collected in
+//                  TCSAM2015.jitterRuns.csv. The ensemble stops early once nConverged runs
+//                  have converged to the best objective function value.
+//  2016-04-27: 1. Incremented version.
+//              2. Added "-profile param[i] grid [nWorkers]" command line option to calculate
+//                  a likelihood profile over any bounded number vector parameter element.
+//                  The grid is given as "min:max:n" or as a comma-separated list of values.
+//                  Each point is fit with the parameter fixed (sub-folder profile.k) and is
+//                  warm-started from its neighbor's par file. Contiguous blocks of points are
+//                  run concurrently by nWorkers. Objective function components for all points
+//                  are written to TCSAM2015.profile.csv.
+//              3. setWarmStartVals(...) no longer alters fixed parameters.
+//  2016-04-28: 1. Incremented version.
+//              2. Added "-opModBatch file [nWorkers]" command line option to run the population
+//                  model (value-only, no fitting) for each parameter vector in a table (e.g.,
+//                  posterior draws or a design grid) after all inputs are parsed. Blocks of
+//                  vectors are run concurrently by nWorkers. Selected outputs are written to
+//                  the binary table TCSAM2015.opModBatch.bin, with column descriptions in
+//                  TCSAM2015.opModBatch.cols.csv.
+//              3. Refactored warm start functions into setParameterVals(...).
+//  2016-04-29: 1. Incremented version.
+//              2. Added "-warmStart dir" command line option to cache the parameter values at
+//                  the end of each phase in folder dir, keyed by a signature of the parameter
+//                  structure (the parsed parameters info, including phases and bounds, and the
+//                  model years). Subsequent runs with the same signature start from the values
+//                  for the latest cached phase k and resume at phase k+1 (or at the last phase,
+//                  if k is the last phase) by appending "-phase" to the command line.
+//  2016-04-30: 1. Incremented version.
+//              2. Added "-smartPhases" command line option to adapt the phase schedule: phases
+//                  are merged into the next phase when it turns on no new parameters, and the
+//                  convergence criterion for an intermediate phase is loosened to that of the 
+//                  previous phase when the previous phase stalled (used all of its function 
+//                  evaluations without converging).
+//              3. Function evaluation counts and results by phase are written to TCSAM2015.phases.csv.
+//  2016-05-01: 1. Incremented version.
+//              2. Added "-parHess nWorkers [parFile]" command line option to calculate the Hessian
+//                  for a fitted model (parFile, default is the model's par file) by central 
+//                  differences of gradients, with blocks of columns calculated concurrently 
+//                  by nWorkers (sub-folders hess.w). The Hessian is written to 
+//                  TCSAM2015.hessian.bin and standard deviations for the active parameters 
+//                  (in the order of TCSAM2015.params.active.final.csv) are written to 
+//                  TCSAM2015.hessian.std.csv. Use with -nohess on the fitting run.
+//  2016-05-02: 1. Incremented version.
+//              2. -parHess now also calculates gradients of the sdreport variables (see 
+//                  getSdrVariable(...)) and uses an envelope (sparse) Cholesky factorization
+//                  of the Hessian, rather than a dense inverse, to calculate their standard
+//                  deviations (TCSAM2015.sdreport.csv) and those of the parameters. An optional
+//                  relative tolerance for detecting zero Hessian elements can be given 
+//                  ("-parHess nWorkers [parFile [tol]]").
+//  2016-05-03: 1. Incremented version.
+//              2. Added "-stall nEvals [tol]" command line option to end a phase early when
+//                  the best objective function value has improved by less than tol (default
+//                  1e-8) over the last nEvals evaluations. The objective function is frozen
+//                  (zero gradient) at the stalled point so the minimizer exits the phase 
+//                  normally. The reason each phase ended ("converged", "maxfn" or "stalled")
+//                  is added to TCSAM2015.phases.csv, and -smartPhases treats a stalled phase 
+//                  like one that used all of its function evaluations.
+//              3. Added "-trace" command line option to write the evaluation number, phase,
+//                  objective function value, max gradient (as last reported by the minimizer)
+//                  and wall time for each evaluation to TCSAM2015.trace.csv.
+//  2016-05-04: 1. Incremented version.
+//              2. Added "-manifest file -task i" command line options for job-array runs. Each
+//                  line of the manifest is a task name followed by the command line options
+//                  for the task. Task i is run in sub-folder task.name (input files are read
+//                  from the launch folder, so no staging is required) with its options 
+//                  appended to the command line. File names given in options are relative to
+//                  the launch folder. Completed tasks are marked by TCSAM2015.task.done and 
+//                  are skipped when re-submitted.
+//  2016-05-05: 1. Incremented version.
+//              2. Model indices for each parameter combination are compiled once (clipped to
+//                  the model years) after the parameters info file is read. The calcXXX 
+//                  process functions now loop over the compiled indices and reference the 
+//                  parameter combination ids, rather than copying both and checking years
+//                  on every evaluation.
+//  2016-05-06: 1. Incremented version.
+//              2. Natural mortality, growth, maturity and selectivity calculations are now
+//                  memoized: when none of a process's parameters are active in the current
+//                  phase, its results are calculated once, cached as constants and reused
+//                  for the rest of the phase (see calcNatMortMemo(...), etc.). Caches are
+//                  invalidated at phase changes and when parameter values are reset. Use
+//                  the "-noMemo" command line option to turn this off.
+//  2016-05-07: 1. Incremented version.
+//              2. calcSelectivities(...) now copies the time-invariant curve for a parameter
+//                  combination (sel_cz) to years without deviations, rather than 
+//                  re-evaluating the selectivity function for every year.
+//  2016-05-08: 1. Incremented version.
+//              2. calcGrowth(...) now uses GrowthFcns::calcPrGrCumdGamma(...) for optGrowth=1,
+//                  which builds the growth transition matrix in double precision with
+//                  an analytic adjoint w.r.t. grA, grB, grBeta.
+//              3. Replaced NaN test on the sum of the growth matrix with a test on
+//                  the sum of its first row.
+//              4. Added setupGrowthTables() to precompute (ln-scale) growth increments
+//                  and the growth truncation range for optGrowth=0 once, in 
+//                  PRELIMINARY_CALCS_SECTION. The truncation range is now set by the
+//                  maximum growth increment (maxGrDZ, in mm) rather than a number of bins.
+//                  maxGrDZ is read from the model options file (after the growth option;
+//                  ModelOptions version 2016.05.08). The TCSAM2013 value is 45 mm. The
+//                  zero increment (zp=z) is handled explicitly in calcGrowth(...), giving
+//                  the TCSAM2013 transition matrix for alZ>=1 (and no growth for alZ<1,
+//                  where TCSAM2013 gave NaNs).
+//              5. Recruitment is now kept in factored form (R_y, R_yx, R_cz and the
+//                  year-to-pc map pcRec_y). Removed R_yz and R_yxz; recruits-at-size
+//                  are formed where they are used.
+//              6. Natural mortality is now kept in factored form (M_cxm, the year-to-pc
+//                  map pcNM_y, per-pc size-scaling flags zSclNM_c and the size scaling
+//                  zSclM_z). Removed M_yxmsz; getM_z(y,x,m) forms rates-at-size on demand
+//                  and applyNatMort computes survival once per sex/maturity state.
+//              7. Survey catchability is now kept in factored form (Q_cxm, idSelSrv_c and
+//                  the survey/year/sex-to-pc map pcSrv_vyx). Removed q_vyxms, s_vyxmsz
+//                  and q_vyxmsz. During optimization, doSurveys(...) only calculates
+//                  surveys in years with survey data; fillSurveys(...) calculates the
+//                  remaining years for output.
+//              8. calcFisheryFs(...) now makes a single pass through the fishery parameter
+//                  combinations in an order precomputed by setupFisheryFs() (parameter-based
+//                  first, then effort-based), calculating the effort ratios in between. The
+//                  fishery rate arrays are zeroed once in setupFisheryFs() rather than
+//                  every evaluation.
+//              9. ReportToR_ModelResults(...) calculates the numbers and biomass summaries
+//                  of each iyxmsz array in a single pass using tcsam::MarginalSums.
+//             10. runPopDyModOneYear(...) now steps the population through the year using
+//                  fixed-size tcsam::PopState work states (set up once in setupPopDyStates(),
+//                  freed in FINAL_SECTION).
+//                  applyNatMort, applyFshMort and applyMGM write into the next state rather
+//                  than returning a new dvar4_array.
+//             11. calcOFL(...) now creates the OFL calculator (and the PopDyInfo, CatchInfo,
+//                  Tier3_Calculator and PopProjector objects it uses) on the first call only
+//                  and refills them on later calls, rather than leaking a new set per call.
+//                  The calculator is freed in FINAL_SECTION.
+//             12. -stall no longer freezes the objective function (zero gradient) to end a
+//                  stalled phase, and REPORT_SECTION no longer resets the minimizer's max 
+//                  gradient. The minimizer takes a phase's maxfn and convergence criterion
+//                  when the phase starts, so a stall is now recorded (the evaluation at which
+//                  it was detected is in the new "stalled" column of TCSAM2015.phases.csv) and
+//                  acted on when the next phase is scheduled (-smartPhases).
+//             13. -parHess workers are now run through tcsam::runWorkers(...); the driver
+//                  aborts if any worker fails. calcHessianColumns(...) now scales the 
+//                  difference step by the parameter's magnitude and uses a one-sided
+//                  difference for parameters within a step of their bounds. -parHess can
+//                  no longer be combined with -pin (the values are taken from parFile).
+//             14. -parHess now takes the envelope of the Hessian from the model structure
+//                  (see getHessianGroups()) rather than from zeros in the calculated Hessian:
+//                  parameters that only affect the predictions for one survey are ordered
+//                  by survey, ahead of those that affect the population dynamics, so 
+//                  elements between different surveys' parameters lie outside the envelope.
+//                  Only elements inside the envelope are stored (the dense Hessian is no 
+//                  longer formed); elements outside it are checked against the tolerance 
+//                  ("-parHess nWorkers [parFile [tol]]"). TCSAM2015.hessian.bin now holds
+//                  the Hessian as calculated (before symmetrization).
+//             15. calcObjFun(...) saves the objective function components in nllsObjFun;
+//                  REPORT_SECTION writes them for -profile points rather than 
+//                  recalculating them (and objFun).
+//             16. Driver modes now exit through tcsam::exitDriver(...), which marks a 
+//                  manifest task as completed (and exits with status 0) only if all of
+//                  its workers were successful.
 //
 // =============================================================================
 // =============================================================================
 GLOBALS_SECTION
     #include <math.h>
     #include <time.h>
+    #include <stdint.h>
     #include <limits>
+    #include <sstream>
     #include <admodel.h>
     #include "TCSAM.hpp"
 
     adstring model  = tcsam::MODEL;
-    adstring modVer = "2016.04.23"; 
+    adstring modVer = "2016.05.08"; 
     
     time_t start,finish;
     
@@ -160,6 +324,7 @@ GLOBALS_SECTION
     ModelDatasets*       ptrMDS;//ptr to model datasets object
     ModelDatasets*       ptrSimMDS;//ptr to simulated model datasets object
     OFLResults*          ptrOFL;   //pointer to OFL results object for MCMC calculations
+    OFL_Calculator*      ptrOFLCalc;//pointer to OFL calculator (created on first calcOFL call, then reused)
         
     //dimensions for R output
     adstring yDms;
@@ -175,6 +340,7 @@ GLOBALS_SECTION
     
     //file streams and filenames
     std::ofstream mcmc;        //stream for mcmc output
+    std::ofstream trace;       //stream for per-evaluation trace output (-trace)
     
     //filenames
     adstring fnMCMC = "TCSAM2015.MCMC.R";
@@ -189,8 +355,68 @@ GLOBALS_SECTION
     int usePin     = 0;//flag to initialize parameter values using a pin file
     int doRetro    = 0;//flag to facilitate a retrospective model run
     int fitSimData = 0;//flag to fit model to simulated data calculated in the PRELIMINARY_CALCs section
+    int doRetroPeels = 0;//flag to run retrospective peels 0:nRetroPeels from a single driver process
+    int doJitterRuns = 0;//flag to run an ensemble of jittered model runs from a single driver process
+    int doProfile    = 0;//flag to run a likelihood profile from a single driver process
+    int doOpModBatch = 0;//flag to run the operating model for a batch of parameter vectors
     
     int yRetro = 0; //number of years to decrement for retrospective model run
+    int nRetroPeels = 0; //number of retrospective peels to run (if doRetroPeels)
+    int iRetroPeel = -1; //retrospective peel for the current worker run (<0 if not a peel)
+    int useWarmStart = 0;//flag to warm-start parameter values from a par file
+    adstring fnWarmStart;//par file used to warm-start parameter values
+    int nJitterRuns      = 0; //number of jitter runs in ensemble (if doJitterRuns)
+    int nJitterWorkers   = 1; //number of concurrent worker processes for jitter runs
+    int nJitterConverged = 0; //stop jitter ensemble once this many runs have converged to the best (0=never)
+    int iJitterRun       = -1;//jitter run for the current worker (<0 if not a jitter run)
+    double tolJitterObjFun = 1.0e-3;//tolerance on objective function for a jitter run to be converged to the best
+    adstring lblProfile;        //label of profiled parameter (e.g., "pLnM[1]")
+    dvector gridProfile;        //profiled parameter values
+    int nProfileWorkers = 1;    //number of concurrent worker processes for likelihood profile
+    int iProfilePoint   = -1;   //profile grid point for the current worker (<0 if not a profile point)
+    adstring fnOpModBatch;      //file with table of parameter vectors for batch operating model runs
+    int nOpModWorkers   = 1;    //number of concurrent worker processes for batch operating model runs
+    adstring dirWarmStart;      //folder for per-phase warm start cache (-warmStart)
+    adstring sigParams;         //signature of parameter structure for warm start cache
+    int doSmartPhases = 0;      //flag to adapt the phase schedule (-smartPhases)
+    int doParHess     = 0;      //flag to calculate the Hessian using concurrent workers (-parHess)
+    int nHessWorkers  = 1;      //number of concurrent worker processes for Hessian calculations
+    int iHessWorker   = -1;     //Hessian worker for the current process (<0 if not a Hessian worker)
+    adstring fnHessPar;         //par file with parameter values at which to calculate the Hessian
+    double tolHessZero = 0.0;   //relative tolerance for Hessian elements outside the envelope (should be zero)
+    int nStallEvals   = 0;      //number of evaluations over which to test for stalled progress (-stall; 0=off)
+    double tolStall   = 1.0e-8; //minimum improvement in the best objective function value over nStallEvals evaluations
+    dvector bestObjFun;         //ring buffer of the best objective function value over the last nStallEvals+1 evaluations in phase
+    int phsStalled    = 0;      //last phase in which progress stalled (0=none)
+    int nEvalsStalled = 0;      //evaluation (in phase phsStalled) at which the stall was detected
+    int doTrace       = 0;      //flag to write a per-evaluation trace file (-trace)
+    double wtStart    = 0.0;    //wall time at start of evaluations (for -trace)
+    adstring fnManifest;        //run manifest for job-array runs (-manifest)
+    int iTask         = -1;     //task in run manifest for the current run (<0 if not a task run)
+    adstring dirTask;           //sub-folder for the current task run
+    int doMemo        = 1;      //flag to memoize process calculations with no active parameters (-noMemo turns off)
+    int phsMemoNM     = -1;     //phase for which cached natural mortality results are valid (<0 if invalid)
+    int phsMemoGr     = -1;     //phase for which cached growth results are valid (<0 if invalid)
+    int phsMemoMat    = -1;     //phase for which cached maturity results are valid (<0 if invalid)
+    int phsMemoSel    = -1;     //phase for which cached selectivity results are valid (<0 if invalid)
+    d3_array memoM_cxm;         //cached M_cxm
+    dmatrix  memoPrMat_cz;      //cached prMat_cz
+    d3_array memoPrMat_yxz;     //cached prMat_yxz
+    dmatrix  memoMnGrZ_cz;      //cached mnGrZ_cz
+    d3_array memoPrGr_czz;      //cached prGr_czz
+    d4_array memoMnGrZ_yxsz;    //cached mnGrZ_yxsz
+    d5_array memoPrGr_yxszz;    //cached prGr_yxszz
+    dmatrix  memoSel_cz;        //cached sel_cz
+    d3_array memoSel_cyz;       //cached sel_cyz
+    dmatrix grDZ_zz;            //optGrowth=0: realized (positive) growth increments from pre-molt size bin z, truncated at ptrMOs->maxGrDZ
+    dmatrix grLnDZ_zz;          //optGrowth=0: ln-scale grDZ_zz
+    imatrix hasSrvObs_vy;       //flags for survey/year combinations with index catch data
+    i3_array pcSrv_vyx;         //survey parameter combination by survey/year/sex (0 if none; set in calcSurveyQs)
+    ivector idSelSrv_c;         //selectivity function id by survey parameter combination (set in calcSurveyQs)
+    int doSrvAllYrs   = 0;      //flag to calculate surveys in years without survey data (set by fillSurveys)
+    ivector ordFshPCs;          //fishery parameter combinations in calculation order (parameter-based, then effort-based)
+    int nFshPCsP      = 0;      //number of parameter-based fishery parameter combinations at start of ordFshPCs
+    tcsam::PopStateCycle_xms* pPopDyStates = 0;//population states within a model year (see setupPopDyStates(); freed in FINAL_SECTION)
     int iSeed = -1; //default random number generator seed
     random_number_generator rng(iSeed);//random number generator
     int iSimDataSeed = 0;
@@ -261,6 +487,37 @@ DATA_SECTION
     int on = 0;
     int flg = 0;
     rpt::echo<<"#------Reading command line options---------"<<endl;
+    //manifest/task: append task options to command line before parsing other options
+    if ((on=option_match(ad_comm::argc,ad_comm::argv,"-manifest"))>-1) {
+        if ((on+1<argc)&&(ad_comm::argv[on+1][0]!='-')) fnManifest = ad_comm::argv[on+1];
+        if ((on=option_match(ad_comm::argc,ad_comm::argv,"-task"))>-1) {
+            if ((on+1<argc)&&(ad_comm::argv[on+1][0]!='-')) iTask = atoi(ad_comm::argv[on+1]);
+        }
+        RunManifest rm;
+        if ((!fnManifest.size())||(!rm.read(fnManifest))){
+            cout<<"Error: -manifest requires a run manifest file."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        if ((iTask<1)||(iTask>rm.nTasks)){
+            cout<<"Error: -manifest requires -task i, with i in 1:"<<rm.nTasks<<"."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        dirTask = "task."+rm.getTaskName(iTask);
+        if (tcsam::isTaskDone(dirTask)){
+            cout<<"#Task "<<iTask<<" ("<<rm.getTaskName(iTask)<<") has already been completed. Skipping."<<endl;
+            exit(0);
+        }
+        tcsam::appendCommandLineOptions(rm.getTaskOptions(iTask));
+        argc = ad_comm::argc;//so appended options are found below
+        rpt::echo<<"#Running task "<<iTask<<" ("<<rm.getTaskName(iTask)<<") from manifest '"<<fnManifest<<"' in folder "<<dirTask<<endl;
+        rpt::echo<<"#Task options:";
+        for (unsigned int i=0;i<rm.getTaskOptions(iTask).size();i++) rpt::echo<<" "<<rm.getTaskOptions(iTask)[i];
+        rpt::echo<<endl;
+        rpt::echo<<"#-------------------------------------------"<<endl;
+        flg = 1;
+    }
     //configFile
     fnConfigFile = "TCSAM2015_ModelConfig.dat";//default model config filename
     if ((on=option_match(ad_comm::argc,ad_comm::argv,"-configFile"))>-1) {
@@ -305,6 +562,87 @@ DATA_SECTION
         rpt::echo<<"#-------------------------------------------"<<endl;
         flg = 1;
     }
+    //parHess
+    if ((on=option_match(ad_comm::argc,ad_comm::argv,"-parHess"))>-1) {
+        doParHess=1;
+        fnHessPar = ad_comm::adprogram_name+".par";
+        if ((on+1<argc)&&(ad_comm::argv[on+1][0]!='-')) nHessWorkers = atoi(ad_comm::argv[on+1]);
+        if ((on+2<argc)&&(ad_comm::argv[on+2][0]!='-')) fnHessPar    = ad_comm::argv[on+2];
+        if ((on+3<argc)&&(ad_comm::argv[on+3][0]!='-')) tolHessZero  = atof(ad_comm::argv[on+3]);
+        if (nHessWorkers<1){
+            cout<<"Error: -parHess requires the number of workers (> 0)."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        rpt::echo<<"#Hessian calculations for par file '"<<fnHessPar<<"' using "<<nHessWorkers<<" workers"<<endl;
+        rpt::echo<<"#-------------------------------------------"<<endl;
+        flg = 1;
+    }
+    //noMemo
+    if ((on=option_match(ad_comm::argc,ad_comm::argv,"-noMemo"))>-1) {
+        doMemo=0;
+        rpt::echo<<"#Memoization of process calculations turned OFF"<<endl;
+        rpt::echo<<"#-------------------------------------------"<<endl;
+        flg = 1;
+    }
+    //smartPhases
+    if ((on=option_match(ad_comm::argc,ad_comm::argv,"-smartPhases"))>-1) {
+        doSmartPhases=1;
+        rpt::echo<<"#Adaptive phase schedule turned ON"<<endl;
+        rpt::echo<<"#-------------------------------------------"<<endl;
+        flg = 1;
+    }
+    //stall
+    if ((on=option_match(ad_comm::argc,ad_comm::argv,"-stall"))>-1) {
+        if ((on+1<argc)&&(ad_comm::argv[on+1][0]!='-')) nStallEvals = atoi(ad_comm::argv[on+1]);
+        if ((on+2<argc)&&(ad_comm::argv[on+2][0]!='-')) tolStall    = atof(ad_comm::argv[on+2]);
+        if (nStallEvals<1){
+            cout<<"Error: -stall requires the number of evaluations (> 0) over which to test for stalled progress."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        bestObjFun.allocate(0,nStallEvals);
+        rpt::echo<<"#Phases will be flagged as stalled if the objective function improves by less than "<<tolStall<<" over "<<nStallEvals<<" evaluations"<<endl;
+        rpt::echo<<"#-------------------------------------------"<<endl;
+        flg = 1;
+    }
+    //trace
+    if ((on=option_match(ad_comm::argc,ad_comm::argv,"-trace"))>-1) {
+        doTrace=1;
+        rpt::echo<<"#Per-evaluation trace turned ON"<<endl;
+        rpt::echo<<"#-------------------------------------------"<<endl;
+        flg = 1;
+    }
+    //warmStart
+    if ((on=option_match(ad_comm::argc,ad_comm::argv,"-warmStart"))>-1) {
+        if ((on+1<argc)&&(ad_comm::argv[on+1][0]!='-')) {
+            dirWarmStart = ad_comm::argv[on+1];
+        } else {
+            cout<<"Error: -warmStart requires a folder for the warm start cache."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        rpt::echo<<"#Per-phase warm start cache folder: "<<dirWarmStart<<endl;
+        rpt::echo<<"#-------------------------------------------"<<endl;
+        flg = 1;
+    }
+    //opModBatch
+    if ((on=option_match(ad_comm::argc,ad_comm::argv,"-opModBatch"))>-1) {
+        doOpModBatch=1;
+        opModMode=1;
+        if ((on+1<argc)&&(ad_comm::argv[on+1][0]!='-')) fnOpModBatch = ad_comm::argv[on+1];
+        if ((on+2<argc)&&(ad_comm::argv[on+2][0]!='-')) nOpModWorkers = atoi(ad_comm::argv[on+2]);
+        if ((!fnOpModBatch.size())||(nOpModWorkers<1)){
+            cout<<"Error: -opModBatch requires a file with a table of parameter vectors and, optionally, the number of workers (> 0)."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        rpt::echo<<"#batch operating model mode turned ON"<<endl;
+        rpt::echo<<"#Parameter vectors file: "<<fnOpModBatch<<endl;
+        rpt::echo<<nOpModWorkers<<"  #number of workers"<<endl;
+        rpt::echo<<"#-------------------------------------------"<<endl;
+        flg = 1;
+    }
     //calcOFL
     if ((on=option_match(ad_comm::argc,ad_comm::argv,"-calcOFL"))>-1) {
         doOFL=1;
@@ -360,6 +698,34 @@ DATA_SECTION
         rpt::echo<<"#-------------------------------------------"<<endl;
         flg = 1;
     }
+    //retroPeels
+    if ((on=option_match(ad_comm::argc,ad_comm::argv,"-retroPeels"))>-1) {
+        doRetroPeels=1;
+        nRetroPeels=0;
+        if (on+1<argc) {
+            char* end = 0;
+            long n = strtol(ad_comm::argv[on+1],&end,10);
+            if ((end!=ad_comm::argv[on+1])&&(*end=='\0')&&(n==(long)(int) n)) nRetroPeels = (int) n;
+        } else {
+            cout<<"-------------------------------------------"<<endl;
+            cout<<"Enter number of retrospective peels: ";
+            if (!(cin>>nRetroPeels)) nRetroPeels = 0;
+        }
+        if (nRetroPeels<1){
+            cout<<"Error: -retroPeels requires the number of peels as a positive integer."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        if (doRetro){
+            cout<<"Error: -retroPeels and -doRetro cannot both be specified."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        cout<<"#Retrospective peels 0:"<<nRetroPeels<<" will be run from a single process"<<endl;
+        rpt::echo<<"#Retrospective peels 0:"<<nRetroPeels<<" will be run from a single process"<<endl;
+        rpt::echo<<"#-------------------------------------------"<<endl;
+        flg = 1;
+    }
     //fitSimData
     if ((on=option_match(ad_comm::argc,ad_comm::argv,"-fitSimData"))>-1) {
         fitSimData=1;
@@ -390,6 +756,55 @@ DATA_SECTION
         rpt::echo<<"#-------------------------------------------"<<endl;
         flg = 1;
     }
+    //jitterRuns
+    if ((on=option_match(ad_comm::argc,ad_comm::argv,"-jitterRuns"))>-1) {
+        doJitterRuns=1;
+        if ((on+1<argc)&&(ad_comm::argv[on+1][0]!='-')) nJitterRuns      = atoi(ad_comm::argv[on+1]);
+        if ((on+2<argc)&&(ad_comm::argv[on+2][0]!='-')) nJitterWorkers   = atoi(ad_comm::argv[on+2]);
+        if ((on+3<argc)&&(ad_comm::argv[on+3][0]!='-')) nJitterConverged = atoi(ad_comm::argv[on+3]);
+        if ((nJitterRuns<1)||(nJitterWorkers<1)){
+            cout<<"Error: -jitterRuns requires the number of runs and number of workers (both > 0)."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        if (iSeed<0) iSeed=(long)start;
+        if ((on=option_match(ad_comm::argc,ad_comm::argv,"-iSeed"))>-1) {
+            if (on+1<argc) {
+                iSeed=atoi(ad_comm::argv[on+1]);
+            }
+        } 
+        cout<<"#Jitter ensemble of "<<nJitterRuns<<" runs using "<<nJitterWorkers<<" workers"<<endl;
+        rpt::echo<<"#Jitter ensemble of "<<nJitterRuns<<" runs using "<<nJitterWorkers<<" workers"<<endl;
+        rpt::echo<<nJitterConverged<<"  #number of converged runs to stop ensemble (0=never)"<<endl;
+        rpt::echo<<iSeed<<"  #base iSeed"<<endl;
+        rpt::echo<<"#-------------------------------------------"<<endl;
+        flg = 1;
+    }
+    //profile
+    if ((on=option_match(ad_comm::argc,ad_comm::argv,"-profile"))>-1) {
+        doProfile=1;
+        if ((on+2<argc)&&(ad_comm::argv[on+1][0]!='-')) {
+            lblProfile  = ad_comm::argv[on+1];
+            gridProfile = tcsam::parseGrid(ad_comm::argv[on+2]);
+        }
+        if ((on+3<argc)&&(ad_comm::argv[on+3][0]!='-')) nProfileWorkers = atoi(ad_comm::argv[on+3]);
+        if ((!gridProfile.size())||(nProfileWorkers<1)){
+            cout<<"Error: -profile requires a parameter label (e.g., pLnM[1]) and a grid of values"<<endl;
+            cout<<"given as 'min:max:n' or as a comma-separated list, and optionally the number of workers (> 0)."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        if (doRetroPeels||doJitterRuns){
+            cout<<"Error: -profile cannot be combined with -retroPeels or -jitterRuns."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        cout<<"#Likelihood profile for "<<lblProfile<<" over "<<gridProfile.size()<<" values using "<<nProfileWorkers<<" workers"<<endl;
+        rpt::echo<<"#Likelihood profile for "<<lblProfile<<" using "<<nProfileWorkers<<" workers"<<endl;
+        rpt::echo<<gridProfile<<"  #profile grid"<<endl;
+        rpt::echo<<"#-------------------------------------------"<<endl;
+        flg = 1;
+    }
     //resample
     if ((on=option_match(ad_comm::argc,ad_comm::argv,"-resample"))>-1) {
         resample=1;
@@ -475,6 +890,18 @@ DATA_SECTION
         rpt::echo<<"#-------------------------------------------"<<endl;
         flg = 1;
     }
+    //check option combinations (all options have been parsed)
+    if (doParHess&&(doRetroPeels||doJitterRuns||doProfile)){
+        cout<<"Error: -parHess cannot be combined with -retroPeels, -jitterRuns or -profile."<<endl;
+        cout<<"Aborting..."<<endl;
+        exit(-1);
+    }
+    if (doParHess&&usePin){
+        cout<<"Error: -parHess cannot be combined with -pin, -binp or -ainp."<<endl;
+        cout<<"The parameter values are taken from the -parHess par file ('"<<fnHessPar<<"')."<<endl;
+        cout<<"Aborting..."<<endl;
+        exit(-1);
+    }
  END_CALCS
  
     int nZBs;  //number of model size bins
@@ -494,6 +921,60 @@ DATA_SECTION
     
     mnYr   = ptrMC->mnYr;
     mxYr   = ptrMC->mxYr;
+    if (iTask>0){
+        //run task in its own sub-folder. Input files in the configuration are
+        //rebased to the launch folder, as are file names given as options.
+        if (!tcsam::changeToRunDirectory(dirTask,ptrMC)) exit(-1);
+        tcsam::rebaseCommandLineOption("-pin", "..");
+        tcsam::rebaseCommandLineOption("-ainp","..");
+        tcsam::rebaseCommandLineOption("-binp","..");
+        if (usePin)              fnPin        = tcsam::rebaseFilePath("..",fnPin);
+        if (dirWarmStart.size()) dirWarmStart = tcsam::rebaseFilePath("..",dirWarmStart);
+        if (doOpModBatch)        fnOpModBatch = tcsam::rebaseFilePath("..",fnOpModBatch);
+        if (doParHess)           fnHessPar    = tcsam::rebaseFilePath("..",fnHessPar);
+    }
+    if (doRetroPeels){
+        //run peels sequentially in forked worker processes, each in its own
+        //sub-folder. Workers continue from here with the already-parsed
+        //configuration; the driver collects the results and exits.
+        int p = 0;
+        ivector status_p;//worker exit status by peel
+        for (p=0;p<=nRetroPeels;p++){
+            //remove results from any earlier invocation so a failed peel can't contribute them
+            adstring fnPeel = "retro."+itoa(p,10)+"/TCSAM2015.retro.csv";
+            remove((char*) fnPeel);
+        }
+        //peels run one at a time, so each can be warm-started from the previous one
+        int res = tcsam::runWorkers(0,nRetroPeels,1,"retrospective peel",p,status_p);
+        if (res>0){
+            //worker for peel p
+            doRetroPeels = 0;
+            iRetroPeel = p;
+            if (p>0) {doRetro = 1; yRetro = p;}
+            if (!tcsam::changeToRunDirectory("retro."+itoa(p,10),ptrMC)) exit(-1);
+            if ((p>0)&&(!usePin)){
+                useWarmStart = 1;
+                fnWarmStart = "../retro."+itoa(p-1,10)+"/"+ad_comm::adprogram_name+".par";
+            }
+        } else {
+            //driver: aggregate results over peels and quit
+            RetroPeelsResults rpr(nRetroPeels,mnYr,mxYr);
+            for (p=0;p<=nRetroPeels;p++) {
+                if (status_p(p)==0) {
+                    rpr.readPeel(p,"retro."+itoa(p,10)+"/TCSAM2015.retro.csv");
+                } else {
+                    cout<<"#--Skipping results for retrospective peel "<<p<<" (exit status "<<status_p(p)<<")"<<endl;
+                    rpt::echo<<"#--Skipping results for retrospective peel "<<p<<" (exit status "<<status_p(p)<<")"<<endl;
+                }
+            }
+            ofstream osRetro("TCSAM2015.retroPeels.csv", ios::trunc);
+            rpr.writeToCSV(osRetro);
+            osRetro.close();
+            cout<<"#Finished retrospective peels. Results written to TCSAM2015.retroPeels.csv"<<endl;
+            rpt::echo<<"#Finished retrospective peels. Results written to TCSAM2015.retroPeels.csv"<<endl;
+            tcsam::exitDriver(iTask,res);//does not return
+        }
+    }
     if (doRetro){mxYr = mxYr-yRetro; ptrMC->setMaxModelYear(mxYr);}
     if (jitter)   {ptrMC->jitter=1;}
     if (resample) {ptrMC->resample = 1;}
@@ -530,6 +1011,7 @@ DATA_SECTION
     ptrMPI = new ModelParametersInfo(*ptrMC);
     ad_comm::change_datafile_name(ptrMC->fnMPI);
     ptrMPI->read(*(ad_comm::global_datafile));
+    ptrMPI->compilePlans(mnYr,mxYr);//compile model indices for process calculations
     if (debugModelParamsInfo) {
         cout<<"enter 1 to continue : ";
         cin>>debugModelParamsInfo;
@@ -665,6 +1147,78 @@ DATA_SECTION
     }
  END_CALCS
  
+ LOCAL_CALCS
+    if (doProfile){
+        //find the profiled parameter and check the grid
+        adstring nmProfile; int idxProfile;
+        BoundedNumberVectorInfo* pProfileBNVI = 0;
+        if (tcsam::parseParameterLabel(lblProfile,nmProfile,idxProfile)) pProfileBNVI = ptrMPI->getBoundedNumberVectorInfo(nmProfile);
+        if ((!pProfileBNVI)||(idxProfile>pProfileBNVI->getSize())){
+            cout<<"Error: could not find parameter '"<<lblProfile<<"' to profile in the parameters info file."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        BoundedNumberInfo* pProfileBNI = (*pProfileBNVI)[idxProfile];
+        for (int k=gridProfile.indexmin();k<=gridProfile.indexmax();k++){
+            if ((gridProfile(k)<pProfileBNI->getLowerBound())||(pProfileBNI->getUpperBound()<gridProfile(k))){
+                cout<<"Error: profile value "<<gridProfile(k)<<" for "<<lblProfile<<" is outside the parameter bounds ["
+                    <<pProfileBNI->getLowerBound()<<cc<<pProfileBNI->getUpperBound()<<"]."<<endl;
+                cout<<"Aborting..."<<endl;
+                exit(-1);
+            }
+        }
+        //run contiguous blocks of grid points in concurrent forked chain workers. 
+        //Each chain runs its points sequentially in forked point workers (sub-folder 
+        //profile.k), so each point can be warm-started from its neighbor's par file.
+        //Point workers continue from here to fit the model with the parameter fixed;
+        //the driver collects the results and exits.
+        int nPts = gridProfile.size();
+        int nChains = min(nProfileWorkers,nPts);
+        for (int k=1;k<=nPts;k++){
+            //remove results from any earlier invocation so a failed point can't contribute them
+            adstring fnPt = "profile."+itoa(k,10)+"/TCSAM2015.profile.csv";
+            remove((char*) fnPt);
+        }
+        int c = 0;
+        ivector status_c;//exit status by chain
+        int res = tcsam::runWorkers(1,nChains,nChains,"profile chain",c,status_c);
+        if (res>0){
+            //chain worker: run grid points k1:k2 sequentially
+            int k1 = 1+((c-1)*nPts)/nChains;
+            int k2 = (c*nPts)/nChains;
+            int k = 0;
+            ivector status_k;//exit status by point
+            int resk = tcsam::runWorkers(k1,k2,1,"profile point",k,status_k);
+            if (resk<=0) exit(resk<0 ? 1 : 0);//chain finished (with an error if any point failed)
+            //worker for profile point k: fix parameter at grid value
+            doProfile = 0;
+            iProfilePoint = k;
+            pProfileBNI->setInitVal(gridProfile(k));
+            pProfileBNI->setPhase(-1);
+            if (!tcsam::changeToRunDirectory("profile."+itoa(k,10),ptrMC)) exit(-1);
+            rpt::echo<<"#Profile point "<<k<<": "<<lblProfile<<" fixed at "<<gridProfile(k)<<endl;
+            if ((k>k1)&&(!usePin)){
+                useWarmStart = 1;
+                fnWarmStart = "../profile."+itoa(k-1,10)+"/"+ad_comm::adprogram_name+".par";
+            }
+        } else {
+            //driver: all chains have finished. Aggregate results and quit
+            if (res<0){
+                cout<<"#--Warning: one or more profile points failed. Their results are missing from TCSAM2015.profile.csv"<<endl;
+                rpt::echo<<"#--Warning: one or more profile points failed. Their results are missing from TCSAM2015.profile.csv"<<endl;
+            }
+            ProfileResults pr(lblProfile,gridProfile);
+            for (int k=1;k<=nPts;k++) pr.readPoint(k,"profile."+itoa(k,10)+"/TCSAM2015.profile.csv");
+            ofstream osProf("TCSAM2015.profile.csv", ios::trunc);
+            pr.writeToCSV(osProf);
+            osProf.close();
+            cout<<"#Finished likelihood profile. Results written to TCSAM2015.profile.csv"<<endl;
+            rpt::echo<<"#Finished likelihood profile. Results written to TCSAM2015.profile.csv"<<endl;
+            tcsam::exitDriver(iTask,res);//does not return
+        }
+    }
+ END_CALCS
+ 
     //Extract parameter information
     //recruitment parameters
     int npLnR; ivector phsLnR; vector lbLnR; vector ubLnR;
@@ -704,6 +1258,8 @@ DATA_SECTION
     
     number zMref;
     !!zMref = ptrMPI->ptrNM->zRef;
+    vector zSclM_z(1,nZBs);//size scaling for natural mortality
+    !!zSclM_z = zMref/zBs;
     
     //maturity parameters
     int npLgtPrMat; ivector mniLgtPrMat; ivector mxiLgtPrMat; imatrix idxsLgtPrMat;
@@ -829,6 +1385,9 @@ DATA_SECTION
     !!npcSrv = ptrMPI->ptrSrv->nPCs;
     
     imatrix idxDevsLnC_fy(1,nFsh,mnYr,mxYr); //matrix to check devs indexing for lnC
+    ivector pcRec_y(mnYr,mxYr);              //recruitment parameter combination by year (0 if none; set in calcRecruitment)
+    ivector pcNM_y(mnYr,mxYr);               //natural mortality parameter combination by year (0 if none; set in calcNatMort)
+    ivector zSclNM_c(1,npcNM);               //flags to apply size scaling to natural mortality by parameter combination (set in calcNatMort)
     
     //dimensions for output to R
     !!yDms = ptrMC->dimYrsToR;//years (mny:mxy)
@@ -847,6 +1406,12 @@ DATA_SECTION
     
     //create OFL results object
     !!ptrOFL = new OFLResults();
+    !!ptrOFLCalc = 0;//created on first call to calcOFL(...)
+    
+    //objective function components (penalties, priors, recruitment, fisheries, surveys),
+    //as of the last call to calcObjFun(...)
+    vector nllsObjFun(1,tcsam::nObjFunComps);
+    !!nllsObjFun.initialize();
     
     //counters for PROCEDURE_SECTION calls
     int ctrProcCalls;       //all calls
@@ -854,6 +1419,193 @@ DATA_SECTION
     !!ctrProcCalls        = 0;
     !!ctrProcCallsInPhase = 0;
     
+ LOCAL_CALCS
+    if (doJitterRuns){
+        //run jittered models in concurrent forked worker processes, each in 
+        //its own sub-folder. All inputs have been parsed at this point, so
+        //workers share the parsed state. The driver collects the results and exits.
+        JitterRunsResults jrr(nJitterRuns,tolJitterObjFun);
+        jrr.nStop = nJitterConverged;//jrr reads each run's results as it finishes
+        for (int i=1;i<=nJitterRuns;i++) jrr.seed(i) = iSeed+i;
+        int r = 0;//jitter run for worker
+        ivector status_r;
+        int res = tcsam::runWorkers(1,nJitterRuns,nJitterWorkers,"jitter run",r,status_r,&jrr);
+        if (res>0){
+            //worker for jitter run r
+            doJitterRuns = 0;
+            iJitterRun = r;
+            iSeed = iSeed+r;
+            jitter = 1;
+            ptrMC->jitter = 1;
+            rng.reinitialize(iSeed);
+            if (!tcsam::changeToRunDirectory("jitter."+itoa(r,10),ptrMC)) exit(-1);
+            rpt::echo<<"#Jitter run "<<r<<" using iSeed = "<<iSeed<<endl;
+        } else {
+            //driver: write ensemble results and quit
+            ofstream osJit("TCSAM2015.jitterRuns.csv", ios::trunc);
+            jrr.writeToCSV(osJit);
+            osJit.close();
+            cout<<"#Finished jitter runs. Best run was "<<jrr.getBestRun()<<". Results written to TCSAM2015.jitterRuns.csv"<<endl;
+            rpt::echo<<"#Finished jitter runs. Best run was "<<jrr.getBestRun()<<". Results written to TCSAM2015.jitterRuns.csv"<<endl;
+            tcsam::exitDriver(iTask,res);//does not return
+        }
+    }
+ END_CALCS
+    
+ LOCAL_CALCS
+    if (doParHess){
+        //calculate blocks of Hessian columns in concurrent forked worker processes,
+        //each in its own sub-folder (so ADMB's temporary gradient files are not shared).
+        //Workers continue from here and calculate their columns in PRELIMINARY_CALCS;
+        //the driver assembles the Hessian and exits.
+        int w = 0;
+        ivector status_w;//exit status by worker
+        for (w=1;w<=nHessWorkers;w++){
+            //remove results from any earlier invocation so a failed worker can't contribute them
+            adstring fnCols = "hess."+itoa(w,10)+"/TCSAM2015.hessian.cols.bin";
+            adstring fnDeps = "hess."+itoa(w,10)+"/TCSAM2015.hessian.deps.bin";
+            remove((char*) fnCols);
+            remove((char*) fnDeps);
+        }
+        remove("hess.1/TCSAM2015.hessian.info.dat");
+        int res = tcsam::runWorkers(1,nHessWorkers,nHessWorkers,"Hessian worker",w,status_w);
+        if (res>0){
+            //worker w
+            doParHess = 0;
+            iHessWorker = w;
+            if (!tcsam::changeToRunDirectory("hess."+itoa(w,10),ptrMC)) exit(-1);
+            useWarmStart = 1;
+            fnWarmStart = tcsam::rebaseFilePath("..",fnHessPar);
+        } else {
+            //driver: assemble Hessian and quit (every block of columns is required)
+            if (res<0){
+                for (w=1;w<=nHessWorkers;w++){
+                    if (status_w(w)!=0) cout<<"Error: Hessian worker "<<w<<" failed (exit status "<<status_w(w)<<", see hess."<<w<<"/EchoData.dat)."<<endl;
+                }
+                cout<<"Aborting..."<<endl;
+                exit(-1);
+            }
+            int nvar = 0;
+            ifstream isInfo("hess.1/TCSAM2015.hessian.info.dat");
+            isInfo>>nvar;
+            if (nvar<1){
+                cout<<"Error: Hessian calculations failed (see hess.1/EchoData.dat)."<<endl;
+                exit(-1);
+            }
+            dvector x(1,nvar);   isInfo>>x;
+            dvector scl(1,nvar); isInfo>>scl;
+            ivector grp(1,nvar); isInfo>>grp;//see getHessianGroups()
+            int nDep = 0;        isInfo>>nDep;
+            dvector vDep(1,nDep); isInfo>>vDep;
+            adstring_array lblsDep(1,nDep); for (int k=1;k<=nDep;k++) isInfo>>lblsDep(k);
+            isInfo.close();
+            //order the parameters by group: each survey's parameters (coupled only to 
+            //themselves and the population parameters) first, then the population 
+            //parameters (coupled to all), so the envelope excludes the elements 
+            //between different surveys' parameters
+            ivector prm(1,nvar);  //parameter index, by position
+            ivector pos(1,nvar);  //position, by parameter index
+            ivector first(1,nvar);//first position in the envelope, by position
+            int n = 0;
+            int nGrps = 0;
+            for (int i=1;i<=nvar;i++) if (grp(i)>nGrps) nGrps = grp(i);
+            for (int v=1;v<=nGrps;v++){
+                int n0 = n+1;
+                for (int i=1;i<=nvar;i++) if (grp(i)==v) {prm(++n) = i; first(n) = n0;}
+            }
+            for (int i=1;i<=nvar;i++) if (grp(i)<=0) {prm(++n) = i; first(n) = 1;}
+            for (int p=1;p<=nvar;p++) pos(prm(p)) = p;
+            EnvelopeCholesky chol(first);
+            //read the columns twice, streaming them from the workers' files (in column
+            //order): first to write the Hessian file and get the diagonal, then to add 
+            //the elements inside the envelope (symmetrized) and check those outside it
+            int nCols = 0;
+            dvector row(0,nvar);
+            dvector d(1,nvar);
+            {ofstream osH("TCSAM2015.hessian.bin", ios::binary|ios::trunc);
+             int32_t hdr[2] = {nvar,nvar};
+             osH.write((char*) hdr,sizeof(hdr));
+             for (w=1;w<=nHessWorkers;w++){
+                 adstring fnCols = "hess."+itoa(w,10)+"/TCSAM2015.hessian.cols.bin";
+                 ifstream is((char*) fnCols, ios::binary);
+                 while ((nCols<nvar)&&tcsam::readBinaryRow(is,row)&&((int) row(0)==nCols+1)){
+                     nCols++;
+                     for (int j=1;j<=nvar;j++) {double v = row(j); osH.write((char*) &v,sizeof(double));}
+                     d(nCols) = row(nCols);
+                 }
+             }
+             osH.close();
+            }
+            if (nCols<nvar) remove("TCSAM2015.hessian.bin");
+            double mxOut = 0.0;//max relative size of elements outside the envelope
+            int nOut = 0;      //number of elements outside the envelope larger than tol
+            for (w=1;(w<=nHessWorkers)&&(nCols==nvar);w++){
+                adstring fnCols = "hess."+itoa(w,10)+"/TCSAM2015.hessian.cols.bin";
+                ifstream is((char*) fnCols, ios::binary);
+                while (tcsam::readBinaryRow(is,row)){
+                    int i = (int) row(0);
+                    chol.add(pos(i),pos(i),row(i));
+                    for (int j=1;j<=nvar;j++){
+                        if ((j!=i)&&(!chol.add(pos(i),pos(j),0.5*row(j)))){
+                            double sd = sqrt(fabs(d(i)*d(j)));
+                            double r = (sd>0.0) ? fabs(row(j))/sd : fabs(row(j));
+                            if (r>mxOut) mxOut = r;
+                            if (r>tolHessZero) nOut++;
+                        }
+                    }
+                }
+            }
+            dmatrix G(1,nDep,1,nvar); G.initialize();//gradients of sdreport variables
+            ivector hasDep(1,nDep);   hasDep.initialize();
+            for (w=1;w<=nHessWorkers;w++){
+                int nRows = 0;
+                dmatrix deps = tcsam::readBinaryRows("hess."+itoa(w,10)+"/TCSAM2015.hessian.deps.bin",nvar+1,nRows);
+                for (int r=1;r<=nRows;r++){
+                    int k = (int) deps(r,1);
+                    for (int j=1;j<=nvar;j++) G(k,j) = deps(r,j+1);
+                    hasDep(k) = 1;
+                }
+            }
+            if ((nCols<nvar)||(sum(hasDep)<nDep)){
+                cout<<"Error: Hessian calculations are missing "<<nvar-nCols<<" columns and "<<nDep-sum(hasDep)<<" sdreport gradients."<<endl;
+                exit(-1);
+            }
+            cout<<"#Hessian envelope fraction = "<<chol.getEnvelopeFraction()<<endl;
+            rpt::echo<<"#Hessian envelope fraction = "<<chol.getEnvelopeFraction()<<endl;
+            rpt::echo<<"#Max relative size of Hessian elements outside the envelope = "<<mxOut<<endl;
+            if (nOut){
+                cout<<"Error: "<<nOut<<" Hessian elements outside the envelope are not zero (max relative size = "<<mxOut<<")."<<endl;
+                cout<<"Check the parameter groups in getHessianGroups() or increase the -parHess tolerance."<<endl;
+                cout<<"Aborting..."<<endl;
+                exit(-1);
+            }
+            if (!chol.factor()){
+                cout<<"Error: Hessian is not positive definite. Standard deviations cannot be calculated."<<endl;
+                exit(-1);
+            }
+            ofstream osStd("TCSAM2015.hessian.std.csv", ios::trunc);
+            osStd<<"index,x,std.dev"<<endl;
+            dvector e(1,nvar); e.initialize();
+            for (int i=1;i<=nvar;i++){
+                e(pos(i)) = 1.0;
+                osStd<<i<<cc<<x(i)<<cc<<sqrt(chol.calcQuadForm(e))*scl(i)<<endl;
+                e(pos(i)) = 0.0;
+            }
+            osStd.close();
+            ofstream osSdr("TCSAM2015.sdreport.csv", ios::trunc);
+            osSdr<<"name,value,std.dev"<<endl;
+            for (int k=1;k<=nDep;k++){
+                for (int j=1;j<=nvar;j++) e(pos(j)) = G(k,j);
+                osSdr<<qt<<lblsDep(k)<<qt<<cc<<vDep(k)<<cc<<sqrt(chol.calcQuadForm(e))<<endl;
+            }
+            osSdr.close();
+            cout<<"#Finished Hessian calculations. Results written to TCSAM2015.hessian.bin, TCSAM2015.hessian.std.csv and TCSAM2015.sdreport.csv"<<endl;
+            rpt::echo<<"#Finished Hessian calculations. Results written to TCSAM2015.hessian.bin, TCSAM2015.hessian.std.csv and TCSAM2015.sdreport.csv"<<endl;
+            tcsam::exitDriver(iTask,res);//does not return
+        }
+    }
+ END_CALCS
+    
  LOCAL_CALCS
     rpt::echo<<"#finished DATA_SECTION"<<endl;
     cout<<"#finished DATA_SECTION"<<endl;
@@ -944,15 +1696,12 @@ PARAMETER_SECTION
     vector R_y(mnYr,mxYr);         //total number of recruits by year
     vector Rx_c(1,npcRec);         //male fraction of recruits by parameter combination
     matrix R_yx(mnYr,mxYr,1,nSXs); //sex-specific fraction of recruits by year
-    matrix R_cz(1,npcRec,1,nZBs);  //size distribution of recruits by parameter combination
-    matrix R_yz(mnYr,mxYr,1,nZBs); //size distribution of recruits by year
-    3darray R_yxz(mnYr,mxYr,1,nSXs,1,nZBs);    //size distribution of recruits by year, sex
+    matrix R_cz(1,npcRec,1,nZBs);  //size distribution of recruits by parameter combination (by year: R_cz(pcRec_y(y)))
     matrix stdvDevsLnR_cy(1,npcRec,mnYr,mxYr); //ln-scale recruitment std. devs by parameter combination and year
     matrix zscrDevsLnR_cy(1,npcRec,mnYr,mxYr); //standardized ln-scale recruitment residuals by parameter combination and year
     
     //natural mortality-related quantities
     3darray M_cxm(1,npcNM,1,nSXs,1,nMSs);                  //natural mortality rate by parameter combination
-    5darray M_yxmsz(mnYr,mxYr,1,nSXs,1,nMSs,1,nSCs,1,nZBs);//size-specific natural mortality rate
     
     //maturity-related quantities
     matrix  prMat_cz(1,npcMat,1,nZBs);         //prob. of immature crab molting to maturity by parameter combination
@@ -989,9 +1738,7 @@ PARAMETER_SECTION
     
     //survey-related quantities
     3darray mb_vyx(1,nSrv,mnYr,mxYr+1,1,nSXs);//mature (spawning) biomass at time of survey
-    5darray q_vyxms(1,nSrv,mnYr,mxYr+1,1,nSXs,1,nMSs,1,nSCs);        //fully-selected catchability in survey v
-    6darray s_vyxmsz(1,nSrv,mnYr,mxYr+1,1,nSXs,1,nMSs,1,nSCs,1,nZBs);//selectivity functions
-    6darray q_vyxmsz(1,nSrv,mnYr,mxYr+1,1,nSXs,1,nMSs,1,nSCs,1,nZBs);//size-specific catchability in survey v
+    3darray Q_cxm(1,npcSrv,1,nSXs,1,nMSs);                           //fully-selected survey catchability by parameter combination
     6darray n_vyxmsz(1,nSrv,mnYr,mxYr+1,1,nSXs,1,nMSs,1,nSCs,1,nZBs);//catch at size in survey v
     
     //objective function penalties
@@ -1035,12 +1782,69 @@ PRELIMINARY_CALCS_SECTION
     cout<<"#Starting PRELIMINARY_CALCS_SECTION"<<endl;
     int debug=1;
     
+    if (doMemo){//allocate caches for memoized process calculations
+        memoM_cxm.allocate(1,npcNM,1,nSXs,1,nMSs);
+        memoPrMat_cz.allocate(1,npcMat,1,nZBs);
+        memoPrMat_yxz.allocate(mnYr,mxYr,1,nSXs,1,nZBs);
+        memoMnGrZ_cz.allocate(1,npcGr,1,nZBs);
+        memoPrGr_czz.allocate(1,npcGr,1,nZBs,1,nZBs);
+        memoMnGrZ_yxsz.allocate(mnYr,mxYr,1,nSXs,1,nSCs,1,nZBs);
+        memoPrGr_yxszz.allocate(mnYr,mxYr,1,nSXs,1,nSCs,1,nZBs,1,nZBs);
+        memoSel_cz.allocate(1,npcSel,1,nZBs);
+        memoSel_cyz.allocate(1,nSel,mnYr,mxYr+1,1,nZBs);
+    }
+    
+    setupGrowthTables();
+    setupSurveyYears();
+    setupFisheryFs();
+    setupPopDyStates();
+    
     //set initial values for all parameters
     if (usePin) {
         rpt::echo<<"NOTE: setting initial values for parameters using pin file"<<endl;
     } else {
         rpt::echo<<"NOTE: setting initial values for parameters using setInitVals(...)"<<endl;
         setInitVals();
+        if (useWarmStart) {
+            rpt::echo<<"NOTE: warm-starting parameter values using par file '"<<fnWarmStart<<"'"<<endl;
+            setWarmStartVals(fnWarmStart,0,rpt::echo);
+        }
+    }
+    
+    //set up per-phase warm start cache
+    if (dirWarmStart.size()){
+        std::ostringstream oss;
+        oss<<mnYr<<tb<<mxYr<<endl;
+        ptrMPI->write(oss);
+        sigParams = tcsam::calcSignature(oss.str());
+        rpt::echo<<"parameter structure signature for warm start cache: "<<sigParams<<endl;
+        if (!tcsam::makeDirectory(dirWarmStart)){
+            cout<<"Error: could not create warm start cache folder '"<<dirWarmStart<<"'"<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+        if ((!usePin)&&(!useWarmStart)&&(!jitter)&&(!resample)){
+            for (int k=initial_params::max_number_phases;k>0;k--){
+                adstring fn = getWarmStartCacheFile(k);
+                if (tcsam::fileExists(fn)){
+                    cout<<"NOTE: warm-starting parameter values from cached phase "<<k<<endl;
+                    rpt::echo<<"NOTE: warm-starting parameter values from cached phase "<<k<<" ('"<<fn<<"')"<<endl;
+                    setWarmStartVals(fn,0,rpt::echo);
+                    //resume minimization after the cached phase (the last phase is always 
+                    //re-run so the final outputs are produced), unless -phase was given
+                    if (option_match(ad_comm::argc,ad_comm::argv,"-phase")<0){
+                        int phs = (k<initial_params::max_number_phases) ? k+1 : k;
+                        std::vector<std::string> opts;
+                        opts.push_back("-phase");
+                        opts.push_back((char*) itoa(phs,10));
+                        tcsam::appendCommandLineOptions(opts);
+                        cout<<"NOTE: resuming minimization at phase "<<phs<<endl;
+                        rpt::echo<<"NOTE: resuming minimization at phase "<<phs<<endl;
+                    }
+                    break;
+                }
+            }
+        }
     }
 
     cout<<"testing setAllDevs()"<<endl;
@@ -1068,6 +1872,19 @@ PRELIMINARY_CALCS_SECTION
      cout<<"finished writing parameters info to csv"<<endl;
     }
     
+    {//start phase log
+     ofstream osPhs("TCSAM2015.phases.csv", ios::trunc);
+     osPhs<<"phase,nActive,nNew,maxfn,crit,evals,objfun,maxgrad,stop,stalled"<<endl;
+     osPhs.close();
+    }
+    
+    if (doTrace){//start per-evaluation trace
+     trace.open("TCSAM2015.trace.csv", ios::trunc);
+     trace<<"eval,phase,evalInPhase,objfun,maxgrad,time"<<endl;
+     trace.precision(12);
+     wtStart = tcsam::getWallTime();
+    }
+    
     //calculate average effort for fisheries over specified time periods
     cout<<"calculating average effort"<<endl;
     rpt::echo<<"calculating average effort"<<endl;
@@ -1095,6 +1912,9 @@ PRELIMINARY_CALCS_SECTION
     rpt::echo<<"avgEff = "<<avgEff<<endl;
     rpt::echo<<"finished calculating average effort"<<endl;
     cout<<"finished calculating average effort"<<endl;
+    
+    if (doOpModBatch) runOpModBatch(0,rpt::echo);//does not return
+    if (iHessWorker>0) calcHessianColumns(iHessWorker,nHessWorkers,rpt::echo);//does not return
 
     if (option_match(ad_comm::argc,ad_comm::argv,"-mceval")<0) {
         cout<<"testing calcRecruitment():"<<endl;
@@ -1206,6 +2026,7 @@ PRELIMINARY_CALCS_SECTION
         cout<<"MCEVAL is on"<<endl;
         rpt::echo<<"MCEVAL is on"<<endl;
     }
+    invalidateMemos();//parameter values may change before the first phase
     
     
 // =============================================================================
@@ -1225,15 +2046,15 @@ PROCEDURE_SECTION
 
     calcObjFun(dbg,rpt::echo);
     
-    if (sd_phase()){
-        sdrLnR_y = log(R_y);
-        for (int x=1;x<=nSXs;x++){
-            for (int y=mnYr+ptrMDS->ptrBio->recLag; y<=mxYr; y++){
-                sdrSpB_xy(x,y) = spB_yx(y,x);
-            }
-        }
+    if (!(sd_phase()||mceval_phase())){
+        if (nStallEvals) checkForStall(rpt::echo);
+        if (doTrace) trace<<ctrProcCalls<<cc<<current_phase()<<cc<<ctrProcCallsInPhase<<cc
+                          <<value(objFun)<<cc<<objective_function_value::gmax<<cc
+                          <<tcsam::getWallTime()-wtStart<<endl;
     }
     
+    if (sd_phase()) setSdrVariables();
+    
     if (mceval_phase()){
         updateMPI(0, cout);
         if (doOFL) calcOFL(mxYr,0,cout);//update ptrOFL
@@ -1391,6 +2212,7 @@ FUNCTION void writeMCMCtoR(ofstream& mcmc)
 //******************************************************************************
 FUNCTION void createSimData(int debug, ostream& cout, int iSimDataSeed, ModelDatasets* ptrSim)
     if (debug)cout<<"simulating model results as data"<<endl;
+    fillSurveys(0,cout);//calculate surveys in years without survey data
     d6_array vn_vyxmsz = wts::value(n_vyxmsz);
     d6_array vcN_fyxmsz = wts::value(cpN_fyxmsz);
     d6_array vrmN_fyxmsz = wts::value(rmN_fyxmsz);
@@ -1696,6 +2518,782 @@ FUNCTION void setAllDevs(int debug, ostream& cout)
     if (debug>=dbgAll) cout<<"finished setAllDevs()"<<endl;
 
 
+//******************************************************************************
+//* Function: void setWarmStartVals(adstring fn, int debug, ostream& cout)
+//* 
+//* Description: Sets initial values for all parameters using the final values
+//*     in a par file from a previous model run. Only overlapping elements are
+//*     set, so the previous run may have a different parameter structure 
+//*     (e.g., shorter devs vectors in a retrospective peel). Values are 
+//*     truncated to the parameter bounds.
+//* 
+//* Inputs:
+//*  fn (adstring) 
+//*     name of par file
+//* Returns:
+//*  void
+//* Alters:
+//*  all parameters found in the par file
+//******************************************************************************
+FUNCTION void setWarmStartVals(adstring fn, int debug, ostream& cout)
+    ParFileValues pfv;
+    if (!pfv.read(fn)) {
+        cout<<"Could not read par file '"<<fn<<"' for warm start. Using initial values."<<endl;
+        return;
+    }
+    cout<<"Warm-starting from par file '"<<fn<<"' (objFun = "<<pfv.objFun<<")"<<endl;
+    setParameterVals(pfv,0,debug,cout);
+
+//******************************************************************************
+//* Function: void setParameterVals(ParFileValues& pfv, int setFixed, int debug, ostream& cout)
+//* 
+//* Description: Sets parameter values using values from a ParFileValues object
+//*     (e.g., from a par file or a row of a ParameterVectorsTable). Parameters 
+//*     not found in the object are not altered.
+//*
+//* Required inputs:
+//*  pfv - ParFileValues object
+//*  setFixed - flag to also set values for fixed parameters (phase<0)
+//* Returns:
+//*  void
+//* Alters:
+//*  all parameters found in pfv
+//******************************************************************************
+FUNCTION void setParameterVals(ParFileValues& pfv, int setFixed, int debug, ostream& cout)
+    //recruitment parameters
+    setParameterVals(pfv,pLnR,    setFixed,debug,cout);
+    setParameterVals(pfv,pLnRCV,  setFixed,debug,cout);
+    setParameterVals(pfv,pLgtRX,  setFixed,debug,cout);
+    setParameterVals(pfv,pLnRa,   setFixed,debug,cout);
+    setParameterVals(pfv,pLnRb,   setFixed,debug,cout);
+    setParameterVals(pfv,pDevsLnR,setFixed,debug,cout);
+
+    //natural mortality parameters
+    setParameterVals(pfv,pLnM,   setFixed,debug,cout);
+    setParameterVals(pfv,pLnDMT, setFixed,debug,cout);
+    setParameterVals(pfv,pLnDMX, setFixed,debug,cout);
+    setParameterVals(pfv,pLnDMM, setFixed,debug,cout);
+    setParameterVals(pfv,pLnDMXM,setFixed,debug,cout);
+
+    //growth parameters
+    setParameterVals(pfv,pLnGrA,   setFixed,debug,cout);
+    setParameterVals(pfv,pLnGrB,   setFixed,debug,cout);
+    setParameterVals(pfv,pLnGrBeta,setFixed,debug,cout);
+
+    //maturity parameters
+    setParameterVals(pfv,pLgtPrMat,setFixed,debug,cout);
+
+    //selectivity parameters
+    setParameterVals(pfv,pS1,setFixed,debug,cout);
+    setParameterVals(pfv,pS2,setFixed,debug,cout);
+    setParameterVals(pfv,pS3,setFixed,debug,cout);
+    setParameterVals(pfv,pS4,setFixed,debug,cout);
+    setParameterVals(pfv,pS5,setFixed,debug,cout);
+    setParameterVals(pfv,pS6,setFixed,debug,cout);
+    setParameterVals(pfv,pDevsS1,setFixed,debug,cout);
+    setParameterVals(pfv,pDevsS2,setFixed,debug,cout);
+    setParameterVals(pfv,pDevsS3,setFixed,debug,cout);
+    setParameterVals(pfv,pDevsS4,setFixed,debug,cout);
+    setParameterVals(pfv,pDevsS5,setFixed,debug,cout);
+    setParameterVals(pfv,pDevsS6,setFixed,debug,cout);
+
+    //fully-selected fishing capture rate parameters
+    setParameterVals(pfv,pHM,     setFixed,debug,cout);
+    setParameterVals(pfv,pLnC,    setFixed,debug,cout);
+    setParameterVals(pfv,pLnDCT,  setFixed,debug,cout);
+    setParameterVals(pfv,pLnDCX,  setFixed,debug,cout);
+    setParameterVals(pfv,pLnDCM,  setFixed,debug,cout);
+    setParameterVals(pfv,pLnDCXM, setFixed,debug,cout);
+    setParameterVals(pfv,pDevsLnC,setFixed,debug,cout);
+
+    //survey catchability parameters
+    setParameterVals(pfv,pLnQ,   setFixed,debug,cout);
+    setParameterVals(pfv,pLnDQT, setFixed,debug,cout);
+    setParameterVals(pfv,pLnDQX, setFixed,debug,cout);
+    setParameterVals(pfv,pLnDQM, setFixed,debug,cout);
+    setParameterVals(pfv,pLnDQXM,setFixed,debug,cout);
+
+//-------------------------------------------------------------------------------------
+//set parameter number vector values from a ParFileValues object
+FUNCTION void setParameterVals(ParFileValues& pfv, param_init_bounded_number_vector& p, int setFixed, int debug, ostream& cout)
+    double v;
+    for (int i=p.indexmin();i<=p.indexmax();i++){
+        if ((setFixed||(p(i).get_phase_start()>0))&&pfv.getValue(p(i).label(),1,v)){//element labels are of form "name[i]"
+            p(i) = max(p(i).get_minb(),min(v,p(i).get_maxb()));
+            if (debug) cout<<"set "<<p(i).label()<<" = "<<p(i)<<endl;
+        }
+    }
+
+//-------------------------------------------------------------------------------------
+//set values for a vector of parameter vectors (overlapping elements only) from a ParFileValues object
+FUNCTION void setParameterVals(ParFileValues& pfv, param_init_bounded_vector_vector& p, int setFixed, int debug, ostream& cout)
+    for (int i=p.indexmin();i<=p.indexmax();i++){
+        adstring lbl = p(i).label();
+        if ((setFixed||(p(i).get_phase_start()>0))&&pfv.hasValues(lbl)){
+            dvector v = pfv.getValues(lbl);
+            int mn = p(i).indexmin();
+            int mx = min(p(i).indexmax(),mn+v.size()-1);
+            double lb = p(i).get_minb();
+            double ub = p(i).get_maxb();
+            for (int j=mn;j<=mx;j++) p(i,j) = max(lb,min(v(j-mn+1),ub));
+            if (debug) cout<<"set "<<lbl<<" = "<<p(i)<<endl;
+        }
+    }
+
+//******************************************************************************
+//* Function: void schedulePhase(int phase, int nEvalsPrv, ostream& cout)
+//* 
+//* Description: Adapts the function evaluations and convergence criterion 
+//*     for a phase before it starts (called from BETWEEN_PHASES_SECTION).
+//*         1. If the next phase turns on no new parameters, the phase is merged
+//*            into the next phase (its maximum function evaluations are set 
+//*            to 0), since the next phase minimizes over the same parameters
+//*            with a tighter convergence criterion. The last phase always runs.
+//*         2. If the previous phase stalled (used all its function evaluations
+//*            without reaching its convergence criterion, or was flagged by
+//*            checkForStall(...) with -stall), the criterion for an 
+//*            intermediate phase is loosened to that for the previous phase.
+//*
+//* Required inputs:
+//*  phase - phase that is about to start
+//*  nEvalsPrv - number of function evaluations in the previous phase
+//* Returns:
+//*  void
+//* Alters:
+//*  maximum_function_evaluations, convergence_criteria
+//******************************************************************************
+FUNCTION void schedulePhase(int phase, int nEvalsPrv, ostream& cout)
+    int nP = initial_params::max_number_phases;
+    //extend runtime vectors to one value per phase
+    if (maximum_function_evaluations.indexmax()<nP){
+        dvector tmp(1,nP);
+        int mx = maximum_function_evaluations.indexmax();
+        for (int k=1;k<=nP;k++) tmp(k) = maximum_function_evaluations(min(k,mx));
+        maximum_function_evaluations.deallocate();
+        maximum_function_evaluations.allocate(1,nP);
+        maximum_function_evaluations = tmp;
+    }
+    if (convergence_criteria.indexmax()<nP){
+        dvector tmp(1,nP);
+        int mx = convergence_criteria.indexmax();
+        for (int k=1;k<=nP;k++) tmp(k) = convergence_criteria(min(k,mx));
+        convergence_criteria.deallocate();
+        convergence_criteria.allocate(1,nP);
+        convergence_criteria = tmp;
+    }
+    
+    if ((phase<nP)&&(countParamsInPhase(phase+1,1)==0)){
+        maximum_function_evaluations(phase) = 0;
+        cout<<"#--smart phases: phase "<<phase<<" merged into phase "<<phase+1<<" (no new parameters)"<<endl;
+        std::cout<<"#--smart phases: phase "<<phase<<" merged into phase "<<phase+1<<" (no new parameters)"<<endl;
+        return;
+    }
+    if ((phase>1)&&(phase<nP)&&(maximum_function_evaluations(phase-1)>0)){
+        if (((nEvalsPrv>=maximum_function_evaluations(phase-1))&&
+             (objective_function_value::gmax>convergence_criteria(phase-1)))||(phsStalled==phase-1)){
+            convergence_criteria(phase) = max(convergence_criteria(phase),convergence_criteria(phase-1));
+            cout<<"#--smart phases: phase "<<phase-1<<" stalled. Convergence criterion for phase "<<phase<<" set to "<<convergence_criteria(phase)<<endl;
+        }
+    }
+    cout<<"#--smart phases: phase "<<phase<<" maxfn = "<<maximum_function_evaluations(phase)<<", crit = "<<convergence_criteria(phase)<<endl;
+
+//-------------------------------------------------------------------------------------
+//*     Tests for stalled progress in the current phase (-stall). The best
+//*     objective function value is tracked by evaluation in a ring buffer.
+//*     If the best value has improved by less than tolStall over the last
+//*     nStallEvals evaluations and the current evaluation is (within tolStall 
+//*     of) the best, the phase is flagged as stalled. The objective function
+//*     is not altered: the minimizer takes the phase's maxfn and convergence 
+//*     criterion when the phase starts, so the stall is acted on when the next
+//*     phase is scheduled (see schedulePhase(...)).
+FUNCTION void checkForStall(ostream& cout)
+    int k = current_phase();
+    int n = ctrProcCallsInPhase;
+    double f = value(objFun);
+    if (phsStalled==k) return;//already flagged
+    int m = nStallEvals+1;//size of ring buffer
+    int i = (n-1)%m;
+    if (n==1) bestObjFun(i) = f; else bestObjFun(i) = min(f,bestObjFun((n-2)%m));
+    if ((n>nStallEvals)&&(f<=bestObjFun(i)+tolStall)){
+        double fOld = bestObjFun(n%m);//best value nStallEvals evaluations ago
+        if (fOld-bestObjFun(i)<tolStall){
+            phsStalled    = k;
+            nEvalsStalled = n;
+            cout<<"#--stalled: phase "<<k<<" stalled at evaluation "<<n<<" (objective function improved by "
+                <<fOld-bestObjFun(i)<<" over the last "<<nStallEvals<<" evaluations)"<<endl;
+            std::cout<<"#--stalled: phase "<<k<<" stalled at evaluation "<<n<<" (objective function improved by "
+                <<fOld-bestObjFun(i)<<" over the last "<<nStallEvals<<" evaluations)"<<endl;
+        }
+    }
+
+//-------------------------------------------------------------------------------------
+//count parameters active in a phase (newOnly=0) or turned on in the phase (newOnly=1)
+FUNCTION int countParamsInPhase(int phase, int newOnly)
+    int n = 0;
+    //recruitment parameters
+    n += countParamsInPhase(phsLnR,  phase,newOnly);
+    n += countParamsInPhase(phsLnRCV,phase,newOnly);
+    n += countParamsInPhase(phsLgtRX,phase,newOnly);
+    n += countParamsInPhase(phsLnRa, phase,newOnly);
+    n += countParamsInPhase(phsLnRb, phase,newOnly);
+    n += countParamsInPhase(phsDevsLnR,mniDevsLnR,mxiDevsLnR,phase,newOnly);
+    //natural mortality parameters
+    n += countParamsInPhase(phsLnM,   phase,newOnly);
+    n += countParamsInPhase(phsLnDMT, phase,newOnly);
+    n += countParamsInPhase(phsLnDMX, phase,newOnly);
+    n += countParamsInPhase(phsLnDMM, phase,newOnly);
+    n += countParamsInPhase(phsLnDMXM,phase,newOnly);
+    //growth parameters
+    n += countParamsInPhase(phsLnGrA,   phase,newOnly);
+    n += countParamsInPhase(phsLnGrB,   phase,newOnly);
+    n += countParamsInPhase(phsLnGrBeta,phase,newOnly);
+    //maturity parameters
+    n += countParamsInPhase(phsLgtPrMat,mniLgtPrMat,mxiLgtPrMat,phase,newOnly);
+    //selectivity parameters
+    n += countParamsInPhase(phsS1,phase,newOnly);
+    n += countParamsInPhase(phsS2,phase,newOnly);
+    n += countParamsInPhase(phsS3,phase,newOnly);
+    n += countParamsInPhase(phsS4,phase,newOnly);
+    n += countParamsInPhase(phsS5,phase,newOnly);
+    n += countParamsInPhase(phsS6,phase,newOnly);
+    n += countParamsInPhase(phsDevsS1,mniDevsS1,mxiDevsS1,phase,newOnly);
+    n += countParamsInPhase(phsDevsS2,mniDevsS2,mxiDevsS2,phase,newOnly);
+    n += countParamsInPhase(phsDevsS3,mniDevsS3,mxiDevsS3,phase,newOnly);
+    n += countParamsInPhase(phsDevsS4,mniDevsS4,mxiDevsS4,phase,newOnly);
+    n += countParamsInPhase(phsDevsS5,mniDevsS5,mxiDevsS5,phase,newOnly);
+    n += countParamsInPhase(phsDevsS6,mniDevsS6,mxiDevsS6,phase,newOnly);
+    //fishery capture rate parameters
+    n += countParamsInPhase(phsHM,    phase,newOnly);
+    n += countParamsInPhase(phsLnC,   phase,newOnly);
+    n += countParamsInPhase(phsLnDCT, phase,newOnly);
+    n += countParamsInPhase(phsLnDCX, phase,newOnly);
+    n += countParamsInPhase(phsLnDCM, phase,newOnly);
+    n += countParamsInPhase(phsLnDCXM,phase,newOnly);
+    n += countParamsInPhase(phsDevsLnC,mniDevsLnC,mxiDevsLnC,phase,newOnly);
+    //survey catchability parameters
+    n += countParamsInPhase(phsLnQ,   phase,newOnly);
+    n += countParamsInPhase(phsLnDQT, phase,newOnly);
+    n += countParamsInPhase(phsLnDQX, phase,newOnly);
+    n += countParamsInPhase(phsLnDQM, phase,newOnly);
+    n += countParamsInPhase(phsLnDQXM,phase,newOnly);
+    return n;
+
+//-------------------------------------------------------------------------------------
+//count elements of a parameter number vector active in (or turned on in) a phase
+FUNCTION int countParamsInPhase(ivector& phs, int phase, int newOnly)
+    int n = 0;
+    for (int i=phs.indexmin();i<=phs.indexmax();i++){
+        if ((phs(i)>0)&&((newOnly&&(phs(i)==phase))||((!newOnly)&&(phs(i)<=phase)))) n++;
+    }
+    return n;
+
+//-------------------------------------------------------------------------------------
+//count elements of a vector of parameter vectors active in (or turned on in) a phase
+FUNCTION int countParamsInPhase(ivector& phs, ivector& mns, ivector& mxs, int phase, int newOnly)
+    int n = 0;
+    for (int i=phs.indexmin();i<=phs.indexmax();i++){
+        if ((phs(i)>0)&&((newOnly&&(phs(i)==phase))||((!newOnly)&&(phs(i)<=phase)))) n += mxs(i)-mns(i)+1;
+    }
+    return n;
+
+//-------------------------------------------------------------------------------------
+//get name of warm start cache file for a phase
+FUNCTION adstring getWarmStartCacheFile(int phase)
+    return wts::concatenateFilePaths(dirWarmStart,"TCSAM2015.phase."+itoa(phase,10)+"."+sigParams+".par");
+
+//******************************************************************************
+//* Function: void writeParameterVals(ostream& os)
+//* 
+//* Description: Writes all parameter values to an output stream in ADMB par 
+//*     file format, so they can be read using a ParFileValues object.
+//*
+//* Required inputs:
+//*  os - output stream
+//* Returns:
+//*  void
+//* Alters:
+//*  nothing
+//******************************************************************************
+FUNCTION void writeParameterVals(ostream& os)
+    os<<"# Number of parameters = "<<initial_params::nvarcalc()<<"  Objective function value = "<<value(objFun)
+      <<"  Maximum gradient component = "<<objective_function_value::gmax<<endl;
+    //recruitment parameters
+    writeParameterVals(os,pLnR);
+    writeParameterVals(os,pLnRCV);
+    writeParameterVals(os,pLgtRX);
+    writeParameterVals(os,pLnRa);
+    writeParameterVals(os,pLnRb);
+    writeParameterVals(os,pDevsLnR);
+
+    //natural mortality parameters
+    writeParameterVals(os,pLnM);
+    writeParameterVals(os,pLnDMT);
+    writeParameterVals(os,pLnDMX);
+    writeParameterVals(os,pLnDMM);
+    writeParameterVals(os,pLnDMXM);
+
+    //growth parameters
+    writeParameterVals(os,pLnGrA);
+    writeParameterVals(os,pLnGrB);
+    writeParameterVals(os,pLnGrBeta);
+
+    //maturity parameters
+    writeParameterVals(os,pLgtPrMat);
+
+    //selectivity parameters
+    writeParameterVals(os,pS1);
+    writeParameterVals(os,pS2);
+    writeParameterVals(os,pS3);
+    writeParameterVals(os,pS4);
+    writeParameterVals(os,pS5);
+    writeParameterVals(os,pS6);
+    writeParameterVals(os,pDevsS1);
+    writeParameterVals(os,pDevsS2);
+    writeParameterVals(os,pDevsS3);
+    writeParameterVals(os,pDevsS4);
+    writeParameterVals(os,pDevsS5);
+    writeParameterVals(os,pDevsS6);
+
+    //fully-selected fishing capture rate parameters
+    writeParameterVals(os,pHM);
+    writeParameterVals(os,pLnC);
+    writeParameterVals(os,pLnDCT);
+    writeParameterVals(os,pLnDCX);
+    writeParameterVals(os,pLnDCM);
+    writeParameterVals(os,pLnDCXM);
+    writeParameterVals(os,pDevsLnC);
+
+    //survey catchability parameters
+    writeParameterVals(os,pLnQ);
+    writeParameterVals(os,pLnDQT);
+    writeParameterVals(os,pLnDQX);
+    writeParameterVals(os,pLnDQM);
+    writeParameterVals(os,pLnDQXM);
+
+//-------------------------------------------------------------------------------------
+//write parameter number vector values in par file format
+FUNCTION void writeParameterVals(ostream& os, param_init_bounded_number_vector& p)
+    for (int i=p.indexmin();i<=p.indexmax();i++) os<<"# "<<p(i).label()<<":"<<endl<<value(p(i))<<endl;
+
+//-------------------------------------------------------------------------------------
+//write vector of parameter vectors values in par file format
+FUNCTION void writeParameterVals(ostream& os, param_init_bounded_vector_vector& p)
+    for (int i=p.indexmin();i<=p.indexmax();i++) os<<"# "<<p(i).label()<<":"<<endl<<value(p(i))<<endl;
+
+//******************************************************************************
+//* Function: void calcHessianColumns(int w, int nW, ostream& cout)
+//* 
+//* Description: Calculates a block of columns of the Hessian of the objective 
+//*     function with respect to all parameters active in the last phase (on 
+//*     ADMB's unbounded scale) by central differences of the gradient. The step
+//*     for parameter i is 1e-5*max(1,|x_i|). All model parameters are currently 
+//*     bounded, so on ADMB's unbounded scale they lie in [-1,1] (and the step is
+//*     1e-5); steps past a bound fold back through the sine transformation, so a 
+//*     one-sided difference towards the interior is used for parameters within a
+//*     step of a bound. Note that this is NOT ADMB's scheme (hess_routine uses
+//*     step halving with Richardson extrapolation), so small differences from 
+//*     ADMB's Hessian are expected. Worker w of nW calculates columns 
+//*     1+(w-1)*nvar/nW to w*nvar/nW and writes them (preceded by the column
+//*     index) to TCSAM2015.hessian.cols.bin. The worker also calculates the
+//*     gradients of its block of the sdreport variables (see getSdrVariable(...))
+//*     and writes them (preceded by the variable index) to TCSAM2015.hessian.deps.bin.
+//*     The number of parameters, their values, the scale factors used to 
+//*     transform standard deviations to the bounded scale, and the number, 
+//*     values and labels of the sdreport variables, and the parameter groups that
+//*     determine the envelope of the Hessian (see getHessianGroups()) are written to 
+//*     TCSAM2015.hessian.info.dat.
+//*
+//* Required inputs:
+//*  w - worker index
+//*  nW - number of workers
+//* Returns:
+//*  does not return (exits the program)
+//* Alters:
+//*  all active parameters, all model quantities
+//******************************************************************************
+FUNCTION void calcHessianColumns(int w, int nW, ostream& cout)
+    initial_params::current_phase = initial_params::max_number_phases;
+    int nvar = initial_params::nvarcalc();
+    dvector x(1,nvar);
+    initial_params::xinit(x);//active parameters on unbounded scale
+    dvector scl(1,nvar);
+    initial_params::stddev_scale(scl,x);
+    int nDep = getNumSdrVariables();
+    if (nDep!=stddev_params::num_stddev_calc()){
+        cout<<"Error in calcHessianColumns(...): getSdrVariable(...) covers "<<nDep<<" sdreport values,"<<endl;
+        cout<<"but the model has "<<stddev_params::num_stddev_calc()<<"."<<endl;
+        cout<<"Add new sdreport variables to getNumSdrVariables() and getSdrVariable(...)."<<endl;
+        cout<<"Aborting..."<<endl;
+        exit(-1);
+    }
+    {ofstream osInfo("TCSAM2015.hessian.info.dat", ios::trunc);
+     osInfo.precision(17);
+     adstring_array lblsDep(1,nDep);
+     gradient_structure::set_NO_DERIVATIVES();
+     initial_params::reset(dvar_vector(x));
+     userfunction();
+     setSdrVariables();
+     ivector grp = getHessianGroups();
+     if (grp.size()!=nvar){
+         cout<<"Warning in calcHessianColumns(...): getHessianGroups() found "<<grp.size()<<" active parameters,"<<endl;
+         cout<<"but ADMB has "<<nvar<<". Using a full envelope."<<endl;
+         grp.deallocate(); grp.allocate(1,nvar); grp.initialize();
+     }
+     osInfo<<nvar<<endl<<x<<endl<<scl<<endl<<grp<<endl<<nDep<<endl;
+     for (int k=1;k<=nDep;k++) osInfo<<value(getSdrVariable(k,lblsDep(k)))<<" "; osInfo<<endl;
+     for (int k=1;k<=nDep;k++) osInfo<<lblsDep(k)<<endl;
+     osInfo.close();
+    }
+    int i1 = 1+((w-1)*nvar)/nW;
+    int i2 = (w*nvar)/nW;
+    cout<<"#Calculating Hessian columns "<<i1<<":"<<i2<<" of "<<nvar<<endl;
+    std::cout<<"#Calculating Hessian columns "<<i1<<":"<<i2<<" of "<<nvar<<endl;
+    double delta = 1.0e-5;//relative step size
+    dvector g0(1,nvar);//gradient at x (only calculated if needed for one-sided differences)
+    int hasG0 = 0;
+    dvector g1(1,nvar);
+    dvector g2(1,nvar);
+    dvector row(0,nvar);
+    ofstream os("TCSAM2015.hessian.cols.bin", ios::binary|ios::trunc);
+    for (int i=i1;i<=i2;i++){
+        double xs = x(i);
+        double h = delta*((fabs(xs)>1.0) ? fabs(xs) : 1.0);
+        row(0) = i;
+        if ((xs+h>1.0)||(xs-h<-1.0)){
+            //within a step of a bound: one-sided difference towards the interior
+            if (!hasG0) {calcGradient(x,g0); hasG0 = 1;}
+            if (xs+h>1.0) h = -h;
+            x(i) = xs+h; calcGradient(x,g1);
+            x(i) = xs;
+            for (int j=1;j<=nvar;j++) row(j) = (g1(j)-g0(j))/h;
+            cout<<"#--Using a one-sided difference for parameter "<<i<<" (x = "<<xs<<")"<<endl;
+        } else {
+            x(i) = xs+h; calcGradient(x,g1);
+            x(i) = xs-h; calcGradient(x,g2);
+            x(i) = xs;
+            for (int j=1;j<=nvar;j++) row(j) = (g1(j)-g2(j))/(2.0*h);
+        }
+        tcsam::writeBinaryRow(os,row);
+    }
+    os.close();
+    
+    int k1 = 1+((w-1)*nDep)/nW;
+    int k2 = (w*nDep)/nW;
+    ofstream osDeps("TCSAM2015.hessian.deps.bin", ios::binary|ios::trunc);
+    for (int k=k1;k<=k2;k++){
+        calcSdrGradient(x,k,g1);
+        row(0) = k;
+        for (int j=1;j<=nvar;j++) row(j) = g1(j);
+        tcsam::writeBinaryRow(osDeps,row);
+    }
+    osDeps.close();
+    exit(0);
+
+//******************************************************************************
+//* Function: ivector getHessianGroups()
+//* 
+//* Description: Gets the group of each parameter active in the last phase (in
+//*     ADMB's order, as in writeParameters(...)) for the envelope of the Hessian
+//*     used by -parHess. The group is v>0 if the parameter only affects the 
+//*     predictions for survey v (the survey's catchability parameters and the
+//*     parameters of selectivity functions used only by that survey), and 0 
+//*     otherwise (it affects the population dynamics or more than one survey).
+//*     The survey likelihoods and parameter priors are separate terms of the
+//*     objective function, so Hessian elements between parameters in different 
+//*     groups v>0 are structurally zero.
+//*
+//*     Must be called after calcSurveyQs(...) (uses idSelSrv_c).
+//*
+//* Required inputs:
+//*  none
+//* Returns:
+//*  ivector of groups (indices 1:number of active parameters)
+//* Alters:
+//*  nothing
+//******************************************************************************
+FUNCTION ivector getHessianGroups()
+    //survey using each selectivity function (0: used by a fishery or more than one survey)
+    SelectivityInfo* ptrSel = ptrMPI->ptrSel;
+    ivector srvSel_c(1,ptrSel->nPCs); srvSel_c = -1;//-1: not used
+    FisheriesInfo* ptrFsh = ptrMPI->ptrFsh;
+    for (int pc=1;pc<=ptrFsh->nPCs;pc++){
+        ivector& pids = ptrFsh->getPCIDs(pc);
+        int k = ptrFsh->nIVs+ptrFsh->nPVs+1;//1st extra variable column
+        if (pids[k])   srvSel_c(pids[k])   = 0;//selectivity function
+        if (pids[k+1]) srvSel_c(pids[k+1]) = 0;//retention function
+    }
+    SurveysInfo* ptrSrv = ptrMPI->ptrSrv;
+    ivector srv_c(1,ptrSrv->nPCs); srv_c = -1;//survey by survey parameter combination
+    for (int pc=1;pc<=ptrSrv->nPCs;pc++){
+        for (int idx=ptrSrv->planFirst(pc);idx<=ptrSrv->planLast(pc);idx++) srv_c(pc) = joinHessianGroups(srv_c(pc),ptrSrv->planIdxs(idx,1));
+        if (idSelSrv_c(pc)) srvSel_c(idSelSrv_c(pc)) = joinHessianGroups(srvSel_c(idSelSrv_c(pc)),srv_c(pc));
+    }
+    //groups of the survey catchability parameters (columns as in calcSurveyQs(...))
+    ivector gLnQ(1,npLnQ);         gLnQ    = -1;
+    ivector gLnDQT(1,npLnDQT);     gLnDQT  = -1;
+    ivector gLnDQX(1,npLnDQX);     gLnDQX  = -1;
+    ivector gLnDQM(1,npLnDQM);     gLnDQM  = -1;
+    ivector gLnDQXM(1,npLnDQXM);   gLnDQXM = -1;
+    for (int pc=1;pc<=ptrSrv->nPCs;pc++){
+        ivector& pids = ptrSrv->getPCIDs(pc);
+        int k=ptrSrv->nIVs+1;//1st parameter variable column
+        if (pids[k]) gLnQ(pids[k])   = joinHessianGroups(gLnQ(pids[k]),  srv_c(pc)); k++;
+        if (pids[k]) gLnDQT(pids[k]) = joinHessianGroups(gLnDQT(pids[k]),srv_c(pc)); k++;
+        if (FEMALE<=nSXs){
+            if (pids[k]) gLnDQX(pids[k])  = joinHessianGroups(gLnDQX(pids[k]), srv_c(pc)); k++;
+            if (pids[k]) gLnDQM(pids[k])  = joinHessianGroups(gLnDQM(pids[k]), srv_c(pc)); k++;
+            if (pids[k]) gLnDQXM(pids[k]) = joinHessianGroups(gLnDQXM(pids[k]),srv_c(pc)); k++;
+        }
+    }
+    //groups of the selectivity parameters (columns as in calcSelectivities(...))
+    int mxS = 1;
+    mxS = max(mxS,max(npS1,npS2)); mxS = max(mxS,max(npS3,npS4)); mxS = max(mxS,max(npS5,npS6));
+    mxS = max(mxS,max(npDevsS1,npDevsS2)); mxS = max(mxS,max(npDevsS3,npDevsS4)); mxS = max(mxS,max(npDevsS5,npDevsS6));
+    imatrix gS(1,12,1,mxS);//rows 1-6: pS1-pS6, rows 7-12: pDevsS1-pDevsS6
+    for (int r=1;r<=12;r++) gS(r) = -1;
+    for (int pc=1;pc<=ptrSel->nPCs;pc++){
+        ivector& pids = ptrSel->getPCIDs(pc);
+        for (int r=1;r<=12;r++){
+            int id = pids[ptrSel->nIVs+r];
+            if (id) gS(r,id) = joinHessianGroups(gS(r,id),srvSel_c(pc));
+        }
+    }
+    //assemble in ADMB's order (as in writeParameters(...))
+    ivector grp(1,countParamsInPhase(initial_params::max_number_phases,0));
+    grp.initialize();
+    int n = 0;
+    n += countParamsInPhase(phsLnR,  initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnRCV,initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLgtRX,initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnRa, initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnRb, initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsDevsLnR,mniDevsLnR,mxiDevsLnR,initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnM,   initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnDMT, initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnDMX, initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnDMM, initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnDMXM,initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnGrA,   initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnGrB,   initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnGrBeta,initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLgtPrMat,mniLgtPrMat,mxiLgtPrMat,initial_params::max_number_phases,0);
+    setHessianGroups(grp,n,phsS1,gS(1));
+    setHessianGroups(grp,n,phsS2,gS(2));
+    setHessianGroups(grp,n,phsS3,gS(3));
+    setHessianGroups(grp,n,phsS4,gS(4));
+    setHessianGroups(grp,n,phsS5,gS(5));
+    setHessianGroups(grp,n,phsS6,gS(6));
+    setHessianGroups(grp,n,phsDevsS1,mniDevsS1,mxiDevsS1,gS(7));
+    setHessianGroups(grp,n,phsDevsS2,mniDevsS2,mxiDevsS2,gS(8));
+    setHessianGroups(grp,n,phsDevsS3,mniDevsS3,mxiDevsS3,gS(9));
+    setHessianGroups(grp,n,phsDevsS4,mniDevsS4,mxiDevsS4,gS(10));
+    setHessianGroups(grp,n,phsDevsS5,mniDevsS5,mxiDevsS5,gS(11));
+    setHessianGroups(grp,n,phsDevsS6,mniDevsS6,mxiDevsS6,gS(12));
+    n += countParamsInPhase(phsHM,    initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnC,   initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnDCT, initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnDCX, initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnDCM, initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsLnDCXM,initial_params::max_number_phases,0);
+    n += countParamsInPhase(phsDevsLnC,mniDevsLnC,mxiDevsLnC,initial_params::max_number_phases,0);
+    setHessianGroups(grp,n,phsLnQ,   gLnQ);
+    setHessianGroups(grp,n,phsLnDQT, gLnDQT);
+    setHessianGroups(grp,n,phsLnDQX, gLnDQX);
+    setHessianGroups(grp,n,phsLnDQM, gLnDQM);
+    setHessianGroups(grp,n,phsLnDQXM,gLnDQXM);
+    return grp;
+
+//-------------------------------------------------------------------------------------
+//join Hessian group h into group g (<0: no group yet, 0: population, v>0: survey v)
+FUNCTION int joinHessianGroups(int g, int h)
+    if (h<0) return g;
+    if (g<0) return h;
+    return (g==h) ? g : 0;
+
+//-------------------------------------------------------------------------------------
+//set the Hessian groups of the active elements of a parameter number vector (groups g, by element)
+FUNCTION void setHessianGroups(ivector& grp, int& n, ivector& phs, const ivector& g)
+    for (int i=phs.indexmin();i<=phs.indexmax();i++){
+        if (phs(i)>0) {n++; grp(n) = (g(i)>0) ? g(i) : 0;}
+    }
+
+//-------------------------------------------------------------------------------------
+//set the Hessian groups of the active elements of a vector of parameter vectors (groups g, by vector)
+FUNCTION void setHessianGroups(ivector& grp, int& n, ivector& phs, ivector& mns, ivector& mxs, const ivector& g)
+    for (int i=phs.indexmin();i<=phs.indexmax();i++){
+        if (phs(i)>0) {for (int j=mns(i);j<=mxs(i);j++) {n++; grp(n) = (g(i)>0) ? g(i) : 0;}}
+    }
+
+//-------------------------------------------------------------------------------------
+//calculate the gradient of the objective function at active parameter values x (unbounded scale)
+FUNCTION void calcGradient(dvector& x, dvector& g)
+    int nvar = x.indexmax();
+    gradient_structure::set_YES_DERIVATIVES();
+    dvariable vf = 0.0;
+    vf = initial_params::reset(dvar_vector(x));
+    *objective_function_value::pobjfun = 0.0;
+    userfunction();
+    vf += *objective_function_value::pobjfun;
+    gradcalc(nvar,g);
+
+//-------------------------------------------------------------------------------------
+//calculate the gradient of sdreport variable k at active parameter values x (unbounded scale)
+FUNCTION void calcSdrGradient(dvector& x, int k, dvector& g)
+    int nvar = x.indexmax();
+    adstring lbl;
+    gradient_structure::set_YES_DERIVATIVES();
+    initial_params::reset(dvar_vector(x));
+    userfunction();
+    setSdrVariables();
+    dvariable vf = 0.0;
+    vf = getSdrVariable(k,lbl);
+    gradcalc(nvar,g);
+
+//-------------------------------------------------------------------------------------
+//set the values of the sdreport variables (in the sd phase and for -parHess)
+FUNCTION void setSdrVariables()
+    sdrLnR_y = log(R_y);
+    for (int x=1;x<=nSXs;x++){
+        for (int y=mnYr+ptrMDS->ptrBio->recLag; y<=mxYr; y++){
+            sdrSpB_xy(x,y) = spB_yx(y,x);
+        }
+    }
+
+//-------------------------------------------------------------------------------------
+//get the number of sdreport values covered by getSdrVariable(...)
+FUNCTION int getNumSdrVariables()
+    int n = sdrLnR_y.size();
+    for (int x=sdrSpB_xy.rowmin();x<=sdrSpB_xy.rowmax();x++) n += sdrSpB_xy(x).size();
+    return n;
+
+//-------------------------------------------------------------------------------------
+//get sdreport value k (and its label) from the sdreport variables, as set by setSdrVariables().
+//Add new sdreport variables here and in getNumSdrVariables() to include them in -parHess
+//results (calcHessianColumns(...) checks the total against ADMB's count).
+FUNCTION dvariable getSdrVariable(int k, adstring& lbl)
+    int n = sdrLnR_y.size();
+    if (k<=n){
+        int y = sdrLnR_y.indexmin()+k-1;
+        lbl = "sdrLnR_y("+str(y)+")";
+        return sdrLnR_y(y);
+    }
+    k -= n;
+    for (int x=sdrSpB_xy.rowmin();x<=sdrSpB_xy.rowmax();x++){
+        n = sdrSpB_xy(x).size();
+        if (k<=n){
+            int y = sdrSpB_xy(x).indexmin()+k-1;
+            lbl = "sdrSpB_xy("+tcsam::getSexType(x)+","+str(y)+")";
+            return sdrSpB_xy(x,y);
+        }
+        k -= n;
+    }
+    cout<<"Error in getSdrVariable(...): sdreport value index out of range."<<endl;
+    cout<<"Aborting..."<<endl;
+    exit(-1);
+    return 0.0;
+
+//******************************************************************************
+//* Function: void runOpModBatch(int debug, ostream& cout)
+//* 
+//* Description: Runs the population model (value-only, no fitting) for each 
+//*     parameter vector in the table given by fnOpModBatch. Contiguous blocks 
+//*     of vectors are run concurrently in nOpModWorkers forked worker processes,
+//*     so nothing is re-parsed between vectors. Each output row contains:
+//*         row index
+//*         mature biomass at mating time, by year and sex
+//*         total recruitment, by year
+//*         retained catch biomass, by fishery and year
+//*         discard catch mortality biomass, by fishery and year
+//*         OFL (if doOFL)
+//*     Rows are written to the binary table TCSAM2015.opModBatch.bin (see 
+//*     tcsam::mergeBinaryTables(...)) and the columns are described in 
+//*     TCSAM2015.opModBatch.cols.csv. Parameters not in the table keep their 
+//*     initial values.
+//*
+//* Required inputs:
+//*  none
+//* Returns:
+//*  does not return (exits the program)
+//* Alters:
+//*  all parameters in the table, all population model quantities
+//******************************************************************************
+FUNCTION void runOpModBatch(int debug, ostream& cout)
+    adstring fnBin = "TCSAM2015.opModBatch.bin";
+    ParameterVectorsTable pvt;
+    if (!pvt.read(fnOpModBatch)) exit(-1);
+    int nRows = pvt.nRows;
+    int nYrs  = mxYr-mnYr+1;
+    int nCols = 1+nYrs*nSXs+nYrs+2*nFsh*nYrs+doOFL;
+    int nW = min(nOpModWorkers,nRows);
+    std::cout<<"#Running operating model for "<<nRows<<" parameter vectors using "<<nW<<" workers"<<endl;
+    cout<<"#Running operating model for "<<nRows<<" parameter vectors using "<<nW<<" workers"<<endl;
+    
+    int w = 0;
+    ivector status_w;//exit status by worker
+    int res = tcsam::runWorkers(1,nW,nW,"operating model worker",w,status_w);
+    if (res>0){
+        //worker: run rows r1:r2 without derivative information
+        int r1 = 1+((w-1)*nRows)/nW;
+        int r2 = (w*nRows)/nW;
+        gradient_structure::set_NO_DERIVATIVES();
+        ofstream os((char*) (fnBin+"."+itoa(w,10)), ios::binary|ios::trunc);
+        ParFileValues pfv;
+        dvector row(1,nCols);
+        for (int r=r1;r<=r2;r++){
+            pvt.getRow(r,pfv);
+            setParameterVals(pfv,1,debug,cout);
+            invalidateMemos();//inactive parameter values have changed
+            runPopDyMod(0,cout);
+            if (doOFL) calcOFL(mxYr,0,cout);//updates ptrOFL
+            int c = 1;
+            row(c++) = r;
+            for (int y=mnYr;y<=mxYr;y++) {for (int x=1;x<=nSXs;x++) row(c++) = value(spB_yx(y,x));}
+            for (int y=mnYr;y<=mxYr;y++) row(c++) = value(R_y(y));
+            for (int f=1;f<=nFsh;f++){
+                for (int y=mnYr;y<=mxYr;y++){
+                    double rmB = 0.0; double dmB = 0.0;
+                    for (int x=1;x<=nSXs;x++){
+                        for (int m=1;m<=nMSs;m++){
+                            for (int s=1;s<=nSCs;s++){
+                                rmB += value(rmN_fyxmsz(f,y,x,m,s))*ptrMDS->ptrBio->wAtZ_xmz(x,m);//dot product
+                                dmB += value(dmN_fyxmsz(f,y,x,m,s))*ptrMDS->ptrBio->wAtZ_xmz(x,m);//dot product
+                            }
+                        }
+                    }
+                    row(c)           = rmB;
+                    row(c+nFsh*nYrs) = dmB;
+                    c++;
+                }
+            }
+            c += nFsh*nYrs;
+            if (doOFL) row(c++) = ptrOFL->OFL;
+            tcsam::writeBinaryRow(os,row);
+        }
+        os.close();
+        exit(0);
+    }
+    
+    //driver: all workers have finished. Merge results and quit
+    if (res<0){
+        cout<<"Error: one or more operating model workers failed. Results were not merged."<<endl;
+        std::cout<<"Error: one or more operating model workers failed. Results were not merged."<<endl;
+        exit(-1);
+    }
+    if (!tcsam::mergeBinaryTables(fnBin,nW,nRows,nCols)) exit(-1);
+    ofstream osCols("TCSAM2015.opModBatch.cols.csv", ios::trunc);
+    osCols<<"column,type,fishery,year,sex"<<endl;
+    int c = 1;
+    osCols<<c++<<cc<<"row"<<cc<<"NA"<<cc<<"NA"<<cc<<"NA"<<endl;
+    for (int y=mnYr;y<=mxYr;y++) {for (int x=1;x<=nSXs;x++) osCols<<c++<<cc<<"MB"<<cc<<"NA"<<cc<<y<<cc<<tcsam::getSexType(x)<<endl;}
+    for (int y=mnYr;y<=mxYr;y++) osCols<<c++<<cc<<"R"<<cc<<"NA"<<cc<<y<<cc<<"NA"<<endl;
+    for (int f=1;f<=nFsh;f++) {for (int y=mnYr;y<=mxYr;y++) osCols<<c++<<cc<<"retained.biomass"<<cc<<ptrMC->lblsFsh[f]<<cc<<y<<cc<<"NA"<<endl;}
+    for (int f=1;f<=nFsh;f++) {for (int y=mnYr;y<=mxYr;y++) osCols<<c++<<cc<<"discard.mortality.biomass"<<cc<<ptrMC->lblsFsh[f]<<cc<<y<<cc<<"NA"<<endl;}
+    if (doOFL) osCols<<c++<<cc<<"OFL"<<cc<<"NA"<<cc<<"NA"<<cc<<"NA"<<endl;
+    osCols.close();
+    std::cout<<"#Finished batch operating model runs. Results written to "<<fnBin<<endl;
+    cout<<"#Finished batch operating model runs. Results written to "<<fnBin<<endl;
+    tcsam::exitDriver(iTask,res);//does not return
+
 //-------------------------------------------------------------------------------------
 //calculate equilibrium size distribution for unmfexploited population
 FUNCTION void calcEqNatZF100(dvariable& R, int yr, int debug, ostream& cout)
@@ -1708,14 +3306,19 @@ FUNCTION void calcEqNatZF100(dvariable& R, int yr, int debug, ostream& cout)
         T_szz.initialize();  //growth matrices (indep. of molt to maturity)
         S2_msz.initialize(); //survival after molting/mating
         R_z.initialize();    //recruitment size distribution
-        R_z = R*R_yx(yr,x)*R_yz(yr);//initial mean recruitment by size
+        if (pcRec_y(yr)) R_z = R*R_yx(yr,x)*R_cz(pcRec_y(yr));//initial mean recruitment by size (0 if no recruitment pc)
+        for (int m=1;m<=nMSs;m++){ 
+            dvar_vector M_z = getM_z(yr,x,m);
+            dvar_vector S1_z = mfexp(-M_z*dtM_y(yr));      //survival until molting/growth/mating
+            dvar_vector S2_z = mfexp(-M_z*(1.0-dtM_y(yr)));//survival after molting/growth/mating
+            for (int s=1;s<=nSCs;s++){
+                S1_msz(m,s) = S1_z;
+                S2_msz(m,s) = S2_z;
+            }//s
+        }//m
         for (int s=1;s<=nSCs;s++){
             Th_sz(s) = prMat_yxz(yr,x); //pr(molt to maturity|pre-molt size, molt)
             for (int z=1;z<=nZBs;z++) T_szz(s,z) = prGr_yxszz(yr,x,s,z);//growth matrices
-            for (int m=1;m<=nMSs;m++){ 
-                S1_msz(m,s) = mfexp(-M_yxmsz(yr,x,m,s)*dtM_y(yr));      //survival until molting/growth/mating
-                S2_msz(m,s) = mfexp(-M_yxmsz(yr,x,m,s)*(1.0-dtM_y(yr)));//survival after molting/growth/mating
-            }//m
         }//s
         n_xmsz(x) = calcEqNatZ(R_z, S1_msz, Th_sz, T_szz, S2_msz, debug, cout);
     }
@@ -1798,21 +3401,56 @@ FUNCTION void calcOFL(int yr, int debug, ostream& cout)
     //NOW set yr back one year to get population rates, etc.
     yr = yr - 1;
     
+    //0. Create the OFL calculator and the objects it uses on the first call only.
+    //   The PopDyInfo and CatchInfo objects are shared by the Tier3_Calculator
+    //   and the PopProjectors, so they are simply refilled on each call below.
+    if (!ptrOFLCalc){
+        PopDyInfo* pPIM = new PopDyInfo(nZBs);//  males info
+        PopDyInfo* pPIF = new PopDyInfo(nZBs);//females info
+        CatchInfo* pCIM = new CatchInfo(nZBs,nFsh);//  male catch info
+        CatchInfo* pCIF = new CatchInfo(nZBs,nFsh);//female catch info
+        
+        Tier3_Calculator* pT3C = new Tier3_Calculator(nZBs,nFsh);
+        pT3C->pPI = pPIM;//male pop dy info
+        pT3C->pCI = pCIM;//male catch info
+        
+        //population projector for males
+        PopProjector* pPPM = new PopProjector(nZBs,nFsh);
+        pPPM->pPI = pPIM;//male pop dy info
+        pPPM->pCI = pCIM;//male catch info
+        
+        //population projector for females
+        PopProjector* pPPF = new PopProjector(nZBs,nFsh);
+        pPPF->pPI = pPIF;//female pop dy info
+        pPPF->pCI = pCIF;//female catch info
+        
+        ptrOFLCalc = new OFL_Calculator(nFsh);
+        ptrOFLCalc->pT3C  = pT3C;
+        ptrOFLCalc->pPrjM = pPPM;
+        ptrOFLCalc->pPrjF = pPPF;
+    }
+    OFL_Calculator*   pOC  = ptrOFLCalc;
+    Tier3_Calculator* pT3C = pOC->pT3C;
+    PopProjector*     pPPM = pOC->pPrjM;
+    PopProjector*     pPPF = pOC->pPrjF;
+    PopDyInfo*        pPIM = pPPM->pPI;//  males info
+    PopDyInfo*        pPIF = pPPF->pPI;//females info
+    CatchInfo*        pCIM = pPPM->pCI;//  male catch info
+    CatchInfo*        pCIF = pPPF->pCI;//female catch info
+    
     //1. Determine population rates for next year, using yr
     double dtF = dtF_y(yr);
     double dtM = dtM_y(yr);
     
-    PopDyInfo* pPIM = new PopDyInfo(nZBs);//  males info
-    pPIM->R_z   = value(R_yz(yr));
+    if (pcRec_y(yr)) pPIM->R_z = value(R_cz(pcRec_y(yr))); else pPIM->R_z.initialize();//no recruitment pc
     pPIM->w_mz  = ptrMDS->ptrBio->wAtZ_xmz(MALE);
-    pPIM->M_msz = value(M_yxmsz(yr,MALE));
+    for (int m=1;m<=nMSs;m++) {dvector M_z = value(getM_z(yr,MALE,m));   for (int s=1;s<=nSCs;s++) pPIM->M_msz(m,s) = M_z;}
     pPIM->T_szz = value(prGr_yxszz(yr,MALE));
     for (int s=1;s<=nSCs;s++) pPIM->Th_sz(s) = value(prMat_yxz(yr,MALE));
     
-    PopDyInfo* pPIF = new PopDyInfo(nZBs);//females info
-    pPIF->R_z   = value(R_yz(yr));
+    if (pcRec_y(yr)) pPIF->R_z = value(R_cz(pcRec_y(yr))); else pPIF->R_z.initialize();//no recruitment pc
     pPIF->w_mz  = ptrMDS->ptrBio->wAtZ_xmz(FEMALE);
-    pPIF->M_msz = value(M_yxmsz(yr,FEMALE));
+    for (int m=1;m<=nMSs;m++) {dvector M_z = value(getM_z(yr,FEMALE,m)); for (int s=1;s<=nSCs;s++) pPIF->M_msz(m,s) = M_z;}
     pPIF->T_szz = value(prGr_yxszz(yr,FEMALE));
     for (int s=1;s<=nSCs;s++) pPIF->Th_sz(s) = value(prMat_yxz(yr,FEMALE));
     
@@ -1860,14 +3498,12 @@ FUNCTION void calcOFL(int yr, int debug, ostream& cout)
             cout<<"avgRFcn_fxmsz(1,MALE,MATURE,NEW_SHELL) = "<<avgRFcn_fxmsz(1,MALE,MATURE,NEW_SHELL)<<endl;
         }
         
-        CatchInfo* pCIM = new CatchInfo(nZBs,nFsh);//male catch info
         pCIM->setCaptureRates(MALE, avgCapF_fxmsz);
         pCIM->setRetentionFcns(MALE, avgRFcn_fxmsz);
         pCIM->setHandlingMortality(avgHM_f);
         double maxCapF = pCIM->findMaxTargetCaptureRate(cout);
         if (debug) cout<<"maxCapF = "<<maxCapF<<endl;
         
-        CatchInfo* pCIF = new CatchInfo(nZBs,nFsh);//female catch info
         pCIF->setCaptureRates(FEMALE, avgCapF_fxmsz);
         pCIF->setRetentionFcns(FEMALE, avgRFcn_fxmsz);
         pCIF->setHandlingMortality(avgHM_f);
@@ -1887,11 +3523,8 @@ FUNCTION void calcOFL(int yr, int debug, ostream& cout)
         }
         
     //5. Determine Fmsy and Bmsy
-        Tier3_Calculator* pT3C = new Tier3_Calculator(nZBs,nFsh);
         pT3C->dtF = dtF;
         pT3C->dtM = dtM;
-        pT3C->pPI = pPIM;//male pop dy info
-        pT3C->pCI = pCIM;//male catch info
         
         double B100 = pT3C->calcB100(avgRec_x(MALE),cout);
         double Bmsy = pT3C->calcBmsy(avgRec_x(MALE),cout);
@@ -1916,24 +3549,12 @@ FUNCTION void calcOFL(int yr, int debug, ostream& cout)
         
     //6. Determine Fofl and OFL    
         //population projector for males
-        PopProjector* pPPM = new PopProjector(nZBs,nFsh);
         pPPM->dtF = dtF;
         pPPM->dtM = dtM;
-        pPPM->pPI = pPIM;//male pop dy info
-        pPPM->pCI = pCIM;//male catch info
         
         //population projector for females
-        PopProjector* pPPF = new PopProjector(nZBs,nFsh);
         pPPF->dtF = dtF;
         pPPF->dtM = dtM;
-        pPPF->pPI = pPIF;//female pop dy info
-        pPPF->pCI = pCIF;//female catch info
-        
-        //OFL calculator
-        OFL_Calculator* pOC = new OFL_Calculator(nFsh);
-        pOC->pT3C = pT3C;
-        pOC->pPrjM = pPPM;
-        pOC->pPrjF = pPPF;
         
         //calculate Fofl
         double Fofl = pOC->calcFofl(Bmsy,Fmsy,n_xmsz(MALE),cout);
@@ -1976,12 +3597,12 @@ FUNCTION void initPopDyMod(int debug, ostream& cout)
        
     setAllDevs(debug,cout);//set devs vectors
     
-    calcRecruitment(debug,cout);//calculate recruitment
-    calcNatMort(debug,cout);    //calculate natural mortality rates
-    calcGrowth(debug,cout);     //calculate growth transition matrices
-    calcMaturity(debug,cout);   //calculate maturity ogives
+    calcRecruitment(debug,cout);    //calculate recruitment
+    calcNatMortMemo(debug,cout);    //calculate natural mortality rates
+    calcGrowthMemo(debug,cout);     //calculate growth transition matrices
+    calcMaturityMemo(debug,cout);   //calculate maturity ogives
     
-    calcSelectivities(debug,cout); //calculate selectivity functions
+    calcSelectivitiesMemo(debug,cout); //calculate selectivity functions
     calcFisheryFs(debug,cout);     //calculate fishery F's
     calcSurveyQs(debug,cout);      //calculate survey Q's
     
@@ -1994,13 +3615,110 @@ FUNCTION void initPopDyMod(int debug, ostream& cout)
         calcEqNatZF100(initMnR,mnYr,debug,cout);//calculate n_xmsz
         n_yxmsz(mnYr) = n_xmsz;
     } else {
-        cout<<"Unrecognized option for initial n-at-z: "<<optInitNatZ<<endl;
-        cout<<"Terminating!"<<endl;
-        exit(-1);
+        cout<<"Unrecognized option for initial n-at-z: "<<optInitNatZ<<endl;
+        cout<<"Terminating!"<<endl;
+        exit(-1);
+    }
+
+    
+    if (debug>=dbgPopDy) cout<<"finished initPopDyMod()"<<endl;
+
+//-------------------------------------------------------------------------------------
+//*     Memoized process calculations. If none of the parameters a process
+//*     depends on are active in the current phase, its results are constant
+//*     for the phase: they are calculated once, cached (as constants) and 
+//*     copied from the cache on subsequent calls (keeping the calculations
+//*     off the AD tape). Caches are invalidated at phase changes and
+//*     whenever parameter values are reset (see invalidateMemos()).
+FUNCTION void invalidateMemos()
+    phsMemoNM  = -1;
+    phsMemoGr  = -1;
+    phsMemoMat = -1;
+    phsMemoSel = -1;
+
+//-------------------------------------------------------------------------------------
+//test whether any element of a parameter vector is active in the current phase
+FUNCTION int anyActive(param_init_bounded_number_vector& p)
+    for (int i=p.indexmin();i<=p.indexmax();i++) if (active(p(i))) return 1;
+    return 0;
+
+//-------------------------------------------------------------------------------------
+//test whether any element of a parameter vector is active in the current phase
+FUNCTION int anyActive(param_init_bounded_vector_vector& p)
+    for (int i=p.indexmin();i<=p.indexmax();i++) if (active(p(i))) return 1;
+    return 0;
+
+//-------------------------------------------------------------------------------------
+//calculate natural mortality rates, memoized if no natural mortality parameters are active
+FUNCTION void calcNatMortMemo(int debug, ostream& cout)
+    if (doMemo&&!(anyActive(pLnM)||anyActive(pLnDMT)||anyActive(pLnDMX)||anyActive(pLnDMM)||anyActive(pLnDMXM))){
+        if (phsMemoNM==current_phase()){
+            M_cxm   = memoM_cxm;
+            return;
+        }
+        calcNatMort(debug,cout);
+        memoM_cxm   = value(M_cxm);
+        phsMemoNM   = current_phase();
+    } else {
+        calcNatMort(debug,cout);
     }
 
-    
-    if (debug>=dbgPopDy) cout<<"finished initPopDyMod()"<<endl;
+//-------------------------------------------------------------------------------------
+//calculate growth transition matrices, memoized if no growth parameters are active
+FUNCTION void calcGrowthMemo(int debug, ostream& cout)
+    if (doMemo&&!(anyActive(pLnGrA)||anyActive(pLnGrB)||anyActive(pLnGrBeta))){
+        if (phsMemoGr==current_phase()){
+            mnGrZ_cz   = memoMnGrZ_cz;
+            prGr_czz   = memoPrGr_czz;
+            mnGrZ_yxsz = memoMnGrZ_yxsz;
+            prGr_yxszz = memoPrGr_yxszz;
+            return;
+        }
+        calcGrowth(debug,cout);
+        memoMnGrZ_cz   = value(mnGrZ_cz);
+        memoPrGr_czz   = value(prGr_czz);
+        memoMnGrZ_yxsz = value(mnGrZ_yxsz);
+        memoPrGr_yxszz = value(prGr_yxszz);
+        phsMemoGr      = current_phase();
+    } else {
+        calcGrowth(debug,cout);
+    }
+
+//-------------------------------------------------------------------------------------
+//calculate maturity ogives, memoized if no maturity parameters are active
+FUNCTION void calcMaturityMemo(int debug, ostream& cout)
+    if (doMemo&&!anyActive(pLgtPrMat)){
+        if (phsMemoMat==current_phase()){
+            prMat_cz  = memoPrMat_cz;
+            prMat_yxz = memoPrMat_yxz;
+            return;
+        }
+        calcMaturity(debug,cout);
+        memoPrMat_cz  = value(prMat_cz);
+        memoPrMat_yxz = value(prMat_yxz);
+        phsMemoMat    = current_phase();
+    } else {
+        calcMaturity(debug,cout);
+    }
+
+//-------------------------------------------------------------------------------------
+//calculate selectivity functions, memoized if no selectivity parameters (or devs) are active
+FUNCTION void calcSelectivitiesMemo(int debug, ostream& cout)
+    if (doMemo&&!(anyActive(pS1)||anyActive(pS2)||anyActive(pS3)||anyActive(pS4)||anyActive(pS5)||anyActive(pS6)||
+                  anyActive(pDevsS1)||anyActive(pDevsS2)||anyActive(pDevsS3)||
+                  anyActive(pDevsS4)||anyActive(pDevsS5)||anyActive(pDevsS6))){
+        if (phsMemoSel==current_phase()){
+            sel_cz  = memoSel_cz;
+            sel_cyz = memoSel_cyz;
+            return;
+        }
+        calcSelectivities(debug,cout);
+        memoSel_cz  = value(sel_cz);
+        memoSel_cyz = value(sel_cyz);
+        phsMemoSel  = current_phase();
+    } else {
+        calcSelectivities(debug,cout);
+    }
 
 //-------------------------------------------------------------------------------------
 FUNCTION void runPopDyMod(int debug, ostream& cout)
@@ -2019,139 +3737,173 @@ FUNCTION void runPopDyMod(int debug, ostream& cout)
     
 //-------------------------------------------------------------------------------------
 //calculate surveys.
+//surveys are only calculated in years with survey data unless doSrvAllYrs is set
 FUNCTION void doSurveys(int y,int debug,ostream& cout)
     if (debug>=dbgPopDy) cout<<"starting doSurveys("<<y<<")"<<endl;
 
     for (int v=1;v<=nSrv;v++){
+        if (!(doSrvAllYrs||hasSrvObs_vy(v,y))) continue;
         for (int x=1;x<=nSXs;x++){
+            int pc = pcSrv_vyx(v,y,x);
+            if (!pc) {n_vyxmsz(v,y,x).initialize(); continue;}
             for (int m=1;m<=nMSs;m++){
+                dvar_vector q_z = Q_cxm(pc,x,m)*sel_cyz(idSelSrv_c(pc),y);//size-specific catchability
                 for (int s=1;s<=nSCs;s++){
-                    n_vyxmsz(v,y,x,m,s) = elem_prod(q_vyxmsz(v,y,x,m,s),n_yxmsz(y,x,m,s));
+                    n_vyxmsz(v,y,x,m,s) = elem_prod(q_z,n_yxmsz(y,x,m,s));
                 }
             }
         }
-    }
-    for (int v=1;v<=nSrv;v++){
         mb_vyx(v,y) = calcSpB(n_vyxmsz(v,y),y,debug,cout);
     }
     if (debug>=dbgPopDy) cout<<"finished doSurveys("<<y<<")"<<endl;
 
+//-------------------------------------------------------------------------------------
+//calculate surveys in years without survey data (for output, after runPopDyMod)
+FUNCTION void fillSurveys(int debug,ostream& cout)
+    doSrvAllYrs = 1;
+    for (int y=mnYr;y<=mxYr+1;y++) doSurveys(y,debug,cout);
+    doSrvAllYrs = 0;
+
+//-------------------------------------------------------------------------------------
+//determine survey/year combinations with index catch data
+FUNCTION void setupSurveyYears()
+    hasSrvObs_vy.allocate(1,nSrv,mnYr,mxYr+1); hasSrvObs_vy.initialize();
+    pcSrv_vyx.allocate(1,nSrv,mnYr,mxYr+1,1,nSXs); pcSrv_vyx.initialize();
+    idSelSrv_c.allocate(1,npcSrv); idSelSrv_c.initialize();
+    for (int v=1;v<=nSrv;v++){
+        FleetData* ptrObs = ptrMDS->ppSrv[v-1];
+        if (ptrObs->hasICD){
+            if (ptrObs->ptrICD->hasN)  {ivector& yrs = ptrObs->ptrICD->ptrN->yrs;   for (int i=yrs.indexmin();i<=yrs.indexmax();i++) if ((mnYr<=yrs(i))&&(yrs(i)<=mxYr+1)) hasSrvObs_vy(v,yrs(i)) = 1;}
+            if (ptrObs->ptrICD->hasB)  {ivector& yrs = ptrObs->ptrICD->ptrB->yrs;   for (int i=yrs.indexmin();i<=yrs.indexmax();i++) if ((mnYr<=yrs(i))&&(yrs(i)<=mxYr+1)) hasSrvObs_vy(v,yrs(i)) = 1;}
+            if (ptrObs->ptrICD->hasZFD){ivector& yrs = ptrObs->ptrICD->ptrZFD->yrs; for (int i=yrs.indexmin();i<=yrs.indexmax();i++) if ((mnYr<=yrs(i))&&(yrs(i)<=mxYr+1)) hasSrvObs_vy(v,yrs(i)) = 1;}
+        }
+    }
+
+//-------------------------------------------------------------------------------------
+//allocate the population states used to step through a model year
+FUNCTION void setupPopDyStates()
+    pPopDyStates = new tcsam::PopStateCycle_xms();
+    pPopDyStates->allocate(1,nZBs);
+
 //-------------------------------------------------------------------------------------
 FUNCTION void runPopDyModOneYear(int yr, int debug, ostream& cout)
     if (debug>=dbgPopDy) cout<<"Starting runPopDyModOneYear("<<yr<<")"<<endl;
 
-    dvar4_array n1_xmsz(1,nSXs,1,nMSs,1,nSCs,1,nZBs);
-    dvar4_array n2_xmsz(1,nSXs,1,nMSs,1,nSCs,1,nZBs);
-    dvar4_array n3_xmsz(1,nSXs,1,nMSs,1,nSCs,1,nZBs);
-    dvar4_array n4_xmsz(1,nSXs,1,nMSs,1,nSCs,1,nZBs);
-    dvar4_array n5_xmsz(1,nSXs,1,nMSs,1,nSCs,1,nZBs);
+    //each process reads the current state (cur()) and writes the next (nxt())
+    tcsam::PopStateCycle_xms& n_k = *pPopDyStates;
+    n_k.start(n_yxmsz(yr));//current state is now numbers at start of year
     
     if (dtF_y(yr)<=dtM_y(yr)){//fishery occurs BEFORE molting/growth/maturity
         if (debug>=dbgPopDy) cout<<"Fishery occurs BEFORE molting/growth/maturity"<<endl;
         //apply natural mortality before fisheries
-        n1_xmsz = applyNatMort(n_yxmsz(yr),yr,dtF_y(yr),debug,cout);
+        applyNatMort(n_k.cur(),n_k.nxt(),yr,dtF_y(yr),debug,cout); n_k.advance();
         //conduct fisheries
-        n2_xmsz = applyFshMort(n1_xmsz,yr,debug,cout);
+        applyFshMort(n_k.cur(),n_k.nxt(),yr,debug,cout); n_k.advance();
         //apply natural mortality from fisheries to molting/growth/maturity
-        if (dtF_y(yr)==dtM_y(yr)) {
-            n3_xmsz = n2_xmsz;
-        } else {
-            n3_xmsz = applyNatMort(n2_xmsz,yr,dtM_y(yr)-dtF_y(yr),debug,cout);
+        if (dtF_y(yr)!=dtM_y(yr)) {
+            applyNatMort(n_k.cur(),n_k.nxt(),yr,dtM_y(yr)-dtF_y(yr),debug,cout); n_k.advance();
         }
         //calc mature (spawning) biomass at time of mating (TODO: does this make sense??)
-        spB_yx(yr) = calcSpB(n3_xmsz,yr,debug,cout);
+        spB_yx(yr) = calcSpB(n_k.cur(),yr,debug,cout);
         //apply molting, growth and maturation
-        n4_xmsz = applyMGM(n3_xmsz,yr,debug,cout);
+        applyMGM(n_k.cur(),n_k.nxt(),yr,debug,cout); n_k.advance();
         //apply natural mortality to end of year
-        if (dtM_y(yr)==1.0) {
-            n5_xmsz = n4_xmsz;
-        } else {
-            n5_xmsz = applyNatMort(n4_xmsz,yr,1.0-dtM_y(yr),debug,cout);
+        if (dtM_y(yr)!=1.0) {
+            applyNatMort(n_k.cur(),n_k.nxt(),yr,1.0-dtM_y(yr),debug,cout); n_k.advance();
         }
     } else {              //fishery occurs AFTER molting/growth/maturity
         if (debug>=dbgPopDy) cout<<"Fishery occurs AFTER molting/growth/maturity"<<endl;
         //apply natural mortality before molting/growth/maturity
-        n1_xmsz = applyNatMort(n_yxmsz(yr),yr,dtM_y(yr),debug,cout);
+        applyNatMort(n_k.cur(),n_k.nxt(),yr,dtM_y(yr),debug,cout); n_k.advance();
         //calc mature (spawning) biomass at time of mating (TODO: does this make sense??)
-        spB_yx(yr) = calcSpB(n1_xmsz,yr,debug,cout);
+        spB_yx(yr) = calcSpB(n_k.cur(),yr,debug,cout);
         //apply molting, growth and maturation
-        n2_xmsz = applyMGM(n1_xmsz,yr,debug,cout);
+        applyMGM(n_k.cur(),n_k.nxt(),yr,debug,cout); n_k.advance();
         //apply natural mortality from molting/growth/maturity to fisheries
-        if (dtM_y(yr)==dtF_y(yr)) {
-            n3_xmsz = n2_xmsz;
-        } else {
-            n3_xmsz = applyNatMort(n2_xmsz,yr,dtF_y(yr)-dtM_y(yr),debug,cout);
+        if (dtM_y(yr)!=dtF_y(yr)) {
+            applyNatMort(n_k.cur(),n_k.nxt(),yr,dtF_y(yr)-dtM_y(yr),debug,cout); n_k.advance();
         }
         //conduct fisheries
-        n4_xmsz = applyFshMort(n3_xmsz,yr,debug,cout);
+        applyFshMort(n_k.cur(),n_k.nxt(),yr,debug,cout); n_k.advance();
         //apply natural mortality to end of year
-        if (dtF_y(yr)==1.0) {
-            n5_xmsz = n4_xmsz;
-        } else {
-            n5_xmsz = applyNatMort(n4_xmsz,yr,1.0-dtF_y(yr),debug,cout);
+        if (dtF_y(yr)!=1.0) {
+            applyNatMort(n_k.cur(),n_k.nxt(),yr,1.0-dtF_y(yr),debug,cout); n_k.advance();
         }
     }
     
     //advance surviving individuals to next year
+    tcsam::PopState_xms& n5_xms = n_k.cur();
     for (int x=1;x<=nSXs;x++){
         for (int m=1;m<=nMSs;m++){
             for (int s=1;s<=nSCs;s++){
-                n_yxmsz(yr+1,x,m,s) = n5_xmsz(x,m,s);
+                n_yxmsz(yr+1,x,m,s) = n5_xms(x,m,s);
             }
         }
     }
     //add in recruits
-    for (int x=1;x<=nSXs;x++) n_yxmsz(yr+1,x,IMMATURE,NEW_SHELL) += R_yxz(yr,x);
+    if (pcRec_y(yr)) {
+        for (int x=1;x<=nSXs;x++) n_yxmsz(yr+1,x,IMMATURE,NEW_SHELL) += (R_y(yr)*R_yx(yr,x))*R_cz(pcRec_y(yr));
+    }
     
     if (debug>=dbgPopDy) cout<<"finished runPopDyModOneYear("<<yr<<")"<<endl;
     
 //-------------------------------------------------------------------------------------
 FUNCTION dvar_vector calcSpB(dvar4_array& n0_xmsz, int y, int debug, ostream& cout)
+    tcsam::PopState_xms n0_xms; n0_xms.bind(n0_xmsz);//view on (not a copy of) n0_xmsz
+    return calcSpB(n0_xms,y,debug,cout);
+    
+//-------------------------------------------------------------------------------------
+FUNCTION dvar_vector calcSpB(tcsam::PopState_xms& n0_xms, int y, int debug, ostream& cout)
     if (debug>dbgApply) cout<<"starting calcSpB("<<y<<")"<<endl;
     RETURN_ARRAYS_INCREMENT();
     dvar_vector spb(1,nSXs); spb.initialize();
     for (int x=1;x<=nSXs;x++){
-        for (int s=1;s<=nSCs;s++) spb(x) += n0_xmsz(x,MATURE,s)*ptrMDS->ptrBio->wAtZ_xmz(x,MATURE);//dot product here
+        for (int s=1;s<=nSCs;s++) spb(x) += n0_xms(x,MATURE,s)*ptrMDS->ptrBio->wAtZ_xmz(x,MATURE);//dot product here
     }
     if (debug>dbgApply) cout<<"finished calcSpB("<<y<<")"<<endl;
     RETURN_ARRAYS_DECREMENT();
     return spb;
     
 //-------------------------------------------------------------------------------------
-FUNCTION dvar4_array applyNatMort(dvar4_array& n0_xmsz, int y, double dt, int debug, ostream& cout)
+//Apply natural mortality over time interval dt to population state n0_xms.
+//Survivors are written to n1_xms.
+FUNCTION void applyNatMort(tcsam::PopState_xms& n0_xms, tcsam::PopState_xms& n1_xms, int y, double dt, int debug, ostream& cout)
     if (debug>dbgApply) cout<<"starting applyNatMort("<<y<<cc<<dt<<")"<<endl;
-    RETURN_ARRAYS_INCREMENT();
-    dvar4_array n1_xmsz(1,nSXs,1,nMSs,1,nSCs,1,nZBs);
+    int pc = pcNM_y(y);
     for (int x=1;x<=nSXs;x++){
         for (int m=1;m<=nMSs;m++){
+            dvariable M = 0.0; if (pc) M = M_cxm(pc,x,m);
+            if (pc&&zSclNM_c(pc)) {
+                dvar_vector S_z = mfexp(-(M*dt)*zSclM_z);//survival by size
+                for (int s=1;s<=nSCs;s++) n1_xms(x,m,s) = elem_prod(S_z,n0_xms(x,m,s));//survivors
+            } else {
+                dvariable S = mfexp(-M*dt);//survival (independent of size)
+                for (int s=1;s<=nSCs;s++) n1_xms(x,m,s) = S*n0_xms(x,m,s);//survivors
+            }
             for (int s=1;s<=nSCs;s++){
-                n1_xmsz(x,m,s) = elem_prod(mfexp(-M_yxmsz(y,x,m,s)*dt),n0_xmsz(x,m,s));//survivors
-                nmN_yxmsz(y,x,m,s) += n0_xmsz(x,m,s)-n1_xmsz(x,m,s); //natural mortality
-                tmN_yxmsz(y,x,m,s) += n0_xmsz(x,m,s)-n1_xmsz(x,m,s); //natural mortality
+                nmN_yxmsz(y,x,m,s) += n0_xms(x,m,s)-n1_xms(x,m,s); //natural mortality
+                tmN_yxmsz(y,x,m,s) += n0_xms(x,m,s)-n1_xms(x,m,s); //natural mortality
             }
         }
     }
     if (debug>dbgApply) cout<<"finished applyNatMort("<<y<<cc<<dt<<")"<<endl;
-    RETURN_ARRAYS_DECREMENT();
-    return n1_xmsz;
     
 //-------------------------------------------------------------------------------------
-FUNCTION dvar4_array applyFshMort(dvar4_array& n0_xmsz, int y, int debug, ostream& cout)
+//Apply fishing mortality to population state n0_xms.
+//Numbers surviving the fisheries are written to n1_xms.
+FUNCTION void applyFshMort(tcsam::PopState_xms& n0_xms, tcsam::PopState_xms& n1_xms, int y, int debug, ostream& cout)
     if (debug>dbgApply) cout<<"starting applyFshMort("<<y<<")"<<endl;
-    RETURN_ARRAYS_INCREMENT();
     dvar_vector tm_z(1,nZBs);//total mortality (numbers) by size
     dvar_vector tvF_z(1,nZBs);//total fishing mortality rate by size, for use in calculating fishing rate components
     dvector     tdF_z(1,nZBs);//total fishing mortality rate by size, for use in calculating fishing rate components
-    dvar4_array n1_xmsz(1,nSXs,1,nMSs,1,nSCs,1,nZBs);//numbers surviving fisheries
-    n1_xmsz.initialize();
     for (int x=1;x<=nSXs;x++){
         for (int m=1;m<=nMSs;m++){
             for (int s=1;s<=nSCs;s++){
                 tmF_yxmsz(y,x,m,s) = 0.0;//total fishing mortality rate
                 for (int f=1;f<=nFsh;f++) tmF_yxmsz(y,x,m,s) += rmF_fyxmsz(f,y,x,m,s)+dmF_fyxmsz(f,y,x,m,s);
-                n1_xmsz(x,m,s) = elem_prod(mfexp(-tmF_yxmsz(y,x,m,s)),n0_xmsz(x,m,s));//numbers surviving all fisheries
-                tm_z = n0_xmsz(x,m,s)-n1_xmsz(x,m,s);  //numbers killed by all fisheries
-                tmN_yxmsz(y,x,m,s) += tm_z;            //add in numbers killed by all fisheries to total killed
+                n1_xms(x,m,s) = elem_prod(mfexp(-tmF_yxmsz(y,x,m,s)),n0_xms(x,m,s));//numbers surviving all fisheries
+                tm_z = n0_xms(x,m,s)-n1_xms(x,m,s);  //numbers killed by all fisheries
+                tmN_yxmsz(y,x,m,s) += tm_z;          //add in numbers killed by all fisheries to total killed
                 
                 //calculate fishing rate components (need to ensure NOT dividing by 0)
                 tdF_z = value(tmF_yxmsz(y,x,m,s));
@@ -2172,25 +3924,19 @@ FUNCTION dvar4_array applyFshMort(dvar4_array& n0_xmsz, int y, int debug, ostrea
         }
     }
     if (debug>dbgApply) cout<<"finished applyFshMort("<<y<<")"<<endl;
-    RETURN_ARRAYS_DECREMENT();
-    return n1_xmsz;
     
 //------------------------------------------------------------------------------
-//Apply molting/growth/maturity to population numbers    
-FUNCTION dvar4_array applyMGM(dvar4_array& n0_xmsz, int y, int debug, ostream& cout)
+//Apply molting/growth/maturity to population state n0_xms.
+//Results are written to n1_xms.
+FUNCTION void applyMGM(tcsam::PopState_xms& n0_xms, tcsam::PopState_xms& n1_xms, int y, int debug, ostream& cout)
     if (debug>dbgApply) cout<<"starting applyMGM("<<y<<")"<<endl;
-    RETURN_ARRAYS_INCREMENT();
-    dvar4_array n1_xmsz(1,nSXs,1,nMSs,1,nSCs,1,nZBs);
-    n1_xmsz.initialize();
     for (int x=1;x<=nSXs;x++){
-        n1_xmsz(x,IMMATURE,NEW_SHELL) = prGr_yxszz(y,x,NEW_SHELL)*elem_prod(1.0-prMat_yxz(y,x),n0_xmsz(x,IMMATURE,NEW_SHELL));
-        n1_xmsz(x,IMMATURE,OLD_SHELL) = 0.0;
-        n1_xmsz(x,MATURE,NEW_SHELL)   = prGr_yxszz(y,x,NEW_SHELL)*elem_prod(    prMat_yxz(y,x),n0_xmsz(x,IMMATURE,NEW_SHELL));
-        n1_xmsz(x,MATURE,OLD_SHELL)   = n0_xmsz(x,MATURE,NEW_SHELL)+n0_xmsz(x,MATURE,OLD_SHELL);
+        n1_xms(x,IMMATURE,NEW_SHELL) = prGr_yxszz(y,x,NEW_SHELL)*elem_prod(1.0-prMat_yxz(y,x),n0_xms(x,IMMATURE,NEW_SHELL));
+        n1_xms(x,IMMATURE,OLD_SHELL) = 0.0;
+        n1_xms(x,MATURE,NEW_SHELL)   = prGr_yxszz(y,x,NEW_SHELL)*elem_prod(    prMat_yxz(y,x),n0_xms(x,IMMATURE,NEW_SHELL));
+        n1_xms(x,MATURE,OLD_SHELL)   = n0_xms(x,MATURE,NEW_SHELL)+n0_xms(x,MATURE,OLD_SHELL);
     }
-    if (debug>dbgApply) cout<<"finished applyNatMGM("<<y<<")"<<endl;
-    RETURN_ARRAYS_DECREMENT();
-    return n1_xmsz;
+    if (debug>dbgApply) cout<<"finished applyMGM("<<y<<")"<<endl;
     
 //-------------------------------------------------------------------------------------
 //calculate recruitment.
@@ -2203,15 +3949,14 @@ FUNCTION void calcRecruitment(int debug, ostream& cout)
     Rx_c.initialize();
     R_yx.initialize();
     R_cz.initialize();
-    R_yz.initialize();
-    R_yxz.initialize();
+    pcRec_y.initialize();
     stdvDevsLnR_cy.initialize();
     zscrDevsLnR_cy.initialize();
     
     int k; int y;
     dvector dzs = zBs+(zBs[2]-zBs[1])/2.0-zBs[1];
     for (int pc=1;pc<=ptrRI->nPCs;pc++){
-        ivector pids = ptrRI->getPCIDs(pc);
+        ivector& pids = ptrRI->getPCIDs(pc);
         k=ptrRI->nIVs+1;//first parameter variable column in ParameterComnbinations
         dvariable mnLnR    = pLnR(pids[k++]);
         dvariable lnRCV    = pLnRCV(pids[k++]);
@@ -2248,43 +3993,36 @@ FUNCTION void calcRecruitment(int debug, ostream& cout)
         R_cz(pc) = elem_prod(pow(dzs,mfexp(lnRa-lnRb)-1.0),mfexp(-dzs/mfexp(lnRb)));
         R_cz(pc) /= sum(R_cz(pc));//normalize to sum to 1
 
-        imatrix idxs = ptrRI->getModelIndices(pc);
-        for (int idx=idxs.indexmin();idx<=idxs.indexmax();idx++){
+        imatrix& idxs = ptrRI->planIdxs;//model indices for all pcs, clipped to model years
+        for (int idx=ptrRI->planFirst(pc);idx<=ptrRI->planLast(pc);idx++){
             y = idxs(idx,1);
             if (y==mnYr) initMnR = mnR;
-            if ((mnYr<=y)&&(y<=mxYr)){
-                if (debug>dbgCalcProcs+10) cout<<"y,i = "<<y<<tb<<idxDevsLnR(y)<<endl;
-                if (useDevs){
-                    R_y(y) = mfexp(mnLnR+dvsLnR[idxDevsLnR[y]]);
-                } else {
-                    R_y(y) = mnR;
-                }
-                if (debug>dbgCalcProcs+10) cout<<"R_y(y)="<<R_y(y)<<tb;
-                if (MALE==nSXs){
-                    R_yx(y,MALE) = 1.0;//only tracking males
-                } else {
-                    R_yx(y,MALE)   = Rx_c(pc);
-                    R_yx(y,FEMALE) = 1.0-R_yx(y,MALE);
-                    if (debug>dbgCalcProcs+10) cout<<R_yx(y,MALE)<<endl;
-                }
-
-                R_yz(y) = R_cz(pc);
-                if (debug>dbgCalcProcs+10) cout<<"R_yz(y)="<<R_yz(y)<<endl;
-                
-                for (int x=1;x<=nSXs;x++) R_yxz(y,x) = R_y(y)*R_yx(y,x)*R_yz(y);
-
-                stdvDevsLnR_cy(pc,y) = sqrt(varLnR); //ln-scale std dev
-                zscrDevsLnR_cy(pc,y) = dvsLnR(idxDevsLnR(y))/stdvDevsLnR_cy(pc,y);//standardized ln-scale rec devs
+            if (debug>dbgCalcProcs+10) cout<<"y,i = "<<y<<tb<<idxDevsLnR(y)<<endl;
+            if (useDevs){
+                R_y(y) = mfexp(mnLnR+dvsLnR[idxDevsLnR[y]]);
+            } else {
+                R_y(y) = mnR;
+            }
+            if (debug>dbgCalcProcs+10) cout<<"R_y(y)="<<R_y(y)<<tb;
+            if (MALE==nSXs){
+                R_yx(y,MALE) = 1.0;//only tracking males
             } else {
-                if (debug>dbgCalcProcs) cout<<"skipping y,i = "<<y<<tb<<idxDevsLnR(y)<<endl;
+                R_yx(y,MALE)   = Rx_c(pc);
+                R_yx(y,FEMALE) = 1.0-R_yx(y,MALE);
+                if (debug>dbgCalcProcs+10) cout<<R_yx(y,MALE)<<endl;
             }
+
+            pcRec_y(y) = pc;//recruits-at-size in y are R_y(y)*R_yx(y,x)*R_cz(pc)
+
+            stdvDevsLnR_cy(pc,y) = sqrt(varLnR); //ln-scale std dev
+            zscrDevsLnR_cy(pc,y) = dvsLnR(idxDevsLnR(y))/stdvDevsLnR_cy(pc,y);//standardized ln-scale rec devs
         }//idx
     }//pc
     
     if (debug>dbgCalcProcs) {
         cout<<"R_y = "<<R_y<<endl;
         cout<<"R_yx(MALE) = "<<column(R_yx,MALE)<<endl;
-        cout<<"R_yz = "<<endl<<R_yz<<endl;
+        cout<<"pcRec_y = "<<pcRec_y<<endl;
         cout<<"zscr = "<<zscrDevsLnR_cy<<endl;
         cout<<"finished calcRecruitment()"<<endl;
     }
@@ -2299,7 +4037,9 @@ FUNCTION void calcRecruitment(int debug, ostream& cout)
 //* Returns:
 //*  void
 //* Alters:
-//*  M_yxmsz - year/sex/maturity state/shell condition/size-specific natural mortality rate
+//*  M_cxm    - sex/maturity state-specific natural mortality rate by parameter combination
+//*  pcNM_y   - parameter combination by year
+//*  zSclNM_c - flags to apply size scaling by parameter combination
 //******************************************************************************
 FUNCTION void calcNatMort(int debug, ostream& cout)  
     if(debug>dbgCalcProcs) cout<<"Starting calcNatMort()"<<endl;
@@ -2307,16 +4047,16 @@ FUNCTION void calcNatMort(int debug, ostream& cout)
     NaturalMortalityInfo* ptrNM = ptrMPI->ptrNM;
     
     dvar_matrix lnM(1,nSXs,1,nMSs);
-    dvar3_array M_xmz(1,nSXs,1,nMSs,1,nZBs);
     
     M_cxm.initialize();
-    M_yxmsz.initialize();
+    pcNM_y.initialize();
+    zSclNM_c.initialize();
 
     int y; 
     for (int pc=1;pc<=ptrNM->nPCs;pc++){
         if (debug>dbgCalcProcs) cout<<"pc = "<<pc<<endl;
         lnM.initialize();
-        ivector pids = ptrNM->getPCIDs(pc);
+        ivector& pids = ptrNM->getPCIDs(pc);
         int k=ptrNM->nIVs+1;//1st parameter variable column
         if (debug>dbgCalcProcs) cout<<"pids = "<<pids(k,pids.indexmax())<<endl;
         //add in base (ln-scale) natural mortality (immature males)
@@ -2358,36 +4098,37 @@ FUNCTION void calcNatMort(int debug, ostream& cout)
             for (int x=1;x<=nSXs;x++) cout<<"M_xm("<<x<<")= "<<M_cxm(pc,x)<<endl;
         }
         
-        //add in size-scaling, if requested
-        M_xmz.initialize();
+        //flag size-scaling, if requested (applied by getM_z and applyNatMort)
         if (pids[k]&&(current_phase()>=pids[k])) {
             if (debug>dbgCalcProcs) cout<<"adding size scaling"<<endl;
-            for (int x=1;x<=nSXs;x++){
-                for (int m=1;m<=nMSs;m++) M_xmz(x,m) = M_cxm(pc,x,m)*(zMref/zBs);//factor in size dependence
-            }
+            zSclNM_c(pc) = 1;
         } else {
             if (debug>dbgCalcProcs) cout<<"not adding size scaling"<<endl;
-            for (int x=1;x<=nSXs;x++){
-                for (int m=1;m<=nMSs;m++) M_xmz(x,m) = M_cxm(pc,x,m);//no size dependence
-            }
+            zSclNM_c(pc) = 0;
         }
-        if (debug>dbgCalcProcs) cout<<"finished scaling"<<endl;
         
         //loop over model indices as defined in the index blocks
-        imatrix idxs = ptrNM->getModelIndices(pc);
-        for (int idx=idxs.indexmin();idx<=idxs.indexmax();idx++){
+        imatrix& idxs = ptrNM->planIdxs;//model indices for all pcs, clipped to model years
+        for (int idx=ptrNM->planFirst(pc);idx<=ptrNM->planLast(pc);idx++){
             y = idxs(idx,1);//only model index for natural mortality is year
-            if ((mnYr<=y)&&(y<=mxYr)){
-                for (int x=1;x<=nSXs;x++){
-                    for (int m=1;m<=nMSs;m++){
-                        for (int s=1;s<=nSCs;s++) M_yxmsz(y,x,m,s) = M_xmz(x,m);
-                    }
-                }
-            }
+            pcNM_y(y) = pc;
         }
     }//loop over pcs
     if (debug>dbgCalcProcs) cout<<"Finished calcNatMort()"<<endl;
     
+//-------------------------------------------------------------------------------------
+//natural mortality rates-at-size for year y, sex x, maturity state m (from M_cxm, pcNM_y, zSclNM_c)
+FUNCTION dvar_vector getM_z(int y, int x, int m)
+    RETURN_ARRAYS_INCREMENT();
+    dvar_vector M_z(1,nZBs); M_z.initialize();
+    int pc = pcNM_y(y);
+    if (pc){
+        if (zSclNM_c(pc)) M_z = M_cxm(pc,x,m)*zSclM_z;//factor in size dependence
+        else              M_z = M_cxm(pc,x,m);        //no size dependence
+    }
+    RETURN_ARRAYS_DECREMENT();
+    return M_z;
+    
 //-------------------------------------------------------------------------------------
 //calculate Pr(maturity-at-size)
 FUNCTION void calcMaturity(int debug, ostream& cout)
@@ -2400,7 +4141,7 @@ FUNCTION void calcMaturity(int debug, ostream& cout)
     
     int k; int y; int x;
     for (int pc=1;pc<=ptrMI->nPCs;pc++){
-        ivector pids = ptrMI->getPCIDs(pc);
+        ivector& pids = ptrMI->getPCIDs(pc);
         k=ptrMI->nIVs+1;//first parameter variable column in ParameterComnbinations
         dvar_vector lgtPrMat = pLgtPrMat(pids[k++]);
         int vmn = lgtPrMat.indexmin();
@@ -2417,20 +4158,52 @@ FUNCTION void calcMaturity(int debug, ostream& cout)
             cout<<"prMat = "<<prMat_cz(pc)<<endl;
         }
         
-        imatrix idxs = ptrMI->getModelIndices(pc);
-        if (debug>dbgCalcProcs) cout<<"maturity indices"<<endl<<idxs<<endl;
-        for (int idx=idxs.indexmin();idx<=idxs.indexmax();idx++){
+        imatrix& idxs = ptrMI->planIdxs;//model indices for all pcs, clipped to model years
+        if (debug>dbgCalcProcs) {cout<<"maturity indices"<<endl; for (int idx=ptrMI->planFirst(pc);idx<=ptrMI->planLast(pc);idx++) cout<<idxs(idx)<<endl;}
+        for (int idx=ptrMI->planFirst(pc);idx<=ptrMI->planLast(pc);idx++){
             y = idxs(idx,1);
-            if ((mnYr<=y)&&(y<=mxYr)){
-                x = idxs(idx,2);
-                if (debug>dbgCalcProcs) cout<<"y = "<<y<<tb<<"sex = "<<tcsam::getSexType(x)<<endl;
-                prMat_yxz(y,x) = prMat_cz(pc);//note: this change made a difference, but not sure why!
-            }
+            x = idxs(idx,2);
+            if (debug>dbgCalcProcs) cout<<"y = "<<y<<tb<<"sex = "<<tcsam::getSexType(x)<<endl;
+            prMat_yxz(y,x) = prMat_cz(pc);//note: this change made a difference, but not sure why!
         }
     }
     
     if (debug>dbgCalcProcs) cout<<"finished calcMaturity()"<<endl;
 
+//******************************************************************************
+//* Function: void setupGrowthTables(void)
+//* 
+//* Description: Precomputes the size-bin dependent tables used by calcGrowth
+//*              for optGrowth=0. Row z of grDZ_zz covers the post-molt bins 
+//*              zp>z with growth increments zBs(zp)-zBs(z) no larger than 
+//*              the max growth increment (ptrMOs->maxGrDZ, from the model options 
+//*              file; at least one bin). The zero increment (zp=z), for which
+//*              ln(dZ) is not defined, is handled in calcGrowth(...).
+//* 
+//* Inputs:
+//*  none
+//* Returns:
+//*  void
+//* Alters:
+//*  grDZ_zz, grLnDZ_zz
+//******************************************************************************
+FUNCTION void setupGrowthTables()
+    ivector lb(1,nZBs-1);
+    ivector ub(1,nZBs-1);
+    for (int z=1;z<nZBs;z++){
+        lb(z) = z+1;
+        ub(z) = z+1;
+        while ((ub(z)<nZBs)&&(zBs(ub(z)+1)-zBs(z)<=ptrMOs->maxGrDZ+1.0e-6)) ub(z)++;
+    }
+    grDZ_zz.allocate(1,nZBs-1,lb,ub);
+    grLnDZ_zz.allocate(1,nZBs-1,lb,ub);
+    for (int z=1;z<nZBs;z++){
+        for (int zp=lb(z);zp<=ub(z);zp++){
+            grDZ_zz(z,zp)   = zBs(zp)-zBs(z);
+            grLnDZ_zz(z,zp) = log(grDZ_zz(z,zp));
+        }
+    }
+    
 //******************************************************************************
 //* Function: void calcGrowth(void)
 //* 
@@ -2461,7 +4234,7 @@ FUNCTION void calcGrowth(int debug, ostream& cout)
 
     int y; int x;
     for (int pc=1;pc<=ptrGrI->nPCs;pc++){
-        ivector pids = ptrGrI->getPCIDs(pc);
+        ivector& pids = ptrGrI->getPCIDs(pc);
         int k=ptrGrI->nIVs+1;//1st parameter column
         grA = mfexp(pLnGrA(pids[k])); k++; //"a" coefficient for mean growth
         grB = mfexp(pLnGrB(pids[k])); k++; //"b" coefficient for mean growth
@@ -2478,58 +4251,49 @@ FUNCTION void calcGrowth(int debug, ostream& cout)
             //old style (TCSAM2013)
             dvar_vector alZ = (mnZ-zBs)/grBeta;//scaled mean growth increment from zBs
             for (int z=1;z<nZBs;z++){//pre-molt growth bin
-                dvar_vector dZs =  zBs(z,nZBs) - zBs(z);//realized growth increments (note non-neg. growth only)
-                if (debug) cout<<"dZs: "<<dZs.indexmin()<<":"<<dZs.indexmax()<<endl;
-                dvar_vector prs = elem_prod(pow(dZs,alZ(z)-1.0),mfexp(-dZs/grBeta)); //pr(dZ|z)
+                //pr(dZ|z) = dZ^(alZ-1)*exp(-dZ/grBeta) over the precomputed (truncated) range of increments
+                dvar_vector prs = mfexp((alZ(z)-1.0)*grLnDZ_zz(z)-grDZ_zz(z)/grBeta);
                 if (debug) cout<<"prs: "<<prs.indexmin()<<":"<<prs.indexmax()<<endl;
-                if (prs.size()>10) prs(z+10,nZBs) = 0.0;//limit growth range TODO: this assumes bin size is 5 mm
-                if (debug) cout<<prs<<endl;
-                prs = prs/sum(prs);//normalize to sum to 1
                 if (debug) cout<<prs<<endl;
-                prGr_zz(z)(z,nZBs) = prs;
+                //zero increment (zp=z): dZ^(alZ-1) is 0 for alZ>1, 1 for alZ=1 and 
+                //unbounded for alZ<1 (in the limit, all crab stay in bin z)
+                if (alZ(z)>1.0){
+                    prs = prs/sum(prs);//normalize to sum to 1
+                    prGr_zz(z)(prs.indexmin(),prs.indexmax()) = prs;
+                } else if (alZ(z)==1.0){
+                    dvariable tot = 1.0+sum(prs);
+                    prGr_zz(z,z) = 1.0/tot;
+                    prGr_zz(z)(prs.indexmin(),prs.indexmax()) = prs/tot;
+                } else {
+                    prGr_zz(z,z) = 1.0;
+                }
+                if (debug) cout<<prGr_zz(z)<<endl;
             }
             prGr_zz(nZBs,nZBs) = 1.0; //no growth from max size
         } else if (optGrowth==1){
-            //use cumd_gamma function like gmacs
-            dvar_vector sclMnZ = mnZ/grBeta;           //scaled mean growth increments
-            dvar_vector sclZCs = ptrMC->zCutPts/grBeta;//scaled size bin cut points
-            for (int z=1;z<nZBs;z++){
-                dvar_vector cprs(z,nZBs);
-                for (int zp=z;zp<=nZBs;zp++){
-                    cprs(zp) = cumd_gamma(sclZCs(zp),sclMnZ(z));//cumulative pr to sclZCs(zp)
-                }
-                //cout<<"cprs indices: "<<cprs.indexmin()<<"  "<<cprs.indexmax()<<endl;
-                dvar_vector prs(z,nZBs);
-                prs(z,nZBs-1) = first_difference(cprs);
-                prs(nZBs) = 1.0 - cprs(nZBs);//treat final size bin as accumulator
-                //cout<<"prs indices: "<<prs.indexmin()<<"  "<<prs.indexmax()<<endl;
-                prs = prs/sum(prs);//normalize to sum to 1
-                if (debug) cout<<prs<<endl;
-                prGr_zz(z)(z,nZBs) = prs;
-            }            
-            prGr_zz(nZBs,nZBs) = 1.0; //no growth from max size
+            //use cumd_gamma function like gmacs (matrix and adjoint computed in GrowthFcns)
+            GrowthFcns::debug = debug;
+            prGr_zz = GrowthFcns::calcPrGrCumdGamma(zBs,ptrMC->zCutPts,grA,grB,grBeta);
         } else {
             cout<<"Unrecognized growth option: "<<optGrowth<<endl;
             cout<<"Terminating!"<<endl;
             exit(-1);
         }
         
-        testNaNs(value(sum(prGr_zz)),"Calculating growth");
+        testNaNs(value(sum(prGr_zz(1))),"Calculating growth");//nan's in grA, grB, grBeta propagate to all (assigned) elements
         
         prGr_czz(pc) = trans(prGr_zz);//transpose so rows are post-molt (i.e., "to") z's so n+ = prGr_zz*n
         
         //loop over model indices as defined in the index blocks
-        imatrix idxs = ptrGrI->getModelIndices(pc);
-        if (debug) cout<<"growth indices"<<endl<<idxs<<endl;
-        for (int idx=idxs.indexmin();idx<=idxs.indexmax();idx++){
+        imatrix& idxs = ptrGrI->planIdxs;//model indices for all pcs, clipped to model years
+        if (debug) {cout<<"growth indices"<<endl; for (int idx=ptrGrI->planFirst(pc);idx<=ptrGrI->planLast(pc);idx++) cout<<idxs(idx)<<endl;}
+        for (int idx=ptrGrI->planFirst(pc);idx<=ptrGrI->planLast(pc);idx++){
             y = idxs(idx,1); //year index
-            if ((mnYr<=y)&&(y<=mxYr)){
-                x = idxs(idx,2); //sex index
-                for (int s=1;s<=nSCs;s++){
-                    mnGrZ_yxsz(y,x,s) = mnGrZ_cz(pc);
-                    for (int z=1;z<=nZBs;z++) prGr_yxszz(y,x,s,z) = prGr_czz(pc,z);
-                }//s
-            }
+            x = idxs(idx,2); //sex index
+            for (int s=1;s<=nSCs;s++){
+                mnGrZ_yxsz(y,x,s) = mnGrZ_cz(pc);
+                for (int z=1;z<=nZBs;z++) prGr_yxszz(y,x,s,z) = prGr_czz(pc,z);
+            }//s
         }//idx
     }
     
@@ -2568,7 +4332,7 @@ FUNCTION void calcSelectivities(int debug, ostream& cout)
     int y;
     for (int pc=1;pc<=ptrSel->nPCs;pc++){
         params.initialize();
-        ivector pids = ptrSel->getPCIDs(pc);
+        ivector& pids = ptrSel->getPCIDs(pc);
         dvector pXDs = ptrSel->getPCXDs(pc);
         //extract the number parameters
         int k=ptrSel->nIVs+1;//1st parameter variable column
@@ -2653,28 +4417,31 @@ FUNCTION void calcSelectivities(int debug, ostream& cout)
         if (debug>dbgCalcProcs) cout<<tb<<"pc = "<<pc<<tb<<"sel_cz: "<<sel_cz(pc)<<endl;
             
         //loop over model indices as defined in the index blocks
-        imatrix idxs = ptrSel->getModelIndices(pc);
-        for (int idx=idxs.indexmin();idx<=idxs.indexmax();idx++){
+        imatrix& idxs = ptrSel->planIdxs;//model indices for all pcs, clipped to model years
+        for (int idx=ptrSel->planFirst(pc);idx<=ptrSel->planLast(pc);idx++){
             y = idxs(idx,1);//year
-            if ((mnYr<=y)&&(y<=mxYr+1)){
-                paramsp = params;//set paramsp equal to base params
-                k=ptrSel->nIVs+1+6;//1st devs vector variable column
-                if (useDevsS1){
-                    if (idxDevsS1[y]){
-                        if (debug>dbgCalcProcs) cout<<tb<<idx<<tb<<y<<tb<<useDevsS1<<tb<<idxDevsS1[y]<<tb<<paramsp[1]<<tb<<devsS1(useDevsS1,idxDevsS1[y])<<endl;
-                        paramsp[1] += devsS1(useDevsS1,idxDevsS1[y]);
-                    }
+            int hasDevs = (useDevsS1&&idxDevsS1[y])||(useDevsS2&&idxDevsS2[y])||(useDevsS3&&idxDevsS3[y])||
+                          (useDevsS4&&idxDevsS4[y])||(useDevsS5&&idxDevsS5[y])||(useDevsS6&&idxDevsS6[y]);
+            if (!hasDevs){
+                //no deviations in year y: selectivity is the time-invariant curve calculated above
+                sel_cyz(pc,y) = sel_cz(pc);
+                continue;
+            }
+            paramsp = params;//set paramsp equal to base params
+            k=ptrSel->nIVs+1+6;//1st devs vector variable column
+            if (useDevsS1){
+                if (idxDevsS1[y]){
+                    if (debug>dbgCalcProcs) cout<<tb<<idx<<tb<<y<<tb<<useDevsS1<<tb<<idxDevsS1[y]<<tb<<paramsp[1]<<tb<<devsS1(useDevsS1,idxDevsS1[y])<<endl;
+                    paramsp[1] += devsS1(useDevsS1,idxDevsS1[y]);
                 }
-                if (useDevsS2) if (idxDevsS2[y]){paramsp[2] += devsS2(useDevsS2,idxDevsS2[y]);}
-                if (useDevsS3) if (idxDevsS3[y]){paramsp[3] += devsS3(useDevsS3,idxDevsS3[y]);}
-                if (useDevsS4) if (idxDevsS4[y]){paramsp[4] += devsS4(useDevsS4,idxDevsS4[y]);}
-                if (useDevsS5) if (idxDevsS5[y]){paramsp[5] += devsS5(useDevsS5,idxDevsS5[y]);}
-                if (useDevsS6) if (idxDevsS6[y]){paramsp[6] += devsS6(useDevsS6,idxDevsS6[y]);}
-                sel_cyz(pc,y) = SelFcns::calcSelFcn(idSel, zBs, paramsp, fsZ);
-                if (debug>dbgCalcProcs) cout<<tb<<"y = "<<y<<tb<<"paramsp: "<<paramsp<<tb<<"sel: "<<sel_cyz(pc,y)<<endl;
-            } else {
-                if (debug>dbgCalcProcs) cout<<tb<<"y = "<<y<<tb<<"y outside model range--skipping year!"<<endl;
             }
+            if (useDevsS2) if (idxDevsS2[y]){paramsp[2] += devsS2(useDevsS2,idxDevsS2[y]);}
+            if (useDevsS3) if (idxDevsS3[y]){paramsp[3] += devsS3(useDevsS3,idxDevsS3[y]);}
+            if (useDevsS4) if (idxDevsS4[y]){paramsp[4] += devsS4(useDevsS4,idxDevsS4[y]);}
+            if (useDevsS5) if (idxDevsS5[y]){paramsp[5] += devsS5(useDevsS5,idxDevsS5[y]);}
+            if (useDevsS6) if (idxDevsS6[y]){paramsp[6] += devsS6(useDevsS6,idxDevsS6[y]);}
+            sel_cyz(pc,y) = SelFcns::calcSelFcn(idSel, zBs, paramsp, fsZ);
+            if (debug>dbgCalcProcs) cout<<tb<<"y = "<<y<<tb<<"paramsp: "<<paramsp<<tb<<"sel: "<<sel_cyz(pc,y)<<endl;
         }//idx
     }//pc
     if (debug>dbgCalcProcs) cout<<"finished calcSelectivities()"<<endl;
@@ -2683,6 +4450,12 @@ FUNCTION void calcSelectivities(int debug, ostream& cout)
 //* Function: void calcFisheryFs(int debug, ostream& cout)
 //* 
 //* Description: Calculates fishery F's for all years.
+//*              Parameter combinations are processed in the order given by
+//*              ordFshPCs (see setupFisheryFs()): capture rates based on
+//*              parameter values first, then those based on effort and the 
+//*              average ratio of capture rate to effort (which depends on 
+//*              the former). Only cells covered by the parameter combinations
+//*              are written; the arrays are zeroed once in setupFisheryFs().
 //* 
 //* Inputs:
 //*  none
@@ -2706,16 +4479,6 @@ FUNCTION void calcFisheryFs(int debug, ostream& cout)
     dvsLnC_fy.initialize();
     for (int f=1;f<=nFsh;f++) idxDevsLnC_fy(f) = -1;
     
-    hasF_fy.initialize();   //flags indicating whether or not fishery occurs
-    hmF_fy.initialize();    //handling mortality
-    cpF_fyxms.initialize(); //fully-selected capture rate
-    sel_fyxmsz.initialize();//selectivity functions
-    ret_fyxmsz.initialize();//retention functions
-    cpF_fyxmsz.initialize();//size-specific capture rate
-    rmF_fyxmsz.initialize();//retention rate
-    dmF_fyxmsz.initialize();//discard mortality rate
-    tmF_yxmsz.initialize(); //total mortality rate
-    
     /******************************************************\n
      * Fully-selected annual capture rates are calculated  \n
      * using 2 approaches:                                 \n
@@ -2723,15 +4486,59 @@ FUNCTION void calcFisheryFs(int debug, ostream& cout)
      *  2. based on effort and the average ratio between   \n
      *     effort and capture rates over some time period  \n
      *     in the fishery        (if useER=1 below)        \n
-     * Consequently, calculating all the above quantities  \n
-     * requires 2 passes through parameter combinations.   \n
+     * Parameter combinations using approach 1 come first  \n
+     * in ordFshPCs, so the average ratios are calculated  \n
+     * once all of them have been processed.               \n
     ******************************************************/
 
     int idxER = ptrFsh->idxUseER;//index into pids below for flag to use effort ratio
     int y; int f; int x; int idSel; int idRet; int useER; int useDevs;
-    //Pass 1: calculations based on parameter values
-    for (int pc=1;pc<=ptrFsh->nPCs;pc++){
-        ivector pids = ptrFsh->getPCIDs(pc);
+    int fd; double eff;
+    for (int i=1;i<=ptrFsh->nPCs+1;i++){
+        if (i==nFshPCsP+1){//all parameter-based capture rates have been calculated
+            //calculate ratio of average capture rate to effort
+            if (debug>dbgCalcProcs) cout<<"calculating avgRatioFc2Eff"<<endl;
+            avgRatioFc2Eff.initialize();
+            for (int f=1;f<=nFsh;f++){//model fishery objects
+                int fd = mapM2DFsh(f);//index of corresponding fishery data object
+                if (ptrMDS->ppFsh[fd-1]->ptrEff){
+                    IndexRange* pir = ptrMDS->ppFsh[fd-1]->ptrEff->ptrAvgIR;
+                    int mny = max(mnYr,pir->getMin());//adjust for model min
+                    int mxy = min(mxYr,pir->getMax());//adjust for model max
+                    if (debug>dbgCalcProcs) cout<<"f,mny,mxy = "<<f<<tb<<mny<<tb<<mxy<<endl;
+                    for (int x=1;x<=nSXs;x++){
+                        for (int m=1;m<=nMSs;m++){
+                            for (int s=1;s<=nSCs;s++){
+                                switch (optsFcAvg(f)){
+                                    case 0:
+                                        //won't use effort to fill in
+                                        avgFc_fxms(f,x,m,s) = -1;
+                                    case 1:
+                                        for (int y=mny;y<=mxy;y++) cpF_fxmsy(f,x,m,s,y) = cpF_fyxms(f,y,x,m,s);
+                                        avgFc_fxms(f,x,m,s) = sum(cpF_fxmsy(f,x,m,s))/(mxy-mny+1); break;
+                                    case 2:
+                                        for (int y=mny;y<=mxy;y++) cpF_fxmsy(f,x,m,s,y) = 1.0-mfexp(-cpF_fyxms(f,y,x,m,s));
+                                        avgFc_fxms(f,x,m,s) = sum(cpF_fxmsy(f,x,m,s))/(mxy-mny+1); break;
+                                    case 3:
+                                        for (int y=mny;y<=mxy;y++) cpF_fxmsy(f,x,m,s,y) = mean(cpF_fyxmsz(f,y,x,m,s));
+                                        avgFc_fxms(f,x,m,s) = sum(cpF_fxmsy(f,x,m,s))/(mxy-mny+1); break;
+                                    default:
+                                        cout<<"optsFcAvg("<<f<<") = "<<optsFcAvg(f)<<" to calculate average Fc is invalid."<<endl;
+                                        cout<<"Aborting..."<<endl;
+                                        exit(-1);
+                                }
+                                if (optsFcAvg(f)) avgRatioFc2Eff(f,x,m,s) = avgFc_fxms(f,x,m,s)/avgEff(f);
+                            }
+                        }
+                    }
+                }
+            }
+            if (debug>dbgCalcProcs) cout<<"calculated avgRatioFc2Eff"<<endl;
+        }
+        if (i>ptrFsh->nPCs) break;
+        
+        int pc = ordFshPCs(i);
+        ivector& pids = ptrFsh->getPCIDs(pc);
         if (debug>dbgCalcProcs) cout<<"pc: "<<pc<<tb<<"pids: "<<pids<<endl;
         useER = pids[idxER];//flag to use effort ratio
         if (!useER){//calculate capture rates from parameters
@@ -2787,92 +4594,38 @@ FUNCTION void calcFisheryFs(int debug, ostream& cout)
             }
 
             //loop over model indices as defined in the index blocks
-            imatrix idxs = ptrFsh->getModelIndices(pc);
-            for (int idx=idxs.indexmin();idx<=idxs.indexmax();idx++){
+            imatrix& idxs = ptrFsh->planIdxs;//model indices for all pcs, clipped to model years
+            for (int idx=ptrFsh->planFirst(pc);idx<=ptrFsh->planLast(pc);idx++){
                 if (debug>dbgCalcProcs) cout<<"idxs(idx) = "<<idxs(idx)<<endl;
                 f = idxs(idx,1);//fishery
                 y = idxs(idx,2);//year
-                if ((mnYr<=y)&&(y<=mxYr)){
-                    hasF_fy(f,y) = 1;//flag indicating occurrence of fishery in year y
-                    hmF_fy(f,y) = hm;//save discard mortality rate
-                    x = idxs(idx,3);//sex
-                    if (debug>dbgCalcProcs) cout<<"f,y,x,useDevs = "<<f<<cc<<y<<cc<<x<<cc<<useDevs<<endl;
-                    if (useDevs) {
-                        idxDevsLnC_fy(f,y) = idxDevsLnC[y];
-                        dvsLnC_fy(f,y)     = dvsLnC[idxDevsLnC[y]];
-                        C_xm = mfexp(lnC+dvsLnC[idxDevsLnC[y]]);//recalculate C_xm w/ devs
-                        if (debug>dbgCalcProcs) cout<<lnC(MALE)<<tb<<lnC(FEMALE)<<tb<<dvsLnC[idxDevsLnC[y]]<<endl;
-                    }
-                    if (debug>dbgCalcProcs) cout<<C_xm(MALE)<<tb<<C_xm(FEMALE)<<endl;
-                    for (int m=1;m<=nMSs;m++){
-                        for (int s=1;s<=nSCs;s++){
-                            cpF_fyxms(f,y,x,m,s)  = C_xm(x,m);                 //fully-selected capture rate
-                            sel_fyxmsz(f,y,x,m,s) = sel_cyz(idSel,y);          //selectivity
-                            cpF_fyxmsz(f,y,x,m,s) = C_xm(x,m)*sel_cyz(idSel,y);//size-specific capture rate
-                            if (idRet){//fishery has retention
-                                ret_fyxmsz(f,y,x,m,s) = sel_cyz(idRet,y);      //retention curves
-                                rmF_fyxmsz(f,y,x,m,s) = elem_prod(sel_cyz(idRet,y),         cpF_fyxmsz(f,y,x,m,s));//retention mortality
-                                dmF_fyxmsz(f,y,x,m,s) = elem_prod(hm*(1.0-sel_cyz(idRet,y)),cpF_fyxmsz(f,y,x,m,s));//discard mortality
-                            } else {//discard only
-                                dmF_fyxmsz(f,y,x,m,s) = hm*cpF_fyxmsz(f,y,x,m,s);//discard mortality
-                            }
-                        }
-                    }
+                hasF_fy(f,y) = 1;//flag indicating occurrence of fishery in year y
+                hmF_fy(f,y) = hm;//save discard mortality rate
+                x = idxs(idx,3);//sex
+                if (debug>dbgCalcProcs) cout<<"f,y,x,useDevs = "<<f<<cc<<y<<cc<<x<<cc<<useDevs<<endl;
+                if (useDevs) {
+                    idxDevsLnC_fy(f,y) = idxDevsLnC[y];
+                    dvsLnC_fy(f,y)     = dvsLnC[idxDevsLnC[y]];
+                    C_xm = mfexp(lnC+dvsLnC[idxDevsLnC[y]]);//recalculate C_xm w/ devs
+                    if (debug>dbgCalcProcs) cout<<lnC(MALE)<<tb<<lnC(FEMALE)<<tb<<dvsLnC[idxDevsLnC[y]]<<endl;
                 }
-            }
-        }//useER=FALSE
-    }
-    if (debug) cout<<"finished pass 1"<<endl;
-    
-    //calculate ratio of average capture rate to effort
-    if (debug>dbgCalcProcs) cout<<"calculating avgRatioFc2Eff"<<endl;
-    dvariable tot;
-    avgRatioFc2Eff.initialize();
-    for (int f=1;f<=nFsh;f++){//model fishery objects
-        int fd = mapM2DFsh(f);//index of corresponding fishery data object
-        if (ptrMDS->ppFsh[fd-1]->ptrEff){
-            IndexRange* pir = ptrMDS->ppFsh[fd-1]->ptrEff->ptrAvgIR;
-            int mny = max(mnYr,pir->getMin());//adjust for model min
-            int mxy = min(mxYr,pir->getMax());//adjust for model max
-            if (debug>dbgCalcProcs) cout<<"f,mny,mxy = "<<f<<tb<<mny<<tb<<mxy<<endl;
-            for (int x=1;x<=nSXs;x++){
+                if (debug>dbgCalcProcs) cout<<C_xm(MALE)<<tb<<C_xm(FEMALE)<<endl;
                 for (int m=1;m<=nMSs;m++){
                     for (int s=1;s<=nSCs;s++){
-                        tot.initialize();
-                        cpF_fxmsy(f,x,m,s).deallocate();
-                        cpF_fxmsy(f,x,m,s).allocate(mny,mxy);//TODO: do this in preliminary calcs so it happens once!
-                        switch (optsFcAvg(f)){
-                            case 0:
-                                //won't use effort to fill in
-                                avgFc_fxms(f,x,m,s) = -1;
-                            case 1:
-                                for (int y=mny;y<=mxy;y++) cpF_fxmsy(f,x,m,s,y) = cpF_fyxms(f,y,x,m,s);
-                                avgFc_fxms(f,x,m,s) = sum(cpF_fxmsy(f,x,m,s))/(mxy-mny+1); break;
-                            case 2:
-                                for (int y=mny;y<=mxy;y++) cpF_fxmsy(f,x,m,s,y) = 1.0-mfexp(-cpF_fyxms(f,y,x,m,s));
-                                avgFc_fxms(f,x,m,s) = sum(cpF_fxmsy(f,x,m,s))/(mxy-mny+1); break;
-                            case 3:
-                                for (int y=mny;y<=mxy;y++) cpF_fxmsy(f,x,m,s,y) = mean(cpF_fyxmsz(f,y,x,m,s));
-                                avgFc_fxms(f,x,m,s) = sum(cpF_fxmsy(f,x,m,s))/(mxy-mny+1); break;
-                            default:
-                                cout<<"optsFcAvg("<<f<<") = "<<optsFcAvg(f)<<" to calculate average Fc is invalid."<<endl;
-                                cout<<"Aborting..."<<endl;
-                                exit(-1);
+                        cpF_fyxms(f,y,x,m,s)  = C_xm(x,m);                 //fully-selected capture rate
+                        sel_fyxmsz(f,y,x,m,s) = sel_cyz(idSel,y);          //selectivity
+                        cpF_fyxmsz(f,y,x,m,s) = C_xm(x,m)*sel_cyz(idSel,y);//size-specific capture rate
+                        if (idRet){//fishery has retention
+                            ret_fyxmsz(f,y,x,m,s) = sel_cyz(idRet,y);      //retention curves
+                            rmF_fyxmsz(f,y,x,m,s) = elem_prod(sel_cyz(idRet,y),         cpF_fyxmsz(f,y,x,m,s));//retention mortality
+                            dmF_fyxmsz(f,y,x,m,s) = elem_prod(hm*(1.0-sel_cyz(idRet,y)),cpF_fyxmsz(f,y,x,m,s));//discard mortality
+                        } else {//discard only
+                            dmF_fyxmsz(f,y,x,m,s) = hm*cpF_fyxmsz(f,y,x,m,s);//discard mortality
                         }
-                        if (optsFcAvg(f)) avgRatioFc2Eff(f,x,m,s) = avgFc_fxms(f,x,m,s)/avgEff(f);
                     }
                 }
             }
-        }
-    }
-    if (debug>dbgCalcProcs) cout<<"calculated avgRatioFc2Eff"<<endl;
-    
-    //Pass 2: calculations based on effort and average effort:capture rate ratios
-    int fd; double eff;
-    for (int pc=1;pc<=ptrFsh->nPCs;pc++){
-        ivector pids = ptrFsh->getPCIDs(pc);
-        useER = pids[idxER];//flag to use effort ratio
-        if (useER){//calculate capture rates from parameters
+        } else {//calculate capture rates from effort
             int k=ptrFsh->nIVs+1;//1st parameter variable column
             //get handling mortality (default to 1)
             hm = 1.0;
@@ -2885,47 +4638,96 @@ FUNCTION void calcFisheryFs(int debug, ostream& cout)
             if (debug>dbgCalcProcs) cout<<"pc: "<<pc<<". hm = "<<hm<<". idSel = "<<idSel<<". idRet = "<<idRet<<". Using ER"<<endl;
 
             //loop over model indices as defined in the index blocks
-            imatrix idxs = ptrFsh->getModelIndices(pc);
-            for (int idx=idxs.indexmin();idx<=idxs.indexmax();idx++){
+            imatrix& idxs = ptrFsh->planIdxs;//model indices for all pcs, clipped to model years
+            for (int idx=ptrFsh->planFirst(pc);idx<=ptrFsh->planLast(pc);idx++){
                 f = idxs(idx,1);//fishery
                 y = idxs(idx,2);//year
-                if ((mnYr<=y)&&(y<=mxYr)){
-                    x = idxs(idx,3);//sex
-                    fd = mapM2DFsh(f);//index of corresponding fishery data object
-                    eff = ptrMDS->ppFsh[fd-1]->ptrEff->eff_y(y);
-                    if (debug>dbgCalcProcs) cout<<"f, y, x, eff, avgRatFcp2E, cpF = "<<f<<tb<<y<<tb<<x<<tb<<eff<<tb;
-                    for (int m=1;m<=nMSs;m++){
-                        for (int s=1;s<=nSCs;s++){
-                            //fully-selected capture rate
-                            switch(optsFcAvg(f)) {
-                                case 0:
-                                    break; //do nothing
-                                case 1:
-                                    cpF_fyxms(f,y,x,m,s) = avgRatioFc2Eff(f,x,m,s)*eff; break;
-                                case 2:
-                                    cpF_fyxms(f,y,x,m,s) = -log(1.0-avgRatioFc2Eff(f,x,m,s)*eff); break;
-                                case 3:
-                                    cpF_fyxms(f,y,x,m,s) = avgRatioFc2Eff(f,x,m,s)*eff; break;
-                            }
-                            if (debug>dbgCalcProcs) cout<<tb<<avgRatioFc2Eff(f,x,m,s)<<cpF_fyxms(f,y,x,m,s)<<tb;
-                            if (!debug) testNaNs(value(cpF_fyxms(f,y,x,m,s)),"calcFisheryFs: 2nd pass");
-                            cpF_fyxmsz(f,y,x,m,s) = cpF_fyxms(f,y,x,m,s)*sel_cyz(idSel,y);//size-specific capture rate
-                            if (idRet){//fishery has retention
-                                rmF_fyxmsz(f,y,x,m,s) = elem_prod(sel_cyz(idRet,y),         cpF_fyxmsz(f,y,x,m,s));//retention mortality rate
-                                dmF_fyxmsz(f,y,x,m,s) = elem_prod(hm*(1.0-sel_cyz(idRet,y)),cpF_fyxmsz(f,y,x,m,s));//discard mortality rate
-                            } else {//discard only
-                                dmF_fyxmsz(f,y,x,m,s) = hm*cpF_fyxmsz(f,y,x,m,s);//discard mortality rate
-                            }
-                        }//s
-                    }//m
-                    if (debug>dbgCalcProcs) cout<<endl;
-                }
+                x = idxs(idx,3);//sex
+                fd = mapM2DFsh(f);//index of corresponding fishery data object
+                eff = ptrMDS->ppFsh[fd-1]->ptrEff->eff_y(y);
+                if (debug>dbgCalcProcs) cout<<"f, y, x, eff, avgRatFcp2E, cpF = "<<f<<tb<<y<<tb<<x<<tb<<eff<<tb;
+                for (int m=1;m<=nMSs;m++){
+                    for (int s=1;s<=nSCs;s++){
+                        //fully-selected capture rate
+                        switch(optsFcAvg(f)) {
+                            case 0:
+                                break; //do nothing
+                            case 1:
+                                cpF_fyxms(f,y,x,m,s) = avgRatioFc2Eff(f,x,m,s)*eff; break;
+                            case 2:
+                                cpF_fyxms(f,y,x,m,s) = -log(1.0-avgRatioFc2Eff(f,x,m,s)*eff); break;
+                            case 3:
+                                cpF_fyxms(f,y,x,m,s) = avgRatioFc2Eff(f,x,m,s)*eff; break;
+                        }
+                        if (debug>dbgCalcProcs) cout<<tb<<avgRatioFc2Eff(f,x,m,s)<<cpF_fyxms(f,y,x,m,s)<<tb;
+                        if (!debug) testNaNs(value(cpF_fyxms(f,y,x,m,s)),"calcFisheryFs: 2nd pass");
+                        cpF_fyxmsz(f,y,x,m,s) = cpF_fyxms(f,y,x,m,s)*sel_cyz(idSel,y);//size-specific capture rate
+                        if (idRet){//fishery has retention
+                            rmF_fyxmsz(f,y,x,m,s) = elem_prod(sel_cyz(idRet,y),         cpF_fyxmsz(f,y,x,m,s));//retention mortality rate
+                            dmF_fyxmsz(f,y,x,m,s) = elem_prod(hm*(1.0-sel_cyz(idRet,y)),cpF_fyxmsz(f,y,x,m,s));//discard mortality rate
+                        } else {//discard only
+                            dmF_fyxmsz(f,y,x,m,s) = hm*cpF_fyxmsz(f,y,x,m,s);//discard mortality rate
+                        }
+                    }//s
+                }//m
+                if (debug>dbgCalcProcs) cout<<endl;
             }
-        }//useER=TRUE
+        }//useER
     }
-    if (debug>dbgCalcProcs) cout<<"finished pass 2."<<endl;
     if (debug>dbgCalcProcs) cout<<"finished calcFisheryFs()"<<endl;
 
+//******************************************************************************
+//* Function: void setupFisheryFs(void)
+//* 
+//* Description: Determines the order in which calcFisheryFs processes the 
+//*              fishery parameter combinations, allocates the capture rate 
+//*              averaging arrays and zeroes the fishery rate arrays. Cells 
+//*              not covered by any parameter combination stay zero.
+//* 
+//* Inputs:
+//*  none
+//* Returns:
+//*  void
+//* Alters:
+//*  ordFshPCs, nFshPCsP, cpF_fxmsy, and the fishery rate arrays
+//******************************************************************************
+FUNCTION void setupFisheryFs()
+    FisheriesInfo* ptrFsh = ptrMPI->ptrFsh;
+    int idxER = ptrFsh->idxUseER;//index into pids for flag to use effort ratio
+    
+    ordFshPCs.allocate(1,ptrFsh->nPCs);
+    int i = 0;
+    for (int pc=1;pc<=ptrFsh->nPCs;pc++) if (!ptrFsh->getPCIDs(pc)[idxER]) ordFshPCs(++i) = pc;//parameter-based
+    nFshPCsP = i;
+    for (int pc=1;pc<=ptrFsh->nPCs;pc++) if ( ptrFsh->getPCIDs(pc)[idxER]) ordFshPCs(++i) = pc;//effort-based
+    
+    for (int f=1;f<=nFsh;f++){//model fishery objects
+        int fd = mapM2DFsh(f);//index of corresponding fishery data object
+        if (ptrMDS->ppFsh[fd-1]->ptrEff){
+            IndexRange* pir = ptrMDS->ppFsh[fd-1]->ptrEff->ptrAvgIR;
+            int mny = max(mnYr,pir->getMin());//adjust for model min
+            int mxy = min(mxYr,pir->getMax());//adjust for model max
+            for (int x=1;x<=nSXs;x++){
+                for (int m=1;m<=nMSs;m++){
+                    for (int s=1;s<=nSCs;s++){
+                        cpF_fxmsy(f,x,m,s).deallocate();
+                        cpF_fxmsy(f,x,m,s).allocate(mny,mxy);
+                    }
+                }
+            }
+        }
+    }
+    
+    hasF_fy.initialize();   //flags indicating whether or not fishery occurs
+    hmF_fy.initialize();    //handling mortality
+    cpF_fyxms.initialize(); //fully-selected capture rate
+    sel_fyxmsz.initialize();//selectivity functions
+    ret_fyxmsz.initialize();//retention functions
+    cpF_fyxmsz.initialize();//size-specific capture rate
+    rmF_fyxmsz.initialize();//retention rate
+    dmF_fyxmsz.initialize();//discard mortality rate
+    tmF_yxmsz.initialize(); //total mortality rate (recalculated in applyFshMort)
+    
 //******************************************************************************
 //* Function: void calcSurveyQs(int debug, ostream& cout)
 //* 
@@ -2936,8 +4738,9 @@ FUNCTION void calcFisheryFs(int debug, ostream& cout)
 //* Returns:
 //*  void
 //* Alters:
-//*  q_vyxms  - fully-selected survey/year/sex/maturity state/shell condition-specific catchability
-//*  q_vyxmsz - survey/year/sex/maturity state/shell condition/size-specific catchability
+//*  Q_cxm      - fully-selected sex/maturity state-specific catchability by parameter combination
+//*  idSelSrv_c - selectivity function id by parameter combination
+//*  pcSrv_vyx  - parameter combination by survey/year/sex
 //******************************************************************************
 FUNCTION void calcSurveyQs(int debug, ostream& cout)  
     if(debug>dbgCalcProcs) cout<<"Starting calcSurveyQs()"<<endl;
@@ -2945,16 +4748,14 @@ FUNCTION void calcSurveyQs(int debug, ostream& cout)
     SurveysInfo* ptrSrv = ptrMPI->ptrSrv;
     
     dvar_matrix lnQ(1,nSXs,1,nMSs);
-    dvar_matrix Q_xm(1,nSXs,1,nMSs);
     
-    q_vyxms.initialize();
-    q_vyxmsz.initialize();
+    Q_cxm.initialize();
+    pcSrv_vyx.initialize();
 
-    int y; int v; int x; int idSel;
+    int y; int v; int x;
     for (int pc=1;pc<=ptrSrv->nPCs;pc++){
         lnQ.initialize();
-        Q_xm.initialize();
-        ivector pids = ptrSrv->getPCIDs(pc);
+        ivector& pids = ptrSrv->getPCIDs(pc);
         int k=ptrSrv->nIVs+1;//1st parameter variable column
         //add in base (ln-scale) catchability (mature males)
         if (pids[k]) {for (int x=1;x<=nSXs;x++) lnQ(x) += pLnQ(pids[k]);}   k++;
@@ -2969,32 +4770,22 @@ FUNCTION void calcSurveyQs(int debug, ostream& cout)
             if (pids[k]) {lnQ(FEMALE,IMMATURE) += pLnDQXM(pids[k]);}            k++; 
         }
         
-        idSel = pids[k];//selectivity function id
+        idSelSrv_c(pc) = pids[k];//selectivity function id
         
         //convert from ln-scale to arithmetic scale
-        Q_xm = mfexp(lnQ);
+        Q_cxm(pc) = mfexp(lnQ);
         if (debug>dbgCalcProcs){
             cout<<"pc: "<<pc<<tb<<"lnQ:"<<endl<<lnQ<<endl;
-            cout<<"pc: "<<pc<<tb<<"Q_xm:"<<endl<<Q_xm<<endl;
+            cout<<"pc: "<<pc<<tb<<"Q_xm:"<<endl<<Q_cxm(pc)<<endl;
         }
         
         //loop over model indices as defined in the index blocks
-        imatrix idxs = ptrSrv->getModelIndices(pc);
-        for (int idx=idxs.indexmin();idx<=idxs.indexmax();idx++){
+        imatrix& idxs = ptrSrv->planIdxs;//model indices for all pcs, clipped to model years
+        for (int idx=ptrSrv->planFirst(pc);idx<=ptrSrv->planLast(pc);idx++){
             v = idxs(idx,1);//survey
             y = idxs(idx,2);//year
-            if ((mnYr<=y)&&(y<=mxYrp1)){
-                x = idxs(idx,3);//sex
-                if (y <= mxYr+1){
-                    for (int m=1;m<=nMSs;m++){
-                        for (int s=1;s<=nSCs;s++){
-                            q_vyxms(v,y,x,m,s)  = Q_xm(x,m);
-                            s_vyxmsz(v,y,x,m,s) = sel_cyz(idSel,y);
-                            q_vyxmsz(v,y,x,m,s) = Q_xm(x,m)*sel_cyz(idSel,y);
-                        }
-                    }
-                }
-            }
+            x = idxs(idx,3);//sex
+            if (y <= mxYr+1) pcSrv_vyx(v,y,x) = pc;//catchability is Q_cxm(pc,x,m)*sel_cyz(idSelSrv_c(pc),y)
         }
     }
     if (debug>dbgCalcProcs) cout<<"finished calcSurveyQs()"<<endl;
@@ -3240,20 +5031,8 @@ FUNCTION void calcNLLs_Recruitment(int debug, ostream& cout)
 FUNCTION void calcObjFun(int debug, ostream& cout)
     if ((debug>=dbgObjFun)||(debug<0)) cout<<"Starting calcObjFun"<<endl;
 
-    objFun.initialize();
-    
-    //objective function penalties
-    calcPenalties(debug,cout);
-
-    //prior likelihoods
-    calcAllPriors(debug,cout);
-
-    //recruitment component
-    calcNLLs_Recruitment(debug,cout);
-    
-    //data components
-    calcNLLs_Fisheries(debug,cout);
-    calcNLLs_Surveys(debug,cout);
+    //penalties, priors, recruitment and data components
+    calcObjFunComponents(nllsObjFun,debug,cout);
     
     if ((debug>=dbgObjFun)||(debug<0)){
         cout<<"proc call          = "<<ctrProcCalls<<endl;
@@ -3262,6 +5041,23 @@ FUNCTION void calcObjFun(int debug, ostream& cout)
         cout<<"Finished calcObjFun"<<endl<<endl;
     }
     
+//-------------------------------------------------------------------------------------
+//Calculate objective function components (penalties, priors, recruitment, fisheries, 
+//surveys; see tcsam::STR_OBJFUN_COMPS). Re-calculates objFun; used by calcObjFun.
+FUNCTION void calcObjFunComponents(dvector& nlls, int debug, ostream& cout)
+    if (!allocated(nlls)) nlls.allocate(1,tcsam::nObjFunComps);
+    objFun.initialize();
+    double prv = 0.0;
+    //objective function penalties
+    calcPenalties(debug,cout);        nlls(1) = value(objFun)-prv; prv = value(objFun);
+    //prior likelihoods
+    calcAllPriors(debug,cout);        nlls(2) = value(objFun)-prv; prv = value(objFun);
+    //recruitment component
+    calcNLLs_Recruitment(debug,cout); nlls(3) = value(objFun)-prv; prv = value(objFun);
+    //data components
+    calcNLLs_Fisheries(debug,cout);   nlls(4) = value(objFun)-prv; prv = value(objFun);
+    calcNLLs_Surveys(debug,cout);     nlls(5) = value(objFun)-prv;
+    
 //-------------------------------------------------------------------------------------
 FUNCTION void testNaNs(double v, adstring str) 
     if (isnan(v)){
@@ -4304,7 +6100,16 @@ FUNCTION void ReportToR_ModelProcesses(ostream& os, int debug, ostream& cout)
         os<<"prMolt2Mat_cz ="; wts::writeToR(os,value(prMat_cz),adstring("pc=1:"+str(npcMat)),zbDms);       os<<cc<<endl;
         os<<"sel_cz        ="; wts::writeToR(os,value(sel_cz),  adstring("pc=1:"+str(npcSel)),zbDms);       os<<cc<<endl;
         
-        os<<"M_yxmsz        =";  wts::writeToR(os,wts::value(M_yxmsz),   yDms,xDms,mDms,sDms,zbDms);  os<<cc<<endl;
+        d5_array vM_yxmsz(mnYr,mxYr,1,nSXs,1,nMSs,1,nSCs,1,nZBs);
+        for (int y=mnYr;y<=mxYr;y++){
+            for (int x=1;x<=nSXs;x++){
+                for (int m=1;m<=nMSs;m++){
+                    dvector M_z = value(getM_z(y,x,m));
+                    for (int s=1;s<=nSCs;s++) vM_yxmsz(y,x,m,s) = M_z;
+                }
+            }
+        }
+        os<<"M_yxmsz        =";  wts::writeToR(os,vM_yxmsz,              yDms,xDms,mDms,sDms,zbDms);  os<<cc<<endl;
         os<<"prMolt2Mat_yxz =";  wts::writeToR(os,     value(prMat_yxz), yDms,xDms,zbDms);            os<<cc<<endl;
         os<<"T_list=list("<<endl;
             os<<"mnZAM_cz   ="; wts::writeToR(os,value(mnGrZ_cz),adstring("pc=1:"+str(npcGr )),zbDms);       os<<cc<<endl;
@@ -4319,7 +6124,9 @@ FUNCTION void ReportToR_ModelProcesses(ostream& os, int debug, ostream& cout)
         os<<"R_list=list("<<endl;
             os<<"R_y  ="; wts::writeToR(os,value(R_y), yDms);                                os<<cc<<endl;
             os<<"R_yx ="; wts::writeToR(os,value(R_yx),yDms,xDms);                           os<<cc<<endl;
-            os<<"R_yz ="; wts::writeToR(os,value(R_yz),yDms,zbDms);                          os<<cc<<endl;
+            dmatrix vR_yz(mnYr,mxYr,1,nZBs); vR_yz.initialize();
+            for (int y=mnYr;y<=mxYr;y++) if (pcRec_y(y)) vR_yz(y) = value(R_cz(pcRec_y(y)));
+            os<<"R_yz ="; wts::writeToR(os,vR_yz,yDms,zbDms);                                os<<cc<<endl;
             os<<"Rx_c ="; wts::writeToR(os,value(Rx_c),adstring("pc=1:"+str(npcRec)));       os<<cc<<endl;
             os<<"R_cz ="; wts::writeToR(os,value(R_cz),adstring("pc=1:"+str(npcRec)),zbDms); os<<endl;
         os<<")"<<cc<<endl;
@@ -4363,10 +6170,31 @@ FUNCTION void ReportToR_ModelProcesses(ostream& os, int debug, ostream& cout)
             os<<"dmF_fyxmsz="; wts::writeToR(os,wts::value(dmF_fyxmsz),fDms,yDms,xDms,mDms,sDms,zbDms); os<<cc<<endl;
             os<<"tmF_fyxmsz="; wts::writeToR(os,            tmF_fyxmsz,fDms,yDms,xDms,mDms,sDms,zbDms); os<<endl;
         os<<")"<<cc<<endl;
+        d6_array s_vyxmsz(1,nSrv,mnYr,mxYr+1,1,nSXs,1,nMSs,1,nSCs,1,nZBs); s_vyxmsz.initialize();
+        d5_array q_vyxms(1,nSrv,mnYr,mxYr+1,1,nSXs,1,nMSs,1,nSCs);          q_vyxms.initialize();
+        d6_array q_vyxmsz(1,nSrv,mnYr,mxYr+1,1,nSXs,1,nMSs,1,nSCs,1,nZBs); q_vyxmsz.initialize();
+        for (int v=1;v<=nSrv;v++){
+            for (int y=mnYr;y<=mxYr+1;y++){
+                for (int x=1;x<=nSXs;x++){
+                    int pc = pcSrv_vyx(v,y,x);
+                    if (pc){
+                        dvector sel_z = value(sel_cyz(idSelSrv_c(pc),y));
+                        for (int m=1;m<=nMSs;m++){
+                            double Q = value(Q_cxm(pc,x,m));
+                            for (int s=1;s<=nSCs;s++){
+                                q_vyxms(v,y,x,m,s)  = Q;
+                                s_vyxmsz(v,y,x,m,s) = sel_z;
+                                q_vyxmsz(v,y,x,m,s) = Q*sel_z;
+                            }
+                        }
+                    }
+                }
+            }
+        }
         os<<"S_list=list("<<endl;
-            os<<"sel_vyxmsz="; wts::writeToR(os,wts::value(s_vyxmsz),vDms,ypDms,xDms,mDms,sDms,zbDms); os<<cc<<endl;
-            os<<"Q_vyxms   ="; wts::writeToR(os,wts::value(q_vyxms), vDms,ypDms,xDms,mDms,sDms);       os<<cc<<endl;
-            os<<"Q_vyxmsz  ="; wts::writeToR(os,wts::value(q_vyxmsz),vDms,ypDms,xDms,mDms,sDms,zbDms); os<<endl;
+            os<<"sel_vyxmsz="; wts::writeToR(os,s_vyxmsz,vDms,ypDms,xDms,mDms,sDms,zbDms); os<<cc<<endl;
+            os<<"Q_vyxms   ="; wts::writeToR(os,q_vyxms, vDms,ypDms,xDms,mDms,sDms);       os<<cc<<endl;
+            os<<"Q_vyxmsz  ="; wts::writeToR(os,q_vyxmsz,vDms,ypDms,xDms,mDms,sDms,zbDms); os<<endl;
         os<<")";
     os<<")";
     if (debug) cout<<"Finished ReportToR_ModelProcesses(...)"<<endl;
@@ -4375,6 +6203,7 @@ FUNCTION void ReportToR_ModelProcesses(ostream& os, int debug, ostream& cout)
 //Write model results to file as R list
 FUNCTION void ReportToR_ModelResults(ostream& os, int debug, ostream& cout)
     if (debug) cout<<"Starting ReportToR_ModelResults(...)"<<endl;
+    fillSurveys(0,cout);//calculate surveys in years without survey data
     
     d3_array ones(1,nSXs,1,nMSs,1,nZBs);//weighting for simple sums
     for (int x=1;x<=nSXs;x++) ones(x) = 1.0;
@@ -4383,31 +6212,48 @@ FUNCTION void ReportToR_ModelResults(ostream& os, int debug, ostream& cout)
     d5_array vn_yxmsz = wts::value(n_yxmsz);
     d4_array n_yxms   = tcsam::calcYXMSfromYXMSZ(vn_yxmsz,ones);
     d4_array b_yxms   = tcsam::calcYXMSfromYXMSZ(vn_yxmsz,ptrMDS->ptrBio->wAtZ_xmz);
+    
+    tcsam::MarginalSums mrgs;//numbers, biomass summaries in one pass over each array below
         
     //numbers, biomass captured (NOT mortality)
     d6_array vcpN_fyxmsz = wts::value(cpN_fyxmsz);
-    d5_array cpN_fyxms   = tcsam::calcIYXMSfromIYXMSZ(vcpN_fyxmsz,ones);
-    d5_array cpB_fyxms   = tcsam::calcIYXMSfromIYXMSZ(vcpN_fyxmsz,ptrMDS->ptrBio->wAtZ_xmz);
+    d5_array cpN_fyxms, cpB_fyxms;
+    mrgs.clear();
+    mrgs.add(tcsam::MarginalSums::IYXMS,cpN_fyxms);
+    mrgs.add(tcsam::MarginalSums::IYXMS,cpB_fyxms,ptrMDS->ptrBio->wAtZ_xmz);
+    mrgs.calc(vcpN_fyxmsz);
     
     //numbers, biomass discards (NOT mortality)
     d6_array vdsN_fyxmsz = wts::value(dsN_fyxmsz);
-    d5_array dsN_fyxms   = tcsam::calcIYXMSfromIYXMSZ(vdsN_fyxmsz,ones);
-    d5_array dsB_fyxms   = tcsam::calcIYXMSfromIYXMSZ(vdsN_fyxmsz,ptrMDS->ptrBio->wAtZ_xmz);
+    d5_array dsN_fyxms, dsB_fyxms;
+    mrgs.clear();
+    mrgs.add(tcsam::MarginalSums::IYXMS,dsN_fyxms);
+    mrgs.add(tcsam::MarginalSums::IYXMS,dsB_fyxms,ptrMDS->ptrBio->wAtZ_xmz);
+    mrgs.calc(vdsN_fyxmsz);
     
     //numbers, biomass retained (mortality)
     d6_array vrmN_fyxmsz = wts::value(rmN_fyxmsz);
-    d5_array rmN_fyxms   = tcsam::calcIYXMSfromIYXMSZ(vrmN_fyxmsz,ones);
-    d5_array rmB_fyxms   = tcsam::calcIYXMSfromIYXMSZ(vrmN_fyxmsz,ptrMDS->ptrBio->wAtZ_xmz);
+    d5_array rmN_fyxms, rmB_fyxms;
+    mrgs.clear();
+    mrgs.add(tcsam::MarginalSums::IYXMS,rmN_fyxms);
+    mrgs.add(tcsam::MarginalSums::IYXMS,rmB_fyxms,ptrMDS->ptrBio->wAtZ_xmz);
+    mrgs.calc(vrmN_fyxmsz);
     
     //numbers, biomass discard mortality
     d6_array vdmN_fyxmsz = wts::value(dmN_fyxmsz);
-    d5_array dmN_fyxms   = tcsam::calcIYXMSfromIYXMSZ(vdmN_fyxmsz,ones);
-    d5_array dmB_fyxms   = tcsam::calcIYXMSfromIYXMSZ(vdmN_fyxmsz,ptrMDS->ptrBio->wAtZ_xmz);
+    d5_array dmN_fyxms, dmB_fyxms;
+    mrgs.clear();
+    mrgs.add(tcsam::MarginalSums::IYXMS,dmN_fyxms);
+    mrgs.add(tcsam::MarginalSums::IYXMS,dmB_fyxms,ptrMDS->ptrBio->wAtZ_xmz);
+    mrgs.calc(vdmN_fyxmsz);
     
     //survey numbers, biomass
     d6_array vn_vyxmsz = wts::value(n_vyxmsz);
-    d5_array n_vyxms   = tcsam::calcIYXMSfromIYXMSZ(vn_vyxmsz,ones);
-    d5_array b_vyxms   = tcsam::calcIYXMSfromIYXMSZ(vn_vyxmsz,ptrMDS->ptrBio->wAtZ_xmz);
+    d5_array n_vyxms, b_vyxms;
+    mrgs.clear();
+    mrgs.add(tcsam::MarginalSums::IYXMS,n_vyxms);
+    mrgs.add(tcsam::MarginalSums::IYXMS,b_vyxms,ptrMDS->ptrBio->wAtZ_xmz);
+    mrgs.calc(vn_vyxmsz);
     
     os<<"mr=list("<<endl;
         os<<"iN_xmsz ="; wts::writeToR(os,vn_yxmsz(mnYr),xDms,mDms,sDms,zbDms); os<<cc<<endl;
@@ -4627,6 +6473,25 @@ REPORT_SECTION
         
     //write active parameters to rpt::echo
     rpt::echo<<"Finished phase "<<current_phase()<<endl;
+    if (!mceval_phase()){
+        //log function evaluations and results for phase
+        int k = current_phase();
+        int maxfn = (int) maximum_function_evaluations(min(k,maximum_function_evaluations.indexmax()));
+        ofstream osPhs("TCSAM2015.phases.csv", ios::app);
+        osPhs<<k<<cc<<countParamsInPhase(k,0)<<cc<<countParamsInPhase(k,1)<<cc<<maxfn<<cc
+             <<convergence_criteria(min(k,convergence_criteria.indexmax()))<<cc
+             <<ctrProcCallsInPhase<<cc<<value(objFun)<<cc;
+        osPhs<<objective_function_value::gmax<<cc;
+        if (ctrProcCallsInPhase>=maxfn) osPhs<<"maxfn"; else osPhs<<"converged";
+        osPhs<<cc<<((phsStalled==k) ? nEvalsStalled : 0)<<endl;
+        osPhs.close();
+    }
+    if (dirWarmStart.size()&&(!mceval_phase())){
+        //save end-of-phase parameter values to warm start cache
+        ofstream osWS((char*) getWarmStartCacheFile(current_phase()), ios::trunc);
+        writeParameterVals(osWS);
+        osWS.close();
+    }
     {
         //write objective function components only
         ofstream os0("TCSAM2015.ModelFits."+itoa(current_phase(),10)+".R", ios::trunc);
@@ -4650,6 +6515,30 @@ REPORT_SECTION
             fs<<"seed"<<cc<<"objfun"<<endl;
             fs<<iSeed<<cc<<objFun<<endl;
         }
+        
+        if (iJitterRun>0) {
+            //write results for jitter ensemble run (OFL calculated in ReportToR)
+            ofstream os4("TCSAM2015.jitter.csv", ios::trunc);
+            tcsam::writeJitterRunResults(os4,iJitterRun,iSeed,value(objFun),objective_function_value::gmax,
+                                         value(spB_yx(mxYr,MALE)),value(R_y(mxYr)),doOFL,ptrOFL->OFL);
+            os4.close();
+        }
+        
+        if (iRetroPeel>=0) {
+            //write results for retrospective peel (OFL calculated in ReportToR)
+            ofstream os3("TCSAM2015.retro.csv", ios::trunc);
+            tcsam::writeRetroPeelResults(os3,iRetroPeel,value(objFun),value(spB_yx),value(R_y),doOFL,ptrOFL->OFL);
+            os3.close();
+        }
+        
+        if (iProfilePoint>0) {
+            //write objective function components for likelihood profile point
+            //(as calculated with objFun in the last call to calcObjFun(...))
+            ofstream os5("TCSAM2015.profile.csv", ios::trunc);
+            tcsam::writeProfilePointResults(os5,iProfilePoint,gridProfile(iProfilePoint),value(objFun),
+                                            objective_function_value::gmax,nllsObjFun);
+            os5.close();
+        }
     }
     
 // =============================================================================
@@ -4657,7 +6546,9 @@ REPORT_SECTION
 BETWEEN_PHASES_SECTION
     rpt::echo<<endl<<endl<<"#---------------------"<<endl;
     rpt::echo<<"Starting phase "<<current_phase()<<" of "<<initial_params::max_number_phases<<endl;
+    if (doSmartPhases) schedulePhase(current_phase(),ctrProcCallsInPhase,rpt::echo);
     ctrProcCallsInPhase=0;//reset in-phase counter
+    invalidateMemos();    //parameters active in the phase may have changed
 
 // =============================================================================
 // =============================================================================
@@ -4673,6 +6564,16 @@ FINAL_SECTION
         mcmc.close();
     }
     
+    //free the population work states (their dvar_vectors must be 
+    //released while the gradient structure still exists)
+    if (pPopDyStates) {delete pPopDyStates; pPopDyStates = 0;}
+    //free the OFL calculator. The male PopDyInfo and CatchInfo objects are 
+    //shared with the Tier3_Calculator, so detach them from the male projector first.
+    if (ptrOFLCalc) {
+        ptrOFLCalc->pPrjM->pPI = 0; ptrOFLCalc->pPrjM->pCI = 0;
+        delete ptrOFLCalc; ptrOFLCalc = 0;
+    }
+    
     long hour,minute,second;
     double elapsed_time;
     
@@ -4686,6 +6587,9 @@ FINAL_SECTION
     cout << "Finishing time: " << ctime(&finish);
     cout << "This run took: " << hour << " hours, " << minute << " minutes, " << second << " seconds." << endl << endl;
     
+    //mark task run as completed (but not worker runs in its sub-folders)
+    if ((iTask>0)&&(iRetroPeel<0)&&(iJitterRun<0)&&(iProfilePoint<0)) tcsam::markTaskDone();
+    
 // =============================================================================
 // =============================================================================
 RUNTIME_SECTION
@@ -0,0 +1,207 @@
+/*
+ * File:   OFLCalcsBench.cpp
+ * Author: WilliamStockhausen
+ *
+ * Standalone driver to count heap allocations and time the OFL calculations
+ * in calcOFL(...) for a synthetic (but model-sized) population. Two cases
+ * are run:
+ *   1. "per-call": the PopDyInfo, CatchInfo, Tier3_Calculator, PopProjector
+ *      and OFL_Calculator objects are created on every call (as calcOFL did
+ *      before 2016-05-08, item 11)
+ *   2. "reused": the objects are created once and refilled on each call
+ *      (as calcOFL does now)
+ * Allocations are counted by replacing the global operator new/new[].
+ *
+ * Build from the repository root (set ADMB_HOME and WTSADMB_HOME), e.g.:
+ *   g++ -O3 -DOPT_LIB -I"${ADMB_HOME}/include" -I"${WTSADMB_HOME}/include" -Iinclude \
+ *       bench/OFLCalcsBench.cpp src/OFLCalcs.cpp \
+ *       -L"${WTSADMB_HOME}/lib" -lwtsadmb -L"${ADMB_HOME}/lib" -ladmbo -o OFLCalcsBench
+ * Run:
+ *   ./OFLCalcsBench [number of calls (default 100)]
+ */
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <admodel.h>
+#include <wtsADMB.hpp>
+#include "ModelConstants.hpp"
+#include "OFLCalcs.hpp"
+
+using namespace tcsam;
+
+//--allocation counter
+#if __cplusplus >= 201103L
+    #define THROW_BAD_ALLOC
+    #define NO_THROW noexcept
+#else
+    #define THROW_BAD_ALLOC throw(std::bad_alloc)
+    #define NO_THROW throw()
+#endif
+static long nAllocs = 0;
+void* operator new(size_t n) THROW_BAD_ALLOC{
+    nAllocs++;
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t n) THROW_BAD_ALLOC{
+    nAllocs++;
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) NO_THROW{std::free(p);}
+void operator delete[](void* p) NO_THROW{std::free(p);}
+
+//--model dimensions (Tanner2014-sized)
+static const int nZBs = 32;//number of size bins
+static const int nFsh = 4; //number of fisheries
+
+/**
+ * Fill the sex-specific population dynamics info for a synthetic stock.
+ */
+void fillPopDyInfo(PopDyInfo* pPI, int x){
+    pPI->T_szz.initialize();
+    for (int z=1;z<=nZBs;z++){
+        double zb = 27.5+5.0*(z-1);
+        pPI->R_z(z) = (z<=5) ? 0.2 : 0.0;
+        for (int m=1;m<=nMSs;m++) pPI->w_mz(m,z) = 1.0e-6*(x==MALE ? 0.27 : 0.44)*pow(zb,3.0);
+        for (int m=1;m<=nMSs;m++) {for (int s=1;s<=nSCs;s++) pPI->M_msz(m,s,z) = (m==MATURE) ? 0.26 : 0.23;}
+        for (int s=1;s<=nSCs;s++) pPI->Th_sz(s,z) = 1.0/(1.0+exp(-0.15*(zb-(x==MALE ? 110.0 : 75.0))));
+        //growth from z (column) to zp (row), as prGr_yxszz
+        for (int s=1;s<=nSCs;s++){
+            int zp1 = (z+1<=nZBs) ? z+1 : nZBs;
+            int zp3 = (z+3<=nZBs) ? z+3 : nZBs;
+            for (int zp=zp1;zp<=zp3;zp++) pPI->T_szz(s,zp,z) = 1.0/(zp3-zp1+1);
+        }
+    }
+}
+
+/**
+ * Fill the fishery capture rates, retention functions and handling mortality.
+ */
+void fillFisheryInfo(d5_array& capF_fxmsz, d5_array& retF_fxmsz, dvector& hm_f){
+    capF_fxmsz.initialize();
+    retF_fxmsz.initialize();
+    for (int f=1;f<=nFsh;f++){
+        hm_f(f) = (f==1) ? 0.321 : 0.8;
+        for (int x=1;x<=nSXs;x++){
+            for (int m=1;m<=nMSs;m++){
+                for (int s=1;s<=nSCs;s++){
+                    for (int z=1;z<=nZBs;z++){
+                        double zb = 27.5+5.0*(z-1);
+                        double sel = 1.0/(1.0+exp(-0.1*(zb-100.0)));
+                        capF_fxmsz(f,x,m,s,z) = ((f==1)&&(x==MALE) ? 0.5 : 0.05)*sel;
+                        if ((f==1)&&(x==MALE)) retF_fxmsz(f,x,m,s,z) = 1.0/(1.0+exp(-0.5*(zb-125.0)));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Create the OFL calculator and the objects it uses (as calcOFL does on its first call).
+ */
+OFL_Calculator* createOFLCalculator(void){
+    PopDyInfo* pPIM = new PopDyInfo(nZBs);
+    PopDyInfo* pPIF = new PopDyInfo(nZBs);
+    CatchInfo* pCIM = new CatchInfo(nZBs,nFsh);
+    CatchInfo* pCIF = new CatchInfo(nZBs,nFsh);
+    Tier3_Calculator* pT3C = new Tier3_Calculator(nZBs,nFsh);
+    pT3C->pPI = pPIM; pT3C->pCI = pCIM;
+    PopProjector* pPPM = new PopProjector(nZBs,nFsh);
+    pPPM->pPI = pPIM; pPPM->pCI = pCIM;
+    PopProjector* pPPF = new PopProjector(nZBs,nFsh);
+    pPPF->pPI = pPIF; pPPF->pCI = pCIF;
+    OFL_Calculator* pOC = new OFL_Calculator(nFsh);
+    pOC->pT3C = pT3C; pOC->pPrjM = pPPM; pOC->pPrjF = pPPF;
+    return pOC;
+}
+
+/**
+ * Delete an OFL calculator created by createOFLCalculator(). The male
+ * PopDyInfo and CatchInfo objects are shared by the Tier3_Calculator and
+ * the male PopProjector, so they are detached from the latter first.
+ */
+void deleteOFLCalculator(OFL_Calculator* pOC){
+    pOC->pPrjM->pPI = 0; pOC->pPrjM->pCI = 0;
+    delete pOC;
+}
+
+/**
+ * Refill the calculator and calculate the OFL, following calcOFL(...).
+ */
+double calcOFL(OFL_Calculator* pOC, const d4_array& n_xmsz,
+               const d5_array& capF_fxmsz, const d5_array& retF_fxmsz, const dvector& hm_f,
+               double R, ostream& cout){
+    double dtF = 0.625; double dtM = 0.63;
+    PopDyInfo* pPIM = pOC->pPrjM->pPI; PopDyInfo* pPIF = pOC->pPrjF->pPI;
+    CatchInfo* pCIM = pOC->pPrjM->pCI; CatchInfo* pCIF = pOC->pPrjF->pCI;
+    fillPopDyInfo(pPIM,MALE);
+    fillPopDyInfo(pPIF,FEMALE);
+    pCIM->setCaptureRates(MALE,capF_fxmsz);
+    pCIM->setRetentionFcns(MALE,retF_fxmsz);
+    pCIM->setHandlingMortality(hm_f);
+    double maxCapF = pCIM->findMaxTargetCaptureRate(cout);
+    pCIF->setCaptureRates(FEMALE,capF_fxmsz);
+    pCIF->setRetentionFcns(FEMALE,retF_fxmsz);
+    pCIF->setHandlingMortality(hm_f);
+    pCIF->maxF = maxCapF;
+    pOC->pT3C->dtF  = dtF; pOC->pT3C->dtM  = dtM;
+    pOC->pPrjM->dtF = dtF; pOC->pPrjM->dtM = dtM;
+    pOC->pPrjF->dtF = dtF; pOC->pPrjF->dtM = dtM;
+
+    double Bmsy = pOC->pT3C->calcBmsy(R,cout);
+    double Fmsy = pOC->pT3C->calcFmsy(R,cout);
+    double Fofl = pOC->calcFofl(Bmsy,Fmsy,n_xmsz(MALE),cout);
+    double OFL  = pOC->calcOFL(Fofl,n_xmsz,cout);
+    pOC->calcPrjMMB(Fofl,n_xmsz(MALE),cout);
+    return OFL;
+}
+
+int main(int argc, char** argv){
+    int nCalls = (argc>1) ? atoi(argv[1]) : 100;
+    double R = 100.0;//average male recruitment
+
+    d5_array capF_fxmsz(1,nFsh,1,nSXs,1,nMSs,1,nSCs,1,nZBs);
+    d5_array retF_fxmsz(1,nFsh,1,nSXs,1,nMSs,1,nSCs,1,nZBs);
+    dvector hm_f(1,nFsh);
+    fillFisheryInfo(capF_fxmsz,retF_fxmsz,hm_f);
+
+    //initial population: unfished equilibrium, both sexes
+    OFL_Calculator* pOC = createOFLCalculator();
+    fillPopDyInfo(pOC->pT3C->pPI,MALE);
+    pOC->pT3C->dtF = 0.625; pOC->pT3C->dtM = 0.63;
+    d4_array n_xmsz(1,nSXs,1,nMSs,1,nSCs,1,nZBs);
+    for (int x=1;x<=nSXs;x++) n_xmsz(x) = pOC->pT3C->calcEqNatZF0(R,cout);
+
+    //1. objects created on every call
+    double oflA = 0.0;
+    long n0 = nAllocs;
+    clock_t t0 = clock();
+    for (int i=1;i<=nCalls;i++){
+        OFL_Calculator* pOCi = createOFLCalculator();
+        oflA = calcOFL(pOCi,n_xmsz,capF_fxmsz,retF_fxmsz,hm_f,R,cout);
+        deleteOFLCalculator(pOCi);
+    }
+    clock_t t1 = clock();
+    long nA = nAllocs-n0;
+
+    //2. objects created once and reused
+    double oflB = 0.0;
+    n0 = nAllocs;
+    clock_t t2 = clock();
+    for (int i=1;i<=nCalls;i++){
+        oflB = calcOFL(pOC,n_xmsz,capF_fxmsz,retF_fxmsz,hm_f,R,cout);
+    }
+    clock_t t3 = clock();
+    long nB = nAllocs-n0;
+    deleteOFLCalculator(pOC);
+
+    cout<<"case"<<tb<<"calls"<<tb<<"allocs/call"<<tb<<"ms/call"<<tb<<"OFL"<<endl;
+    cout<<"per-call"<<tb<<nCalls<<tb<<double(nA)/nCalls<<tb<<1000.0*double(t1-t0)/CLOCKS_PER_SEC/nCalls<<tb<<oflA<<endl;
+    cout<<"reused"  <<tb<<nCalls<<tb<<double(nB)/nCalls<<tb<<1000.0*double(t3-t2)/CLOCKS_PER_SEC/nCalls<<tb<<oflB<<endl;
+    if (oflA!=oflB) {cout<<"ERROR: OFL differs between cases"<<endl; return 1;}
+    return 0;
+}
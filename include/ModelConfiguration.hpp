@@ -21,6 +21,7 @@
  * 2016-04-13: 1. Added optPenNonDecLgtPrMat to ModelOptions
  *             2. Added version strings to ModelConfiguration, ModelOptions
  *             3. Updated documentation
+ * 2016-05-08: 1. Added maxGrDZ (max growth increment for optGrowth=0) to ModelOptions
  */
 
 #ifndef MODELCONFIGURATION_HPP
@@ -186,6 +187,8 @@
         adstring_array lblsGrowthOpts;  
         /* selected option for growth calculations */
         int optGrowth;                 
+        /* max growth increment (mm) in a molt for optGrowth=0 (TCSAM2013: 45 mm, i.e. 9 5-mm bins) */
+        double maxGrDZ;
         /* labels for initial n-at-z options */
         adstring_array lblsInitNatZOpts;
         /* selected option for initial n-at-z calculations */
@@ -14,6 +14,7 @@
  * 20150417: revised STR_FIT_BY_ string values
  * 20150518: revised FIT_BY_ and STR_FIT_BY_ values
  * 20160413: added tcsam::VERSION string to indicate model version
+ * 20160508: added tcsam::nObjFunComps and tcsam::STR_OBJFUN_COMPS (objective function components)
  */
 
 #pragma once
@@ -45,6 +46,11 @@ namespace tcsam{
     /* minimum debugging level that will print debug info for prior calcs */
     const int dbgPriors = 30;
     
+    /* number of objective function components */
+    const int nObjFunComps = 5;
+    /* names of objective function components (in the order calculated) */
+    const adstring STR_OBJFUN_COMPS[nObjFunComps] = {"penalties","priors","recruitment","fisheries","surveys"};
+    
     /* Model dimension name for sex */
     const adstring STR_SEX = "SEX";
     /* Model dimension name for maturity state */
@@ -0,0 +1,71 @@
+/* 
+ * File:   ModelGrowth.hpp
+ * Author: William.Stockhausen
+ *
+ * Created on May 8, 2016
+ * 
+ * 2016-05-08: 1. Created with GrowthFcns::calcPrGrCumdGamma (optGrowth=1
+ *                growth transition matrix with analytic adjoint).
+ */
+
+#ifndef MODELGROWTH_HPP
+    #define	MODELGROWTH_HPP
+
+    #include <admodel.h>
+
+//--------------------------------------------------------------------------------
+//          GrowthFcns
+//  Encapsulates growth transition matrix functions
+//--------------------------------------------------------------------------------
+    class GrowthFcns {
+        public:
+            static int debug;
+        public:
+            /**
+             * Calculates the growth transition matrix based on the cumulative
+             * gamma distribution (optGrowth=1). Element (z,zp) is the probability
+             * of growing from pre-molt size bin z to post-molt size bin zp, 
+             * with mean post-molt size grA*zBs^grB and gamma scale grBeta.
+             * 
+             * Matrix values and their partial derivatives w.r.t. (grA, grB, grBeta)
+             * are computed in double precision; the matrix is recorded as a single 
+             * node on the gradient stack.
+             * 
+             * Inputs:
+             * @param zBs    - dvector of size bin midpoints
+             * @param zCs    - dvector of size bin cutpoints
+             * @param grA    - coefficient for mean growth (ln-scale multiplier, as in mnZ = exp(grA)*zBs^grB)
+             * @param grB    - exponent for mean growth
+             * @param grBeta - gamma scale factor
+             * 
+             * @return - growth transition matrix (rows: pre-molt z, columns: post-molt z) as dvar_matrix
+             */
+            dvar_matrix static calcPrGrCumdGamma(dvector& zBs, dvector& zCs, const prevariable& grA, const prevariable& grB, const prevariable& grBeta);
+            
+            /**
+             * Calculates the regularized lower incomplete gamma function P(a,x)
+             * and its partial derivatives w.r.t. a and x in double precision.
+             * 
+             * @param a    - shape
+             * @param x    - upper limit of integration
+             * @param dPda - (output) dP/da
+             * @param dPdx - (output) dP/dx
+             * 
+             * @return - P(a,x)
+             */
+            double static cumdGamma(double a, double x, double& dPda, double& dPdx);
+            
+            /**
+             * Calculates the digamma function in double precision.
+             */
+            double static digamma(double x);
+            
+        protected:
+            /**
+             * Adjoint for calcPrGrCumdGamma.
+             */
+            void static dfPrGrCumdGamma(void);
+    };
+    
+#endif	/* MODELGROWTH_HPP */
+
@@ -53,6 +53,7 @@
             ~NumberInfo(){delete pMPI;pMPI=0;}
             
             int      getPhase(){return phase;}
+            void     setPhase(int p){phase=p;}
             double   getPriorWgt(){return priorWgt;}
             adstring getPriorType(){return priorType;}
             double   getInitVal(){return initVal;}
@@ -39,6 +39,10 @@ class ParameterGroupInfo{
         imatrix in;//input parameter combinations matrix (all integers)
         dmatrix xd;//extra values by parameter combination as doubles
         imatrix** ppIdxs; //pointer to array of pointers to indices matrices for use via getModelIndices(pc)     
+        
+        ivector planFirst;//first row in planIdxs, by parameter combination (see compilePlan(...))
+        ivector planLast; //last row in planIdxs, by parameter combination (see compilePlan(...))
+        imatrix planIdxs; //model indices for all parameter combinations, clipped to model years
     public:
         ParameterGroupInfo();
         ~ParameterGroupInfo();
@@ -55,13 +59,22 @@ class ParameterGroupInfo{
         /*******************************************
          * get indices for parameter combination.
          * @param pc : id for desired parameter combination
+         * @return reference to row pc of the parameter combinations matrix
          ******************************************/
-        ivector getPCIDs(int pc);
+        ivector& getPCIDs(int pc);
         /*******************************************
          * get model indices for parameter combination.
          * @param pc: id for desired parameter combination
          ******************************************/
         imatrix getModelIndices(int pc);
+        /*******************************************
+         * compile the model indices for all parameter combinations into
+         * planIdxs (rows planFirst(pc):planLast(pc) for pc), keeping only
+         * rows with years in mnY:mxY.
+         * @param mnY : min model year
+         * @param mxY : max model year
+         ******************************************/
+        void compilePlan(int mnY, int mxY);
         
         virtual void read(cifstream & is);
         virtual void write(std::ostream & os);
@@ -374,6 +387,15 @@ class ModelParametersInfo{
         void read(cifstream & is);
         void write(std::ostream & os);
         void writeToR(std::ostream & os);
+        
+        BoundedNumberVectorInfo* getBoundedNumberVectorInfo(adstring name);
+        /*******************************************
+         * compile the model indices for all parameter groups 
+         * (see ParameterGroupInfo::compilePlan(...)).
+         * @param mnY : min model year
+         * @param mxY : max model year
+         ******************************************/
+        void compilePlans(int mnY, int mxY);
 
         friend cifstream& operator >>(cifstream & is, ModelParametersInfo & obj){obj.read(is); return is;}
         friend std::ostream& operator <<(std::ostream & os, ModelParametersInfo & obj){obj.write(os); return os;}
@@ -0,0 +1,100 @@
+/*
+ * File:   ModelPopState.hpp
+ * Author: William.Stockhausen
+ *
+ * Created on May 8, 2016
+ *
+ * 2016-05-08: 1. Created with tcsam::PopState and tcsam::PopStateCycle (population
+ *                state within a model year with fixed sex/maturity/shell dimensions).
+ */
+
+#ifndef MODELPOPSTATE_HPP
+    #define	MODELPOPSTATE_HPP
+
+    #include <admodel.h>
+    #include "ModelConstants.hpp"
+
+namespace tcsam {
+    /*-------------------------------------------------------\n
+     * Template class for the population numbers-at-size by
+     * sex/maturity state/shell condition within a model year.
+     *
+     * The sex/maturity/shell condition dimensions are fixed at
+     * compile time, so the state is a flat array of NX*NM*NS
+     * size vectors rather than a dvar4_array with its pointer
+     * hierarchy. Indices (x,m,s) are 1-based, as for the model
+     * arrays.
+     *-------------------------------------------------------*/
+    template<int NX, int NM, int NS>
+    class PopState{
+        public:
+            static const int nXMS = NX*NM*NS;//number of size vectors
+        private:
+            dvar_vector n[NX*NM*NS];//numbers-at-size by (x,m,s), s fastest
+        public:
+            PopState(){}
+            PopState(int zmn, int zmx){allocate(zmn,zmx);}
+            ~PopState(){}
+
+            void allocate(int zmn, int zmx){for (int i=0;i<nXMS;i++) n[i].allocate(zmn,zmx);}
+            void initialize(void){for (int i=0;i<nXMS;i++) n[i].initialize();}
+
+            dvar_vector& operator()(int x, int m, int s){return n[((x-1)*NM+(m-1))*NS+(s-1)];}
+            const dvar_vector& operator()(int x, int m, int s) const {return n[((x-1)*NM+(m-1))*NS+(s-1)];}
+
+            /* Makes this state a view on (not a copy of) the size vectors of n_xmsz. */
+            void bind(dvar4_array& n_xmsz){
+                for (int x=1;x<=NX;x++){
+                    for (int m=1;m<=NM;m++){
+                        for (int s=1;s<=NS;s++) {
+                            dvar_vector& v = (*this)(x,m,s);
+                            v.deallocate(); v.shallow_copy(n_xmsz(x,m,s));
+                        }
+                    }
+                }
+            }
+        private:
+            PopState(const PopState&);           //not copyable
+            PopState& operator=(const PopState&);//not assignable
+    };
+
+    /*-------------------------------------------------------\n
+     * Template class for stepping a PopState through the
+     * processes in a model year without allocating a new
+     * state for each step.
+     *
+     * start(n_xmsz) makes the current state a view on the
+     * numbers at the start of the year. Each process reads
+     * cur() and writes nxt(); advance() then makes nxt() the
+     * current state, alternating between two work states.
+     *-------------------------------------------------------*/
+    template<int NX, int NM, int NS>
+    class PopStateCycle{
+        private:
+            PopState<NX,NM,NS> n0;//view on numbers at start of year
+            PopState<NX,NM,NS> wA;//work state
+            PopState<NX,NM,NS> wB;//work state
+            PopState<NX,NM,NS>* pCur;
+            PopState<NX,NM,NS>* pNxt;
+        public:
+            PopStateCycle(){pCur=&n0; pNxt=&wA;}
+            PopStateCycle(int zmn, int zmx){allocate(zmn,zmx);}
+            ~PopStateCycle(){}
+
+            void allocate(int zmn, int zmx){wA.allocate(zmn,zmx); wB.allocate(zmn,zmx); pCur=&n0; pNxt=&wA;}
+            void start(dvar4_array& n_xmsz){n0.bind(n_xmsz); pCur=&n0; pNxt=&wA;}
+            PopState<NX,NM,NS>& cur(void){return *pCur;}
+            PopState<NX,NM,NS>& nxt(void){return *pNxt;}
+            void advance(void){pCur=pNxt; pNxt=(pCur==&wA) ? &wB : &wA;}
+        private:
+            PopStateCycle(const PopStateCycle&);           //not copyable
+            PopStateCycle& operator=(const PopStateCycle&);//not assignable
+    };
+
+    /* population state for the model's sex/maturity state/shell condition dimensions */
+    typedef PopState<nSXs,nMSs,nSCs>      PopState_xms;
+    typedef PopStateCycle<nSXs,nMSs,nSCs> PopStateCycle_xms;
+}
+
+#endif	/* MODELPOPSTATE_HPP */
+
@@ -0,0 +1,815 @@
+/*
+ * File:   ModelRunDrivers.hpp
+ * Author: WilliamStockhausen
+ *
+ * Created on April 25, 2016
+ *
+ * Includes:
+ *  class ParFileValues
+ *  class WorkerMonitor
+ *  class RetroPeelsResults
+ *  class JitterRunsResults
+ *  class ProfileResults
+ *  class ParameterVectorsTable
+ *  class EnvelopeCholesky
+ *  class RunManifest
+ *  tcsam functions to set up worker runs in sub-directories
+ *
+ * History:
+ * 2016-04-25: 1. Created to support in-process retrospective analysis (-retroPeels).
+ * 2016-04-26: 1. Added JitterRunsResults and concurrent worker functions to support
+ *                jitter ensembles (-jitterRuns).
+ *             2. changeToRunDirectory(...) now re-opens rpt::echo in the run directory.
+ * 2016-04-27: 1. Added ProfileResults and grid/label parsing functions to support
+ *                likelihood profiles (-profile).
+ * 2016-04-28: 1. Added ParameterVectorsTable, ParFileValues::setValues(...) and
+ *                binary table functions to support batch operating model runs (-opModBatch).
+ * 2016-04-29: 1. Added makeDirectory(...), fileExists(...) and calcSignature(...) to 
+ *                support per-phase warm start caches (-warmStart).
+ * 2016-05-01: 1. Added writeBinaryTable(...) and readBinaryRows(...) to support
+ *                parallel Hessian calculations (-parHess).
+ * 2016-05-02: 1. Added EnvelopeCholesky to calculate variances from sparse Hessians.
+ * 2016-05-03: 1. Added getWallTime() to support per-evaluation traces (-trace).
+ * 2016-05-04: 1. Added RunManifest and command line/task functions to support
+ *                job-array runs from a manifest (-manifest, -task).
+ * 2016-05-08: 1. Added WorkerMonitor and runWorkers(...) to run the worker processes
+ *                for all driver modes and check their exit status. JitterRunsResults
+ *                is now a WorkerMonitor (to stop an ensemble early). Removed forkAndWait(...).
+ *             2. EnvelopeCholesky now takes its envelope from the caller (from the
+ *                model structure) and is filled element by element, rather than 
+ *                finding the envelope from zeros in a dense Hessian.
+ *             3. Added readBinaryRow(...).
+ *             4. Moved the number and names of the objective function components
+ *                from ProfileResults to ModelConstants.hpp (tcsam::nObjFunComps,
+ *                tcsam::STR_OBJFUN_COMPS).
+ *             5. Added exitDriver(...) to mark a task done only if all of its workers succeeded.
+ */
+
+#ifndef MODELRUNDRIVERS_HPP
+#define	MODELRUNDRIVERS_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include <admodel.h>
+#include "ModelConfiguration.hpp"
+
+/**
+ * Class to read parameter values from an ADMB par file so they can be used
+ * to (warm) start a model run with a different parameter structure
+ * (e.g., a retrospective peel with shorter devs vectors).
+ */
+class ParFileValues {
+    public:
+        /* flag to print debugging info */
+        static int debug;
+    public:
+        /* objective function value reported in the par file header */
+        double objFun;
+        /* max gradient reported in the par file header */
+        double maxGrad;
+    protected:
+        /* map from parameter label (as written in par file) to values */
+        std::map<std::string,dvector> values;
+    public:
+        /**
+         * Class constructor.
+         */
+        ParFileValues();
+        /**
+         * Class destructor.
+         */
+        ~ParFileValues(){}
+        /**
+         * Read values from an ADMB par file.
+         *
+         * @param fn - name of par file
+         *
+         * @return 1 if file was read, 0 otherwise
+         */
+        int read(adstring fn);
+        /**
+         * Test whether values exist for the parameter with the given label.
+         *
+         * @param lbl - parameter label (e.g., "pLnR[1]" or "pDevsLnR[2]")
+         *
+         * @return 1 if values exist, 0 otherwise
+         */
+        int hasValues(adstring lbl);
+        /**
+         * Get the values for the parameter with the given label.
+         * Returned dvector has indices starting at 1.
+         *
+         * @param lbl - parameter label
+         *
+         * @return dvector of values
+         */
+        dvector getValues(adstring lbl);
+        /**
+         * Get the value for the i-th element of a parameter number vector.
+         * Labels of the form "lbl[i]" are checked first, then the i-th value
+         * for "lbl".
+         *
+         * @param lbl - parameter vector label
+         * @param i - element index
+         * @param val - (output) value
+         *
+         * @return 1 if a value was found, 0 otherwise
+         */
+        int getValue(adstring lbl, int i, double& val);
+        /**
+         * Set values from a flattened vector of parameter values, replacing
+         * any existing values. Consecutive repeated labels are collected
+         * into a single vector (e.g., elements of "pDevsLnR[1]").
+         *
+         * @param lbls - labels for the values
+         * @param vals - values (indices starting at 1)
+         */
+        void setValues(const std::vector<std::string>& lbls, const dvector& vals);
+};
+
+/**
+ * Class to read a table of parameter vectors (e.g., posterior draws or a
+ * design grid) for batch operating model runs.
+ *
+ * The file has a header line with par file labels for each column (labels
+ * for vector parameters are repeated for each element, e.g. "pDevsLnR[1]"),
+ * followed by one line of values per parameter vector. Values may be
+ * separated by commas or whitespace. Lines starting with '#' are ignored.
+ */
+class ParameterVectorsTable {
+    public:
+        /* flag to print debugging info */
+        static int debug;
+    public:
+        /* number of parameter vectors (rows) */
+        int nRows;
+        /* column labels */
+        std::vector<std::string> lbls;
+        /* parameter values by row, column */
+        dmatrix vals;
+    public:
+        /**
+         * Class constructor.
+         */
+        ParameterVectorsTable(){nRows = 0;}
+        /**
+         * Class destructor.
+         */
+        ~ParameterVectorsTable(){}
+        /**
+         * Read the table from a file.
+         *
+         * @param fn - name of file
+         *
+         * @return 1 if successful, 0 otherwise
+         */
+        int read(adstring fn);
+        /**
+         * Copy the values for a row into a ParFileValues object.
+         *
+         * @param r - row
+         * @param pfv - ParFileValues object to copy values into
+         */
+        void getRow(int r, ParFileValues& pfv);
+};
+
+/**
+ * Class to collect results from a set of retrospective peels and
+ * calculate Mohn's rho for each quantity.
+ */
+class RetroPeelsResults {
+    public:
+        /* flag to print debugging info */
+        static int debug;
+    public:
+        /* number of peels (not including the base run) */
+        int nPeels;
+        /* min model year */
+        int mnYr;
+        /* max model year for the base run (peel 0) */
+        int mxYr;
+        /* flags indicating peel results were read successfully */
+        ivector hasPeel;
+        /* mature male biomass at mating time by peel, year */
+        dmatrix mmb_py;
+        /* mature female biomass at mating time by peel, year */
+        dmatrix mfb_py;
+        /* total recruitment by peel, year */
+        dmatrix R_py;
+        /* OFL by peel */
+        dvector ofl_p;
+        /* objective function value by peel */
+        dvector objFun_p;
+    public:
+        /**
+         * Class constructor.
+         *
+         * @param npPeels - number of peels (excluding peel 0)
+         * @param mny - min model year
+         * @param mxy - max model year for peel 0
+         */
+        RetroPeelsResults(int npPeels, int mny, int mxy);
+        /**
+         * Class destructor.
+         */
+        ~RetroPeelsResults(){}
+        /**
+         * Read results for a single peel from a csv file written by
+         * tcsam::writeRetroPeelResults(...).
+         *
+         * @param p - peel
+         * @param fn - name of csv file
+         *
+         * @return 1 if successful, 0 otherwise
+         */
+        int readPeel(int p, adstring fn);
+        /**
+         * Calculate Mohn's rho for a quantity by peel and year,
+         * using the terminal year of each peel relative to peel 0.
+         *
+         * @param v_py - dmatrix with values by peel, year
+         *
+         * @return Mohn's rho
+         */
+        double calcMohnsRho(dmatrix& v_py);
+        /**
+         * Calculate Mohn's rho for a quantity with a single value per peel.
+         *
+         * @param v_p - dvector with values by peel
+         *
+         * @return Mohn's rho
+         */
+        double calcMohnsRho(dvector& v_p);
+        /**
+         * Write all peel results and Mohn's rho values to an output
+         * stream in csv format.
+         *
+         * @param os - output stream
+         */
+        void writeToCSV(ostream& os);
+};
+
+/**
+ * Interface for a driver to follow its worker runs as they finish
+ * (see tcsam::runWorkers(...)).
+ */
+class WorkerMonitor {
+    public:
+        virtual ~WorkerMonitor(){}
+        /**
+         * Called in the driver process when a worker run finishes.
+         *
+         * @param r - run
+         * @param status - exit status of the run (0 if successful)
+         *
+         * @return 1 to stop the remaining runs, 0 to continue
+         */
+        virtual int finished(int r, int status)=0;
+};
+
+/**
+ * Class to collect results from an ensemble of jittered model runs.
+ */
+class JitterRunsResults : public WorkerMonitor {
+    public:
+        /* flag to print debugging info */
+        static int debug;
+    public:
+        /* number of jitter runs */
+        int nRuns;
+        /* number of runs converged to the best at which to stop the ensemble (0 = never) */
+        int nStop;
+        /* tolerance on objective function for a run to be converged to the best run */
+        double tol;
+        /* flags indicating run results were read successfully */
+        ivector done;
+        /* rng seed by run */
+        ivector seed;
+        /* objective function value by run */
+        dvector objFun;
+        /* max gradient by run */
+        dvector maxGrad;
+        /* final year mature male biomass by run */
+        dvector mmb;
+        /* final year recruitment by run */
+        dvector R;
+        /* flags indicating OFL was calculated, by run */
+        ivector hasOFL;
+        /* OFL by run */
+        dvector ofl;
+    public:
+        /**
+         * Class constructor.
+         *
+         * @param npRuns - number of jitter runs
+         * @param pTol - tolerance on objective function for convergence to best run
+         */
+        JitterRunsResults(int npRuns, double pTol);
+        /**
+         * Class destructor.
+         */
+        ~JitterRunsResults(){}
+        /**
+         * Read results for a single run from a csv file written by
+         * tcsam::writeJitterRunResults(...).
+         *
+         * @param r - run
+         * @param fn - name of csv file
+         *
+         * @return 1 if successful, 0 otherwise
+         */
+        int readRun(int r, adstring fn);
+        /**
+         * Read the results for a finished run from its sub-folder (jitter.r) and 
+         * test whether nStop runs have converged to the best run.
+         *
+         * @param r - run
+         * @param status - exit status of the run (results are read only if 0)
+         *
+         * @return 1 to stop the remaining runs, 0 to continue
+         */
+        int finished(int r, int status);
+        /**
+         * Get the index of the finished run with the smallest objective function value.
+         *
+         * @return run index (0 if no runs have finished)
+         */
+        int getBestRun(void);
+        /**
+         * Get the number of finished runs with objective function values
+         * within tol of the best run.
+         *
+         * @return number of converged runs
+         */
+        int getNumConverged(void);
+        /**
+         * Write results for all finished runs to an output stream in csv format.
+         *
+         * @param os - output stream
+         */
+        void writeToCSV(ostream& os);
+};
+
+/**
+ * Class to collect results from a likelihood profile over a single parameter.
+ */
+class ProfileResults {
+    public:
+        /* flag to print debugging info */
+        static int debug;
+    public:
+        /* label of profiled parameter (e.g., "pLnM[1]") */
+        adstring lbl;
+        /* number of grid points */
+        int nPoints;
+        /* profiled parameter values */
+        dvector grid;
+        /* flags indicating point results were read successfully */
+        ivector done;
+        /* objective function value by point */
+        dvector objFun;
+        /* max gradient by point */
+        dvector maxGrad;
+        /* objective function components by point */
+        dmatrix nll_kc;
+    public:
+        /**
+         * Class constructor.
+         *
+         * @param plbl - label of profiled parameter
+         * @param pGrid - profiled parameter values
+         */
+        ProfileResults(adstring plbl, const dvector& pGrid);
+        /**
+         * Class destructor.
+         */
+        ~ProfileResults(){}
+        /**
+         * Read results for a single grid point from a csv file written by
+         * tcsam::writeProfilePointResults(...).
+         *
+         * @param k - grid point
+         * @param fn - name of csv file
+         *
+         * @return 1 if successful, 0 otherwise
+         */
+        int readPoint(int k, adstring fn);
+        /**
+         * Write results for all finished grid points to an output stream
+         * in csv format, including differences from the minimum objective
+         * function value for each component.
+         *
+         * @param os - output stream
+         */
+        void writeToCSV(ostream& os);
+};
+
+/**
+ * Class to calculate variances of linear combinations of parameters
+ * (i.e., b'inv(H)b, as in the delta method) using a Cholesky 
+ * factorization of the Hessian H in envelope (skyline) storage.
+ * 
+ * Row i of H is stored from column first(i) to the diagonal, where the
+ * envelope (first) is given by the caller from the structure of the 
+ * model (elements to the left of the envelope must be structurally zero).
+ * Only elements inside the envelope are stored: the Hessian is added
+ * element by element (see add(...)) and factored in place. Fill-in from
+ * the factorization is confined to the envelope.
+ */
+class EnvelopeCholesky {
+    public:
+        /* flag to print debugging info */
+        static int debug;
+    public:
+        /* number of rows/columns */
+        int n;
+        /* index of first element in envelope, by row */
+        ivector first;
+        /* lower triangle of H (ragged rows first(i):i), replaced by its Cholesky factor by factor() */
+        dmatrix L;
+    public:
+        /**
+         * Class constructor. Allocates the envelope (initialized to zero).
+         *
+         * @param first - index of the first element in the envelope, by row
+         * (indices starting at 1, first(i)<=i)
+         */
+        EnvelopeCholesky(const ivector& first);
+        /**
+         * Class destructor.
+         */
+        ~EnvelopeCholesky(){}
+        /**
+         * Test whether H(i,j) (or H(j,i)) is inside the envelope.
+         *
+         * @param i - row index
+         * @param j - column index
+         *
+         * @return 1 if inside, 0 otherwise
+         */
+        int inEnvelope(int i, int j){return (i>=j) ? (j>=first(i)) : (i>=first(j));}
+        /**
+         * Add v to H(i,j) (stored as H(max(i,j),min(i,j))) if it is inside the
+         * envelope. Must be called before factor().
+         *
+         * @param i - row index
+         * @param j - column index
+         * @param v - value to add
+         *
+         * @return 1 if inside the envelope, 0 otherwise (v is ignored)
+         */
+        int add(int i, int j, double v);
+        /**
+         * Get diagonal element H(i,i) (before factor() is called).
+         *
+         * @param i - index
+         *
+         * @return H(i,i)
+         */
+        double getDiagonal(int i){return L(i,i);}
+        /**
+         * Factor H in place (fill-in is confined to the envelope).
+         *
+         * @return 1 if successful (i.e., H is positive definite), 0 otherwise
+         */
+        int factor(void);
+        /**
+         * Test whether the factorization succeeded (i.e., H is positive definite).
+         *
+         * @return 1 if successful, 0 otherwise
+         */
+        int isOK(void){return ok;}
+        /**
+         * Get the fraction of the lower triangle of H stored in the envelope.
+         *
+         * @return envelope fraction
+         */
+        double getEnvelopeFraction(void);
+        /**
+         * Calculate b'inv(H)b by solving L z = b (so b'inv(H)b = z'z). Leading
+         * zeros in b are skipped.
+         *
+         * @param b - vector (indices starting at 1)
+         *
+         * @return b'inv(H)b
+         */
+        double calcQuadForm(const dvector& b);
+    protected:
+        /* flag indicating factorization succeeded */
+        int ok;
+};
+
+/**
+ * Class to read a run manifest for job-array runs (-manifest, -task).
+ * 
+ * Each line that is not blank and does not start with '#' defines a task
+ * as a task name (used to name the task's output folder) followed by the
+ * command line options for the task (e.g., "retro3 -retro 3 -nohess").
+ */
+class RunManifest {
+    public:
+        /* flag to print debugging info */
+        static int debug;
+    public:
+        /* number of tasks */
+        int nTasks;
+        /* task names */
+        std::vector<std::string> names;
+        /* command line options, by task */
+        std::vector<std::vector<std::string> > opts;
+    public:
+        /**
+         * Class constructor.
+         */
+        RunManifest(){nTasks = 0;}
+        /**
+         * Class destructor.
+         */
+        ~RunManifest(){}
+        /**
+         * Read the manifest from a file.
+         *
+         * @param fn - name of file
+         *
+         * @return 1 if successful, 0 otherwise
+         */
+        int read(adstring fn);
+        /**
+         * Get the name of a task.
+         *
+         * @param i - task (1:nTasks)
+         *
+         * @return task name
+         */
+        adstring getTaskName(int i){return adstring(names[i-1].c_str());}
+        /**
+         * Get the command line options for a task.
+         *
+         * @param i - task (1:nTasks)
+         *
+         * @return vector of command line options
+         */
+        const std::vector<std::string>& getTaskOptions(int i){return opts[i-1];}
+};
+
+namespace tcsam {
+    /**
+     * Makes a filename relative to directory 'dir' (e.g., "..") if it is not
+     * an absolute path.
+     *
+     * @param dir - directory to rebase to
+     * @param fn - filename
+     *
+     * @return rebased filename
+     */
+    adstring rebaseFilePath(adstring dir, adstring fn);
+    /**
+     * Creates a directory (if it doesn't exist).
+     *
+     * @param dir - name of directory
+     *
+     * @return 1 if the directory exists after the call, 0 otherwise
+     */
+    int makeDirectory(adstring dir);
+    /**
+     * Tests whether a file exists (and can be opened for reading).
+     *
+     * @param fn - name of file
+     *
+     * @return 1 if the file exists, 0 otherwise
+     */
+    int fileExists(adstring fn);
+    /**
+     * Calculates a short signature (64-bit FNV-1a hash, as a hex string)
+     * for a string (e.g., a description of the parameter structure).
+     *
+     * @param str - string to calculate signature for
+     *
+     * @return signature as 16-character hex string
+     */
+    adstring calcSignature(const std::string& str);
+    /**
+     * Gets the current wall-clock time, in seconds (with sub-second resolution).
+     *
+     * @return wall-clock time in seconds since an arbitrary origin
+     */
+    double getWallTime(void);
+    /**
+     * Appends options to the command line (ad_comm::argc, ad_comm::argv)
+     * so they are found by subsequent calls to option_match(...).
+     *
+     * @param opts - vector of options to append
+     */
+    void appendCommandLineOptions(const std::vector<std::string>& opts);
+    /**
+     * Rebases the filename following a command line option (if the option
+     * is present) relative to directory 'dir' (see rebaseFilePath(...)).
+     *
+     * @param opt - command line option (e.g., "-ainp")
+     * @param dir - directory to rebase to
+     *
+     * @return 1 if the option was found, 0 otherwise
+     */
+    int rebaseCommandLineOption(adstring opt, adstring dir);
+    /**
+     * Marks the task run in the current working directory as completed
+     * by writing the file TCSAM2015.task.done.
+     */
+    void markTaskDone(void);
+    /**
+     * Exits a driver process (-retroPeels, -jitterRuns, -profile, -parHess,
+     * -opModBatch) after it has written its results. If the process runs a
+     * manifest task (iTask>0), the task is marked as completed only if every 
+     * worker was successful, so a re-submitted task is run again.
+     *
+     * @param iTask - manifest task being run (<=0 if none)
+     * @param res - result from runWorkers(...) in the driver (0 if every worker was successful)
+     *
+     * does not return (exits with status 0 if res==0, 1 otherwise)
+     */
+    void exitDriver(int iTask, int res);
+    /**
+     * Tests whether the task run in directory 'dir' has been completed.
+     *
+     * @param dir - task directory
+     *
+     * @return 1 if the task was completed, 0 otherwise
+     */
+    int isTaskDone(adstring dir);
+    /**
+     * Creates a sub-directory for a worker run (if it doesn't exist) and
+     * changes the working directory to it. The input filenames in the
+     * ModelConfiguration object are rebased so they can still be read.
+     *
+     * @param dir - name of sub-directory
+     * @param ptrMC - pointer to ModelConfiguration object
+     *
+     * @return 1 if successful, 0 otherwise
+     */
+    int changeToRunDirectory(adstring dir, ModelConfiguration* ptrMC);
+    /**
+     * Forks a worker process without waiting for it to finish.
+     *
+     * @return 0 in the worker process, the worker's process id in the
+     * parent, -1 if the fork failed
+     */
+    int forkWorker(void);
+    /**
+     * Waits for any worker process to finish.
+     *
+     * @param status - (output) exit status of the finished worker
+     *
+     * @return process id of the finished worker (<=0 if there are no workers)
+     */
+    int waitForWorker(int& status);
+    /**
+     * Terminates a worker process.
+     *
+     * @param pid - process id of the worker
+     */
+    void killWorker(int pid);
+    /**
+     * Runs r1:r2 in forked worker processes, at most nConcurrent at a time,
+     * starting them in order. In the driver, waits for every worker and 
+     * records its exit status. If pWM is given, it is notified as each run
+     * finishes and can stop the remaining runs (running workers are 
+     * terminated). If a fork fails, no further runs are started and the 
+     * running workers are terminated.
+     *
+     * @param r1 - first run
+     * @param r2 - last run
+     * @param nConcurrent - maximum number of concurrent workers (1 runs them sequentially)
+     * @param lbl - label for a run in progress messages (e.g., "jitter run")
+     * @param r - (output) run to do in a worker process (r1-1 in the driver)
+     * @param status_r - (output) exit status by run (driver only): 0 if successful,
+     *      >0 if the run exited with an error, -1 if it terminated abnormally,
+     *      -2 if it was stopped (or never started)
+     * @param pWM - pointer to a WorkerMonitor (may be 0)
+     *
+     * @return 1 in a worker process, 0 in the driver if every run that was not 
+     * stopped was successful, -1 in the driver otherwise (or if a fork failed)
+     */
+    int runWorkers(int r1, int r2, int nConcurrent, adstring lbl, int& r, ivector& status_r, WorkerMonitor* pWM=0);
+    /**
+     * Write single-peel retrospective results to csv file for
+     * later aggregation by RetroPeelsResults.
+     *
+     * @param os - output stream
+     * @param peel - retrospective peel
+     * @param objFun - objective function value
+     * @param spB_yx - mature biomass at mating time, by year and sex
+     * @param R_y - total recruitment, by year
+     * @param doOFL - flag indicating OFL was calculated
+     * @param OFL - OFL value
+     */
+    void writeRetroPeelResults(ostream& os, int peel, double objFun,
+                               const dmatrix& spB_yx, const dvector& R_y,
+                               int doOFL, double OFL);
+    /**
+     * Write results for a single jitter run to csv file for later
+     * aggregation by JitterRunsResults.
+     *
+     * @param os - output stream
+     * @param run - jitter run
+     * @param seed - rng seed used for jittering
+     * @param objFun - objective function value
+     * @param maxGrad - max gradient
+     * @param mmb - final year mature male biomass
+     * @param R - final year recruitment
+     * @param doOFL - flag indicating OFL was calculated
+     * @param OFL - OFL value (written as NA if not calculated)
+     */
+    void writeJitterRunResults(ostream& os, int run, int seed, double objFun, double maxGrad,
+                               double mmb, double R, int doOFL, double OFL);
+    /**
+     * Parse a parameter label of the form "name[i]" (or "name", for i=1).
+     *
+     * @param lbl - parameter label
+     * @param name - (output) parameter name
+     * @param idx - (output) element index
+     *
+     * @return 1 if successful, 0 otherwise
+     */
+    int parseParameterLabel(adstring lbl, adstring& name, int& idx);
+    /**
+     * Parse a grid of values specified as "min:max:n" (n equally-spaced
+     * values) or as a comma-separated list.
+     *
+     * @param str - grid specification
+     *
+     * @return dvector of grid values (indices starting at 1, empty on error)
+     */
+    dvector parseGrid(adstring str);
+    /**
+     * Write results for a single likelihood profile point to csv file
+     * for later aggregation by ProfileResults.
+     *
+     * @param os - output stream
+     * @param k - grid point
+     * @param val - profiled parameter value
+     * @param objFun - objective function value
+     * @param maxGrad - max gradient
+     * @param nlls - objective function components (see tcsam::STR_OBJFUN_COMPS)
+     */
+    void writeProfilePointResults(ostream& os, int k, double val, double objFun, double maxGrad,
+                                  const dvector& nlls);
+    /**
+     * Write a row of values to a binary output stream as doubles.
+     *
+     * @param os - output stream (opened in binary mode)
+     * @param row - values to write
+     */
+    void writeBinaryRow(ostream& os, const dvector& row);
+    /**
+     * Merge binary files with rows of doubles written by worker processes
+     * (named fn.1, fn.2, ..., fn.nParts) into a single binary table. The
+     * table starts with the number of rows and columns (as 32-bit ints),
+     * followed by the values (as doubles) in row-major order. The part
+     * files are checked first and removed only on success; on failure,
+     * no table file is left behind.
+     *
+     * @param fn - name of binary table file
+     * @param nParts - number of part files
+     * @param nRows - total number of rows
+     * @param nCols - number of columns
+     *
+     * @return 1 if successful, 0 otherwise
+     */
+    int mergeBinaryTables(adstring fn, int nParts, int nRows, int nCols);
+    /**
+     * Write a dmatrix to a binary table file. The table starts with the 
+     * number of rows and columns (as 32-bit ints), followed by the values 
+     * (as doubles) in row-major order.
+     *
+     * @param fn - name of binary table file
+     * @param m - dmatrix to write
+     *
+     * @return 1 if successful, 0 otherwise
+     */
+    int writeBinaryTable(adstring fn, const dmatrix& m);
+    /**
+     * Read all complete rows of nCols doubles (written using writeBinaryRow(...))
+     * from a binary file.
+     *
+     * @param fn - name of binary file
+     * @param nCols - number of values in each row
+     * @param nRows - (output) number of rows read
+     *
+     * @return dmatrix with rows 1:nRows and columns 1:nCols (unallocated if nRows=0)
+     */
+    dmatrix readBinaryRows(adstring fn, int nCols, int& nRows);
+    /**
+     * Read the next row of doubles (written using writeBinaryRow(...))
+     * from a binary input stream.
+     *
+     * @param is - input stream (opened in binary mode)
+     * @param row - (output) vector to fill (its size is the number of values read)
+     *
+     * @return 1 if a complete row was read, 0 otherwise
+     */
+    int readBinaryRow(istream& is, dvector& row);
+}
+
+#endif	/* MODELRUNDRIVERS_HPP */
+
@@ -6,6 +6,9 @@
  * 
  * 2014-12-05: 1. Added asclogisticLn50Ln95 and dbllogisticLn50Ln95 functions
  * 2015-04-17: 1. Added dbllogistic50Ln95 function
+ * 2016-05-08: 1. Logistic-type functions now evaluate double-valued kernels with
+ *                analytic parameter derivatives and record each curve as a
+ *                single node on the gradient stack (assembleSelFcn/dfSelFcn).
  */
 
 #ifndef MODELSELECTIVITIES_HPP
@@ -40,6 +43,31 @@
             
             dvar_vector static calcSelFcn(int id, dvector& z, dvar_vector& params, double fsZ);
             
+        protected:
+            /**
+             * Returns z extended by one element holding fsZ (if fsZ>0).
+             */
+            dvector static extendZ(dvector& z, double fsZ);
+            /**
+             * Evaluates the ascending logistic kernel and its partial 
+             * derivatives w.r.t. (z50,slope) in double precision.
+             */
+            void static kerLogistic(dvector& z, double a, double b, dvector& r, dmatrix& drdq);
+            /**
+             * Evaluates the double logistic kernel and its partial 
+             * derivatives w.r.t. (z50a,slopea,z50d,sloped) in double precision.
+             */
+            void static kerDblLogistic(dvector& z, double a, double ba, double d, double bd, dvector& r, dmatrix& drdq);
+            /**
+             * Normalizes kernel values and records the selectivity curve 
+             * as a single node on the gradient stack.
+             */
+            dvar_vector static assembleSelFcn(int mn, int mx, double fsZ, dvector& r, dmatrix& drdp, dvar_vector& params);
+            /**
+             * Adjoint for assembleSelFcn.
+             */
+            void static dfSelFcn(void);
+            
         public:
             const static int ID_ASCLOGISTIC        =1; const static adstring STR_ASCLOGISTIC; 
             const static int ID_ASCLOGISTIC5095    =2; const static adstring STR_ASCLOGISTIC5095; 
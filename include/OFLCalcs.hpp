@@ -44,7 +44,7 @@ class PopDyInfo {
          * 
          * @return mature biomass (units??)
          */
-        double calcMatureBiomass(d3_array& n_msz, ostream& cout);
+        double calcMatureBiomass(const d3_array& n_msz, ostream& cout);
         /**
          * Calculate total single-sex biomass, given population abundance.
          * 
@@ -53,7 +53,7 @@ class PopDyInfo {
          * 
          * @return total biomass (units??)
          */
-        double calcTotalBiomass(d3_array& n_msz, ostream& cout);
+        double calcTotalBiomass(const d3_array& n_msz, ostream& cout);
         /**
          * Calculate single-sex survival probabilities, given natural mortality rates,
          * over a given period of time (dt)
@@ -64,6 +64,14 @@ class PopDyInfo {
          * @return d3_array S_msz
          */
         d3_array calcSurvival(double dt, ostream& cout);
+        /**
+         * Calculate single-sex survival probabilities over dt into S_msz.
+         * 
+         * @param S_msz - (output) survival probabilities (allocated by caller)
+         * @param dt - period of time (in years)
+         * @param cout - stream for writing debug info
+         */
+        void calcSurvivalInto(d3_array& S_msz, double dt, ostream& cout);
         /**
          * Calculate effects of natural mortality on population abundance.
          * 
@@ -73,7 +81,17 @@ class PopDyInfo {
          * 
          * @return final population abundance (after applying natural mortality)
          */
-        d3_array applyNM(double dt, d3_array& n_msz, ostream& cout);
+        d3_array applyNM(double dt, const d3_array& n_msz, ostream& cout);
+        /**
+         * Calculate effects of natural mortality on population abundance into np_msz.
+         * np_msz may be the same array as n_msz.
+         * 
+         * @param np_msz - (output) final population abundance (allocated by caller)
+         * @param dt - time interval (fraction of year)
+         * @param n_msz - initial population abundance
+         * @param cout - stream for writing debug info
+         */
+        void applyNMInto(d3_array& np_msz, double dt, const d3_array& n_msz, ostream& cout);
         /**
          * Calculate effects of molting/growth on population abundance.
          * 
@@ -82,7 +100,16 @@ class PopDyInfo {
          * 
          * @return final population abundance (after applying molting/growth)
          */
-        d3_array applyMG(d3_array& n_msz, ostream& cout);
+        d3_array applyMG(const d3_array& n_msz, ostream& cout);
+        /**
+         * Calculate effects of molting/growth on population abundance into np_msz.
+         * np_msz must not be the same array as n_msz.
+         * 
+         * @param np_msz - (output) final population abundance (allocated by caller)
+         * @param n_msz - initial population abundance
+         * @param cout - stream for writing debug info
+         */
+        void applyMGInto(d3_array& np_msz, const d3_array& n_msz, ostream& cout);
 };//PopDyInfo
 
 /**
@@ -107,6 +134,9 @@ class CatchInfo {
         d4_array rm_fmsz;//retained mortality (abundance)
         d4_array dm_fmsz;//discard mortality (abundance)
         
+    protected:
+        dvector totFM_z;//work vector: total fishing mortality rate by size
+        
     public:
         /**
          * Class constructor.
@@ -143,7 +173,19 @@ class CatchInfo {
          * @return np_msz - post-fisheries population size (d3_array)
          * 
          */
-        d3_array applyFM(double dirF, d3_array& n_msz, ostream& cout);
+        d3_array applyFM(double dirF, const d3_array& n_msz, ostream& cout);
+        /**
+         * As applyFM, but writes post-fisheries population size into np_msz.
+         * np_msz must not be the same array as n_msz.
+         * 
+         * Modifies: ct_msz, rm_fmsz, dm_fmsz
+         * 
+         * @param np_msz - (output) post-fisheries population size (allocated by caller)
+         * @param dirF - fully-selected directed fishery capture rate
+         * @param n_msz - pre-fisheries population size
+         * @param cout - stream for writing debug info
+         */
+        void applyFMInto(d3_array& np_msz, double dirF, const d3_array& n_msz, ostream& cout);
         /**
          * Calculates probabilities of surviving fisheries, given directed 
          * fishing capture rate 'dirF'.
@@ -154,26 +196,34 @@ class CatchInfo {
          * @return survival probabilities S_msz as d3_array.
          */
         d3_array calcSurvival(double dirF, ostream& cout);
+        /**
+         * As calcSurvival, but writes survival probabilities into S_msz.
+         * 
+         * @param S_msz - (output) survival probabilities (allocated by caller)
+         * @param dirF - fully-selected capture rate for target fishery (f=1)
+         * @param cout - stream for writing debug info
+         */
+        void calcSurvivalInto(d3_array& S_msz, double dirF, ostream& cout);
         /**
          * Set sex-specific fishery capture rates.
          * 
          * @param x - sex to select
          * @param capF_fxmsz - input capture rates
          */
-        void setCaptureRates(int x, d5_array& capF_fxmsz);
+        void setCaptureRates(int x, const d5_array& capF_fxmsz);
         /**
          * Set sex-specific retention functions.
          * 
          * @param x - sex to select
          * @param retF_fxmsz - input retention functions
          */
-        void setRetentionFcns(int x, d5_array& retF_fxmsz);
+        void setRetentionFcns(int x, const d5_array& retF_fxmsz);
         /**
          * Set handling mortality rates, by fishery.
          * 
          * @param pHM_f - dvector of handling mortality rates
          */
-        void setHandlingMortality(dvector& pHM_f);
+        void setHandlingMortality(const dvector& pHM_f);
 };//CatchInfo
 
 class Tier3_Calculator {
@@ -195,6 +245,18 @@ class Tier3_Calculator {
         double Fmsy;//=FXX; directed fishery capture F resulting in MSY
         double Bmsy;//=XX*B100; longterm B resulting from directed fishing at F
         
+    protected:
+        //work arrays reused across the Fmsy iterations
+        dvector  R_zp;    //size-specific recruitment
+        d3_array S1_msz;  //survival prior to molting/growth
+        d3_array S2_msz;  //survival following molting/growth
+        d3_array neq_msz; //equilibrium abundance
+        d3_array wrk1_msz;//work array
+        d3_array wrk2_msz;//work array
+        d3_array wrk3_msz;//work array
+        dvector  cD_z;    //work vector for calcEqNatZInto(...)
+        dmatrix  A_zz;    //work matrix for calcEqNatZInto(...)
+        
     public:
         /**
          * Class constructor.
@@ -255,9 +317,23 @@ class Tier3_Calculator {
          * 
          * @return equlibrium (longterm) population abundance on July 1 (as d3_array)
          */
-        d3_array calcEqNatZ(dvector& R_z,d3_array& S1_msz, 
-                            dmatrix& Th_sz, d3_array& T_szz, 
-                            d3_array& S2_msz, ostream& cout);
+        d3_array calcEqNatZ(const dvector& R_z,const d3_array& S1_msz, 
+                            const dmatrix& Th_sz, const d3_array& T_szz, 
+                            const d3_array& S2_msz, ostream& cout);
+        /**
+         * As calcEqNatZ, but writes the equilibrium abundance into n_msz.
+         * 
+         * @param n_msz - (output) equilibrium abundance on July 1 (allocated by caller)
+         * @param R_z - longterm recruitment at size
+         * @param S1_msz - survival prior to molting/growth
+         * @param Th_sz - pr(molt-to-maturity|size) for immature crab
+         * @param T_szz - growth transition matrix for molting crab
+         * @param S2_msz - survival following molting/growth
+         * @param cout - output stream for debug info
+         */
+        void calcEqNatZInto(d3_array& n_msz, const dvector& R_z,const d3_array& S1_msz, 
+                            const dmatrix& Th_sz, const d3_array& T_szz, 
+                            const d3_array& S2_msz, ostream& cout);
         /**
          * Calculate equilibrium unfished abundance on July 1 when 
          * longterm (average) male recruitment is R.
@@ -268,6 +344,14 @@ class Tier3_Calculator {
          * @return equilibrium (male) population abundance on July 1
          */
         d3_array calcEqNatZF0(double R, ostream& cout);
+        /**
+         * As calcEqNatZF0, but writes the equilibrium abundance into n_msz.
+         * 
+         * @param n_msz - (output) equilibrium abundance on July 1 (allocated by caller)
+         * @param R - longterm (average) male recruitment
+         * @param cout - output stream for debug info
+         */
+        void calcEqNatZF0Into(d3_array& n_msz, double R, ostream& cout);
         /**
          * Calculate equilibrium abundance on July 1 when dirF is the 
          * directed fishery capture rate and the longterm (average) 
@@ -280,6 +364,15 @@ class Tier3_Calculator {
          * @return equilibrium (male) population abundance on July 1
          */
         d3_array calcEqNatZFM(double R, double dirF, ostream& cout);
+        /**
+         * As calcEqNatZFM, but writes the equilibrium abundance into n_msz.
+         * 
+         * @param n_msz - (output) equilibrium abundance on July 1 (allocated by caller)
+         * @param R - longterm (average) male recruitment
+         * @param dirF - directed fishery capture rate
+         * @param cout - output stream for debug info
+         */
+        void calcEqNatZFMInto(d3_array& n_msz, double R, double dirF, ostream& cout);
         /**
          * Calculate equilibrium MMB when dirF is the directed fishery capture
          * rate and longterm (average) male recruitment is R.
@@ -291,6 +384,17 @@ class Tier3_Calculator {
          * @return equilibrium MMB 
          */
         double   calcEqMMBatF(double R, double dirF, ostream& cout);
+        
+    protected:
+        /**
+         * Solve A*x = b by Gaussian elimination with partial pivoting,
+         * without allocating (ADMB's inv(...) and solve(...) return new 
+         * arrays). A is overwritten.
+         * 
+         * @param A - (input/work) square matrix
+         * @param x - (input/output) b on input, the solution on output
+         */
+        void solveInPlace(dmatrix& A, dvector& x);
 };
 
 /**
@@ -308,6 +412,14 @@ class PopProjector{
         
     public:
         double matBio;       //mature biomass at time of mating
+        d3_array np_msz;     //output buffer for projectInto(...) callers that only need the catch
+    
+    protected:
+        //work arrays reused across projections
+        d3_array wrk1_msz;
+        d3_array wrk2_msz;
+        d3_array wrk3_msz;
+        d3_array wrk4_msz;
     
     public:
         PopDyInfo* pPI;//pointer to single sex PopDyInfo object
@@ -337,7 +449,17 @@ class PopProjector{
          * 
          * @return final sex-specific abundance
          */
-        d3_array project(double dirF, d3_array& n_msz, ostream& cout);
+        d3_array project(double dirF, const d3_array& n_msz, ostream& cout);
+        /**
+         * As project, but writes the final sex-specific abundance into np_msz.
+         * np_msz may be the same array as n_msz.
+         * 
+         * @param np_msz - (output) final abundance (allocated by caller)
+         * @param dirF - multiplier on fishing mortality rate in directed fishery
+         * @param n_msz - initial abundance
+         * @param cout - output stream for debug info
+         */
+        void projectInto(d3_array& np_msz, double dirF, const d3_array& n_msz, ostream& cout);
         /**
          * Calculate mature biomass based on single-sex population
          * abundance on July 1.
@@ -348,7 +470,7 @@ class PopProjector{
          * 
          * @return mature biomass (units??)
          */
-        double projectMatureBiomass(double dirF, d3_array& n_msz, ostream& cout);
+        double projectMatureBiomass(double dirF, const d3_array& n_msz, ostream& cout);
         /**
          * Project sex-specific population abundance forward by time interval "dt", 
          * applying only natural mortality.
@@ -449,7 +571,7 @@ class OFL_Calculator{
          * 
          * @return Fofl
          */
-        double calcFofl(double Bmsy, double Fmsy, d3_array& n_msz, ostream& cout);
+        double calcFofl(double Bmsy, double Fmsy, const d3_array& n_msz, ostream& cout);
         /**
          * Calculate the total OFL (retained+discard mortality) taken
          * when fishing on population starting with initial abundance (July 1)
@@ -465,7 +587,7 @@ class OFL_Calculator{
          * 
          * @return total OFL (biomass)
          */
-        double calcOFL(double Fofl, d4_array& n_xmsz, ostream& cout);
+        double calcOFL(double Fofl, const d4_array& n_xmsz, ostream& cout);
         /**
          * Calculate the (projected) MMB when fished at Fofl.
          * 
@@ -475,7 +597,7 @@ class OFL_Calculator{
          * 
          * @return - the (projected) MMB
          */
-        double calcPrjMMB(double Fofl, d3_array& n_msz, ostream& cout);
+        double calcPrjMMB(double Fofl, const d3_array& n_msz, ostream& cout);
         /**
          * Calculate Fofl using Harvest Control Rule (HCR).
          * 
@@ -8,8 +8,87 @@
 #ifndef SUMMARYFUNCTIONS_HPP
 #define	SUMMARYFUNCTIONS_HPP
 
+#include <vector>
+
 namespace tcsam {
     
+    /**
+     * Class to calculate several marginal sums of the same iyxmsz array
+     * in a single traversal of the array in storage order (i,y,x,m,s,z).
+     * 
+     * Usage: register each requested marginal (and an optional w_xmz 
+     * weighting array) with add(...), then call calc(...) with the 
+     * source array. The destination arrays are (re)allocated and filled 
+     * by calc(...). All destinations must be either double or dvar arrays, 
+     * consistent with the source array.
+     * 
+     * The sum over z for each (i,y,x,m,s) is calculated only once,
+     * regardless of how many requested marginals use it.
+     */
+    class MarginalSums {
+        public:
+            static const int IYX   = 1;//sum over msz, result indices iyx   (d3_array)
+            static const int IXY   = 2;//sum over msz, result indices ixy   (d3_array)
+            static const int IYXMS = 3;//sum over z,   result indices iyxms (d5_array)
+            static const int IXYZ  = 4;//sum over ms,  result indices ixyz  (d4_array)
+            static const int IXMYZ = 5;//sum over s,   result indices ixmyz (d5_array)
+            static const int IXSYZ = 6;//sum over m,   result indices ixsyz (d5_array)
+        protected:
+            std::vector<int> types;          //marginal type by request
+            std::vector<int> isVar;          //flag indicating dvar destination by request
+            std::vector<const d3_array*> pWs;//pointer to weighting array by request (0 for simple sums)
+            std::vector<void*> pRs;          //pointer to destination array by request
+        public:
+            MarginalSums(){}
+            ~MarginalSums(){}
+            
+            /** Remove all requested marginals. */
+            void clear();
+            /** Number of requested marginals. */
+            int count(){return types.size();}
+            
+            /**
+             * Request marginal sums of type IYX or IXY.
+             * @param type  - marginal type
+             * @param r     - destination array (allocated by calc(...))
+             */
+            void add(int type, d3_array& r);
+            /**
+             * Request weighted marginal sums of type IYX or IXY.
+             * @param type  - marginal type
+             * @param r     - destination array (allocated by calc(...))
+             * @param w_xmz - weight-at-xmz array (must persist until calc(...))
+             */
+            void add(int type, d3_array& r, const d3_array& w_xmz);
+            /** Request (weighted) marginal sums of type IXYZ. */
+            void add(int type, d4_array& r);
+            void add(int type, d4_array& r, const d3_array& w_xmz);
+            /** Request (weighted) marginal sums of type IYXMS, IXMYZ or IXSYZ. */
+            void add(int type, d5_array& r);
+            void add(int type, d5_array& r, const d3_array& w_xmz);
+            /** dvar versions of the above */
+            void add(int type, dvar3_array& r);
+            void add(int type, dvar3_array& r, const d3_array& w_xmz);
+            void add(int type, dvar4_array& r);
+            void add(int type, dvar4_array& r, const d3_array& w_xmz);
+            void add(int type, dvar5_array& r);
+            void add(int type, dvar5_array& r, const d3_array& w_xmz);
+            
+            /**
+             * Calculate all requested marginal sums of n_iyxmsz.
+             * @param n_iyxmsz - source array
+             */
+            void calc(const d6_array& n_iyxmsz);
+            /**
+             * Calculate all requested marginal sums of n_iyxmsz.
+             * @param n_iyxmsz - source array
+             */
+            void calc(const dvar6_array& n_iyxmsz);
+        protected:
+            void addRequest(int type, int rank, int var, void* pR, const d3_array* pW);
+            void checkRequests(int var);
+    };
+    
     /**
      * Compute marginal weighted sums over last dimension.
      * 
@@ -17,7 +96,7 @@ namespace tcsam {
      * @param  w    - weighting vector
      * @return n_i  - dvector
      */
-    dvector sumOverLastDim(const dmatrix& n_ij, dvector& w);
+    dvector sumOverLastDim(const dmatrix& n_ij, const dvector& w);
     
     /**
      * Compute marginal weighted sums over last dimension.
@@ -26,7 +105,7 @@ namespace tcsam {
      * @param  w    - weighting vector
      * @return n_ij  - dmatrix
      */
-    dmatrix sumOverLastDim(const d3_array& n_ijk, dvector& w);
+    dmatrix sumOverLastDim(const d3_array& n_ijk, const dvector& w);
     
     /**
      * Compute marginal weighted sums over last dimension.
@@ -35,7 +114,7 @@ namespace tcsam {
      * @param  w    - weighting vector
      * @return n_ijk - d3_array
      */
-    d3_array sumOverLastDim(const d4_array& n_ijkl, dvector& w);
+    d3_array sumOverLastDim(const d4_array& n_ijkl, const dvector& w);
     
     /**
      * Compute marginal weighted sums over last dimension.
@@ -44,7 +123,7 @@ namespace tcsam {
      * @param  w    - weighting vector
      * @return n_ijkl  - d4_array
      */
-    d4_array sumOverLastDim(const d5_array& n_ijklm, dvector& w);
+    d4_array sumOverLastDim(const d5_array& n_ijklm, const dvector& w);
     
     /**
      * Compute marginal weighted sums over last dimension.
@@ -53,7 +132,7 @@ namespace tcsam {
      * @param  w    - weighting vector
      * @return n_ijklm  - d4_array
      */
-    d5_array sumOverLastDim(const d6_array& n_ijklmn, dvector& w);
+    d5_array sumOverLastDim(const d6_array& n_ijklmn, const dvector& w);
     
     /**
      * Compute marginal weighted sums over last dimension.
@@ -62,7 +141,7 @@ namespace tcsam {
      * @param  w         - weighting vector
      * @return n_ijklmn  - d6_array
      */
-    d6_array sumOverLastDim(const d7_array& n_ijklmno, dvector& w);
+    d6_array sumOverLastDim(const d7_array& n_ijklmno, const dvector& w);
     
     /**
      * Calculate the sub-array n_iyx from full array n_iyxmsz by
@@ -70,7 +149,7 @@ namespace tcsam {
      * @param n_iyxmsz
      * @return d3_array of resulting sums
      */
-    d3_array calcIYXfromIYXMSZ(d6_array& n_iyxmsz);
+    d3_array calcIYXfromIYXMSZ(const d6_array& n_iyxmsz);
     
     /**
      * Calculate the biomass-weighted sub-array b_ixy 
@@ -80,7 +159,7 @@ namespace tcsam {
      * @param w_xmz    - weight (kg) at sex/maturity/size.
      * @return - biomass for index i, year, sex in mt.
      */
-    d3_array calcIYXfromIYXMSZ(d6_array& n_iyxmsz, d3_array w_xmz);
+    d3_array calcIYXfromIYXMSZ(const d6_array& n_iyxmsz, const d3_array& w_xmz);
     
     /**
      * Calculate the biomass-weighted sub-array b_yxms 
@@ -90,7 +169,7 @@ namespace tcsam {
      * @param w_xmz   - weight (kg) at sex/maturity/size.
      * @return - biomass for index i, year, sex in mt.
      */
-    d4_array calcYXMSfromYXMSZ(d5_array& n_yxmsz, d3_array w_xmz);
+    d4_array calcYXMSfromYXMSZ(const d5_array& n_yxmsz, const d3_array& w_xmz);
     
     /**
      * Calculate the biomass-weighted sub-array b_iyxms 
@@ -100,7 +179,7 @@ namespace tcsam {
      * @param w_xmz    - weight (kg) at sex/maturity/size.
      * @return - biomass for index i, year, sex in mt.
      */
-    d5_array calcIYXMSfromIYXMSZ(d6_array& n_iyxmsz, d3_array w_xmz);
+    d5_array calcIYXMSfromIYXMSZ(const d6_array& n_iyxmsz, const d3_array& w_xmz);
     
     /**
      * Calculate the sub-array n_ixy from full array n_iyxmsz by
@@ -108,7 +187,7 @@ namespace tcsam {
      * @param n_iyxmsz
      * @return d3_array of resulting sums
      */
-    d3_array calcIXYfromIYXMSZ(d6_array& n_iyxmsz);
+    d3_array calcIXYfromIYXMSZ(const d6_array& n_iyxmsz);
     
     /**
      * Calculate the biomass-weighted sub-array b_ixy 
@@ -118,7 +197,7 @@ namespace tcsam {
      * @param w_xmz    - weight (kg) at sex/maturity/size.
      * @return - biomass for index i, sex, year in mt.
      */
-    d3_array calcIXYfromIYXMSZ(d6_array& n_iyxmsz, d3_array w_xmz);
+    d3_array calcIXYfromIYXMSZ(const d6_array& n_iyxmsz, const d3_array& w_xmz);
     
     /**
      * Calculate the sub-array n_ixyz from full array n_iyxmsz by
@@ -126,7 +205,7 @@ namespace tcsam {
      * @param n_iyxmsz
      * @return 
      */
-    d4_array calcIXYZfromIYXMSZ(d6_array& n_iyxmsz);
+    d4_array calcIXYZfromIYXMSZ(const d6_array& n_iyxmsz);
         
     /**
      * Calculate the sub-array n_ixmyz from full array n_iyxmsz by
@@ -134,7 +213,7 @@ namespace tcsam {
      * @param n_iyxmsz
      * @return 
      */
-    d5_array calcIXMYZfromIYXMSZ(d6_array& n_iyxmsz);
+    d5_array calcIXMYZfromIYXMSZ(const d6_array& n_iyxmsz);
     
     /**
      * Calculate the sub-array n_ixsyz from full array n_iyxmsz by
@@ -142,7 +221,7 @@ namespace tcsam {
      * @param n_iyxmsz
      * @return 
      */
-    d5_array calcIXSYZfromIYXMSZ(d6_array& n_iyxmsz);
+    d5_array calcIXSYZfromIYXMSZ(const d6_array& n_iyxmsz);
     
     /**
      * Rearrange the input array n_yxmsz to n_xmsyz.
@@ -179,7 +258,7 @@ namespace tcsam {
     * @param n_xmsyz
      * @return extracted vector (indices consistent with z)
      */
-    dvector extractFromXMSYZ(int x, int m, int s, int y, d5_array& n_xmsyz);
+    dvector extractFromXMSYZ(int x, int m, int s, int y, const d5_array& n_xmsyz);
     
     /**
      * Extract (possibly summary) value from 4d array w/ indices
@@ -192,7 +271,7 @@ namespace tcsam {
     * @param n_yxms
      * @return extracted value
      */
-    double extractFromYXMS(int y, int x, int m, int s, d4_array& n_yxms);
+    double extractFromYXMS(int y, int x, int m, int s, const d4_array& n_yxms);
     
     /**
      * Extract (possibly summary) vector from 5d array w/ indices
@@ -205,7 +284,7 @@ namespace tcsam {
     * @param n_yxmsz
      * @return extracted vector (indices consistent with z)
      */
-    dvector extractFromYXMSZ(int y, int x, int m, int s, d5_array& n_yxmsz);
+    dvector extractFromYXMSZ(int y, int x, int m, int s, const d5_array& n_yxmsz);
 }
 #endif	/* SUMMARYFUNCTIONS_HPP */
 
@@ -13,12 +13,15 @@
     #include "ModelConfiguration.hpp"
     #include "ModelIndexBlocks.hpp"
     #include "ModelSelectivities.hpp"
+    #include "ModelGrowth.hpp"
     #include "ModelParameterInfoTypes.hpp"
     #include "ModelParametersInfo.hpp"
     #include "ModelParameterFunctions.hpp"
     #include "ModelData.hpp"
     #include "SummaryFunctions.hpp"
+    #include "ModelPopState.hpp"
     #include "OFLCalcs.hpp"
+    #include "ModelRunDrivers.hpp"
 
 #endif	/* TCSAM_HPP */
 
@@ -11,7 +11,7 @@ using namespace std;
 //      ModelOptions
 //**********************************************************************
 const adstring ModelConfiguration::VERSION = "2016.04.13";
-const adstring ModelOptions::VERSION       = "2016.04.13";
+const adstring ModelOptions::VERSION       = "2016.05.08";
 
 int ModelConfiguration::debug=0;
 int ModelOptions::debug      =0;
@@ -330,6 +330,14 @@ void ModelOptions::read(cifstream & is) {
     }
     is>>optGrowth;
     cout<<optGrowth<<tb<<"#"<<lblsGrowthOpts(optGrowth)<<endl;
+    is>>maxGrDZ;
+    cout<<maxGrDZ<<tb<<"#max growth increment (mm) in a molt (optGrowth=0)"<<endl;
+    if (maxGrDZ<=0.0){
+        std::cout<<"Reading Model Options file."<<endl;
+        std::cout<<"The max growth increment must be > 0, but got "<<maxGrDZ<<"."<<endl;
+        std::cout<<"Please update '"<<is.get_file_name()<<"'"<<endl;
+        exit(-1);
+    }
     is>>optInitNatZ;
     cout<<optInitNatZ<<tb<<"#"<<lblsInitNatZOpts(optInitNatZ)<<endl;
     is>>cvFDevsPen;
@@ -383,6 +391,7 @@ void ModelOptions::write(ostream & os) {
         os<<"#"<<o<<" - "<<lblsGrowthOpts(o)<<endl;
     }
     os<<optGrowth<<tb<<"#selected option"<<endl;
+    os<<maxGrDZ<<tb<<"#max growth increment (mm) in a molt (optGrowth=0; TCSAM2013: 45)"<<endl;
 
     //initial n-at-z options
     os<<"#----Initial Numbers-At-Size Options"<<endl;
@@ -423,7 +432,7 @@ void ModelOptions::writeToR(ostream& os, std::string nm, int indent) {
         os<<nm<<"=list("<<endl;
     indent++;
         for (int n=0;n<indent;n++) os<<tb;
-        os<<"growth="<<optGrowth<<cc<<"initNatZ="<<optInitNatZ<<cc
+        os<<"growth="<<optGrowth<<cc<<"maxGrDZ="<<maxGrDZ<<cc<<"initNatZ="<<optInitNatZ<<cc
             <<"cvFDevsPen="<<cvFDevsPen<<cc<<"phsDecr="<<phsDecrFDevsPen<<cc<<"phsZero="<<phsZeroFDevsPen<<cc
             <<"wgtLastDevPen="<<wgtLastDevsPen<<cc<<"phsLastDevsPen="<<phsLastDevsPen<<cc
             <<"wgtSmthLgtPrMat="<<wgtSmthLgtPrMat<<cc<<"wgtNonDecLgtPrMat="<<wgtNonDecLgtPrMat<<endl;
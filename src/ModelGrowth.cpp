@@ -0,0 +1,193 @@
+/* 
+ * File:   ModelGrowth.cpp
+ * Author: William.Stockhausen
+ *
+ * Created on May 8, 2016
+ */
+
+#include <admodel.h>
+#include "wtsADMB.hpp"
+#include "ModelGrowth.hpp"
+
+using namespace std;
+
+//--------------------------------------------------------------------------------
+//  Includes:
+//      GrowthFcns
+//--------------------------------------------------------------------------------
+
+int GrowthFcns::debug = 0;//debug flag
+
+/**
+ * Calculates the digamma function in double precision using the 
+ * recurrence psi(x) = psi(x+1)-1/x to shift x above 6, then the
+ * asymptotic expansion.
+ * 
+ * @param x - argument (>0)
+ * 
+ * @return - psi(x)
+ */
+double GrowthFcns::digamma(double x){
+    double r = 0.0;
+    while (x<6.0){r -= 1.0/x; x += 1.0;}
+    double f = 1.0/(x*x);
+    return r+log(x)-0.5/x-f*(1.0/12.0-f*(1.0/120.0-f*(1.0/252.0-f*(1.0/240.0-f/132.0))));
+}
+
+/**
+ * Calculates the regularized lower incomplete gamma function 
+ *      P(a,x) = sum_{n>=0} t_n, t_n = x^(a+n)*exp(-x)/Gamma(a+n+1)
+ * and its partial derivatives w.r.t. a and x in double precision.
+ * 
+ * The series is summed outward from its largest term (n0 ~ x-a) so it 
+ * neither underflows for x>>a nor needs more terms than necessary. 
+ * dP/da follows term-by-term from d(ln t_n)/da = ln(x)-psi(a+n+1).
+ * 
+ * @param a    - shape
+ * @param x    - upper limit of integration
+ * @param dPda - (output) dP/da
+ * @param dPdx - (output) dP/dx
+ * 
+ * @return - P(a,x)
+ */
+double GrowthFcns::cumdGamma(double a, double x, double& dPda, double& dPdx){
+    const double eps = 1.0e-15;
+    dPda = 0.0; dPdx = 0.0;
+    if (x<=0.0) return 0.0;
+    double lx = log(x);
+    dPdx = exp((a-1.0)*lx-x-gammln(a));
+    
+    int n0 = 0; if (x>a) n0 = (int) floor(x-a);
+    double t0   = exp((a+n0)*lx-x-gammln(a+n0+1.0));
+    double psi0 = digamma(a+n0+1.0);
+    double P  = t0;
+    double dP = t0*(lx-psi0);
+    //sum upward: t_n = t_{n-1}*x/(a+n), psi(a+n+1) = psi(a+n)+1/(a+n)
+    double t = t0; double psi = psi0;
+    for (int n=n0+1;n<n0+100000;n++){
+        t *= x/(a+n); psi += 1.0/(a+n);
+        P += t; dP += t*(lx-psi);
+        if (t<eps*P) break;
+    }
+    //sum downward: t_{n-1} = t_n*(a+n)/x, psi(a+n) = psi(a+n+1)-1/(a+n)
+    t = t0; psi = psi0;
+    for (int n=n0;n>0;n--){
+        t *= (a+n)/x; psi -= 1.0/(a+n);
+        P += t; dP += t*(lx-psi);
+        if (t<eps*P) break;
+    }
+    dPda = dP;
+    if (P>1.0) P = 1.0;
+    return P;
+}
+
+/**
+ * Calculates the growth transition matrix based on the cumulative
+ * gamma distribution (optGrowth=1). Element (z,zp) is the probability
+ * of growing from pre-molt size bin z to post-molt size bin zp.
+ * 
+ * For pre-molt bin z<nZBs, with scaled mean post-molt size a_z = exp(grA)*zBs(z)^grB/grBeta
+ * and scaled cutpoints x_zp = zCs(zp)/grBeta,
+ *      C(zp)    = P(a_z,x_zp), zp = z,...,nZBs
+ *      pr(z,zp) = [C(zp+1)-C(zp)]/[1-C(z)],  zp<nZBs
+ *      pr(z,nZBs) = [1-C(nZBs)]/[1-C(z)]  (final size bin is an accumulator)
+ * and pr(nZBs,nZBs) = 1 (no growth from max size).
+ * 
+ * Inputs:
+ * @param zBs    - dvector of size bin midpoints
+ * @param zCs    - dvector of size bin cutpoints
+ * @param grA    - coefficient for mean growth
+ * @param grB    - exponent for mean growth
+ * @param grBeta - gamma scale factor
+ * 
+ * @return - growth transition matrix (rows: pre-molt z, columns: post-molt z) as dvar_matrix
+ */
+dvar_matrix GrowthFcns::calcPrGrCumdGamma(dvector& zBs, dvector& zCs, const prevariable& grA, const prevariable& grB, const prevariable& grBeta){
+    RETURN_ARRAYS_INCREMENT();
+    if (debug) cout<<"Starting GrowthFcns::calcPrGrCumdGamma(...)"<<endl;
+    int nZBs = zBs.indexmax();
+    double vA    = value(grA);
+    double vB    = value(grB);
+    double vBeta = value(grBeta);
+    
+    //scaled mean post-molt sizes and their derivatives w.r.t. (grA,grB,grBeta)
+    dvector a = exp(vA)*pow(zBs,vB)/vBeta;
+    dmatrix dadp(1,3,1,nZBs);
+    dadp(1) = a;
+    dadp(2) = elem_prod(a,log(zBs));
+    dadp(3) = -a/vBeta;
+    
+    dmatrix  M(1,nZBs,1,nZBs);     M.initialize();
+    d3_array dMdp(1,3,1,nZBs,1,nZBs); dMdp.initialize();
+    dvector  C(1,nZBs);
+    dmatrix  dCdp(1,3,1,nZBs);
+    double dPda, dPdx;
+    for (int z=1;z<nZBs;z++){
+        for (int zp=z;zp<=nZBs;zp++){
+            double x = zCs(zp)/vBeta;
+            C(zp) = cumdGamma(a(z),x,dPda,dPdx);
+            dCdp(1,zp) = dPda*dadp(1,z);
+            dCdp(2,zp) = dPda*dadp(2,z);
+            dCdp(3,zp) = dPda*dadp(3,z)-dPdx*x/vBeta;
+        }
+        double D = 1.0-C(z);//normalization constant
+        for (int zp=z;zp<nZBs;zp++) M(z,zp) = (C(zp+1)-C(zp))/D;
+        M(z,nZBs) = (1.0-C(nZBs))/D;
+        for (int k=1;k<=3;k++){
+            for (int zp=z;zp<nZBs;zp++) dMdp(k,z,zp) = (dCdp(k,zp+1)-dCdp(k,zp)+M(z,zp)*dCdp(k,z))/D;
+            dMdp(k,z,nZBs) = (-dCdp(k,nZBs)+M(z,nZBs)*dCdp(k,z))/D;
+        }
+        if (debug) cout<<M(z)<<endl;
+    }
+    M(nZBs,nZBs) = 1.0;//no growth from max size
+    
+    dvar_matrix prGr_zz(nograd_assign(M));
+    save_identifier_string("grwA");
+    prGr_zz.save_dvar_matrix_position();
+    grA.save_prevariable_position();
+    grB.save_prevariable_position();
+    grBeta.save_prevariable_position();
+    for (int k=1;k<=3;k++){
+        dMdp(k).save_dmatrix_value();
+        dMdp(k).save_dmatrix_position();
+    }
+    save_identifier_string("grwB");
+    gradient_structure::GRAD_STACK1->set_gradient_stack(dfPrGrCumdGamma);
+    if (debug) cout<<"Finished GrowthFcns::calcPrGrCumdGamma(...)"<<endl;
+    RETURN_ARRAYS_DECREMENT();
+    return prGr_zz;
+}
+
+/**
+ * Adjoint for calcPrGrCumdGamma: propagates the derivatives of the growth
+ * transition matrix back to (grA, grB, grBeta) using the saved jacobians.
+ */
+void GrowthFcns::dfPrGrCumdGamma(void){
+    verify_identifier_string("grwB");
+    dmatrix_position posdBeta = restore_dmatrix_position();
+    dmatrix dMdBeta = restore_dmatrix_value(posdBeta);
+    dmatrix_position posdB    = restore_dmatrix_position();
+    dmatrix dMdB    = restore_dmatrix_value(posdB);
+    dmatrix_position posdA    = restore_dmatrix_position();
+    dmatrix dMdA    = restore_dmatrix_value(posdA);
+    prevariable_position posBeta = restore_prevariable_position();
+    prevariable_position posB    = restore_prevariable_position();
+    prevariable_position posA    = restore_prevariable_position();
+    dvar_matrix_position mpos    = restore_dvar_matrix_position();
+    dmatrix dfM = restore_dvar_matrix_derivatives(mpos);
+    verify_identifier_string("grwA");
+    double dfA = 0.0; double dfB = 0.0; double dfBeta = 0.0;
+    for (int z=dfM.rowmin();z<=dfM.rowmax();z++){
+        for (int zp=z;zp<=dfM(z).indexmax();zp++){
+            double df = dfM(z,zp);
+            if (df!=0.0){
+                dfA    += df*dMdA(z,zp);
+                dfB    += df*dMdB(z,zp);
+                dfBeta += df*dMdBeta(z,zp);
+            }
+        }
+    }
+    save_double_derivative(dfA,posA);
+    save_double_derivative(dfB,posB);
+    save_double_derivative(dfBeta,posBeta);
+}
@@ -129,7 +129,7 @@ int IndexFunction6::calcOffset(ivector i){
     if (i[1]<mn) return 0; 
     int idx = IndexFunction5::calcOffset(i(2,6));
     if (!idx) return 0;
-    return (i[1]-mn)*IndexFunction6::getSize()+idx;
+    return (i[1]-mn)*IndexFunction5::getSize()+idx;
 }
 int IndexFunction6::getIndex(ivector i){
     int o = calcOffset(i);
@@ -58,7 +58,7 @@ ParameterGroupInfo::~ParameterGroupInfo(){
  * Gets indices for parameter combination pc.\n
  * pc : id for desired parameter combination.\n
  *******************************************/
-ivector ParameterGroupInfo::getPCIDs(int pc){
+ivector& ParameterGroupInfo::getPCIDs(int pc){
     if (debug) cout<<"starting ParameterGroupInfo::getPCIDs(int pc)"<<endl;
     if (debug) {
         cout<<"pcids for "<<pc<<"th parameter combination: "<<in(pc)<<endl;
@@ -96,6 +96,47 @@ imatrix ParameterGroupInfo::getModelIndices(int pc){
     return idxs;
 }
 
+/**
+ * Compiles the model indices for all parameter combinations into planIdxs
+ * (rows planFirst(pc):planLast(pc) for parameter combination pc), keeping 
+ * only rows with years in mnY:mxY so model process calculations can loop
+ * over the rows without copying the indices or checking year ranges.
+ * 
+ * @param mnY - min model year
+ * @param mxY - max model year
+ */
+void ParameterGroupInfo::compilePlan(int mnY, int mxY){
+    if (debug) cout<<"starting ParameterGroupInfo::compilePlan("<<mnY<<cc<<mxY<<") for "<<name<<endl;
+    //find year index variable (if any)
+    int iYr = 0;
+    for (int i=1;i<=nIVs;i++){
+        int n = lblIVs(i).pos("_");
+        if (n&&(lblIVs(i)(1,n-1)==tcsam::STR_YEAR)) iYr = i;
+    }
+    //count rows to keep
+    int nRows = 0;
+    for (int p=1;p<=nPCs;p++){
+        imatrix& idxs = (*ppIdxs[p-1]);
+        for (int r=idxs.indexmin();r<=idxs.indexmax();r++){
+            if ((!iYr)||((mnY<=idxs(r,iYr))&&(idxs(r,iYr)<=mxY))) nRows++;
+        }
+    }
+    //compile rows
+    planFirst.allocate(1,nPCs);
+    planLast.allocate(1,nPCs);
+    if (nRows) planIdxs.allocate(1,nRows,1,nIVs);
+    int c = 0;
+    for (int p=1;p<=nPCs;p++){
+        imatrix& idxs = (*ppIdxs[p-1]);
+        planFirst(p) = c+1;
+        for (int r=idxs.indexmin();r<=idxs.indexmax();r++){
+            if ((!iYr)||((mnY<=idxs(r,iYr))&&(idxs(r,iYr)<=mxY))) planIdxs(++c) = idxs(r);
+        }
+        planLast(p) = c;
+    }
+    if (debug) cout<<"finished ParameterGroupInfo::compilePlan(...): "<<nRows<<" rows"<<endl;
+}
+
 /**
  * Creates the pointer to the IndexBlockSets object 
  * and the individual IndexBlockSet objects corresponding
@@ -1446,6 +1487,46 @@ void ModelParametersInfo::writeToR(std::ostream & os){
     ptrSrv->writeToR(os); os<<endl;
     os<<")";
 }
+
+/**
+ * Compiles the model indices for all parameter groups (see 
+ * ParameterGroupInfo::compilePlan(...)). Selectivities and survey 
+ * catchabilities are also calculated for mxY+1.
+ * 
+ * @param mnY - min model year
+ * @param mxY - max model year
+ */
+void ModelParametersInfo::compilePlans(int mnY, int mxY){
+    ptrRec->compilePlan(mnY,mxY);
+    ptrNM->compilePlan(mnY,mxY);
+    ptrGr->compilePlan(mnY,mxY);
+    ptrMat->compilePlan(mnY,mxY);
+    ptrSel->compilePlan(mnY,mxY+1);
+    ptrFsh->compilePlan(mnY,mxY);
+    ptrSrv->compilePlan(mnY,mxY+1);
+}
+
+/**
+ * Find the bounded number vector parameter info with the given name 
+ * (e.g., "pLnM" or "pLnQ") in any parameter group.
+ * 
+ * @param name - parameter name, as given in the parameters info file
+ * 
+ * @return pointer to the BoundedNumberVectorInfo (0 if not found)
+ */
+BoundedNumberVectorInfo* ModelParametersInfo::getBoundedNumberVectorInfo(adstring name){
+    BoundedNumberVectorInfo* pBNVIs[] = {ptrRec->pLnR,ptrRec->pLnRCV,ptrRec->pLgtRX,ptrRec->pLnRa,ptrRec->pLnRb,
+                                         ptrNM->pLnM,ptrNM->pLnDMT,ptrNM->pLnDMX,ptrNM->pLnDMM,ptrNM->pLnDMXM,
+                                         ptrGr->pLnGrA,ptrGr->pLnGrB,ptrGr->pLnGrBeta,
+                                         ptrSel->pS1,ptrSel->pS2,ptrSel->pS3,ptrSel->pS4,ptrSel->pS5,ptrSel->pS6,
+                                         ptrFsh->pHM,ptrFsh->pLnC,ptrFsh->pLnDCT,ptrFsh->pLnDCX,ptrFsh->pLnDCM,ptrFsh->pLnDCXM,
+                                         ptrSrv->pLnQ,ptrSrv->pLnDQT,ptrSrv->pLnDQX,ptrSrv->pLnDQM,ptrSrv->pLnDQXM};
+    int n = sizeof(pBNVIs)/sizeof(pBNVIs[0]);
+    for (int i=0;i<n;i++) {
+        if (pBNVIs[i]&&(pBNVIs[i]->name==name)) return pBNVIs[i];
+    }
+    return 0;
+}
         
 void tcsam::readError(cifstream & is, const char * expP, adstring gotP){
     cout<<"Reading "<<is.get_file_name()<<endl;
@@ -0,0 +1,1327 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#if !defined(_WIN32)
+    #include <signal.h>
+    #include <sys/time.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#else
+    #include <direct.h>
+    #include <sys/timeb.h>
+#endif
+#include <admodel.h>
+#include <wtsADMB.hpp>
+#include "ModelConstants.hpp"
+#include "ModelConfiguration.hpp"
+#include "ModelRunDrivers.hpp"
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+//ParFileValues
+////////////////////////////////////////////////////////////////////////////////
+/**flag to print debug info*/
+int ParFileValues::debug = 0;
+/**
+ * Constructor.
+ */
+ParFileValues::ParFileValues(){
+    objFun  = 0.0;
+    maxGrad = 0.0;
+}
+
+/**
+ * Read values from an ADMB par file.
+ *
+ * @param fn - name of par file
+ *
+ * @return 1 if file was read, 0 otherwise
+ */
+int ParFileValues::read(adstring fn){
+    if (debug) cout<<"starting ParFileValues::read("<<fn<<")"<<endl;
+    values.clear();
+    ifstream is((char*) fn);
+    if (!is.good()) {
+        cout<<"Warning in ParFileValues::read(...)"<<endl;
+        cout<<"Could not open par file '"<<fn<<"'"<<endl;
+        return 0;
+    }
+    std::string line;
+    std::string lbl;
+    std::vector<double> vals;
+    while (std::getline(is,line)){
+        if (line.size()&&(line[0]=='#')){
+            //save values for previous label
+            if (lbl.size()){
+                dvector v(1,vals.size());
+                for (unsigned int i=0;i<vals.size();i++) v(i+1) = vals[i];
+                values[lbl] = v;
+            }
+            lbl.clear(); vals.clear();
+            size_t i1 = line.find_first_not_of("# ");
+            size_t i2 = line.find_last_of(':');
+            if ((i1!=std::string::npos)&&(i2!=std::string::npos)&&(i2>i1)&&(i2==line.find_last_not_of(" \t\r"))){
+                lbl = line.substr(i1,i2-i1);//parameter label
+            } else {
+                //header line: parse objective function value and max gradient
+                size_t io = line.find("Objective function value =");
+                if (io!=std::string::npos) std::istringstream(line.substr(io+26))>>objFun;
+                size_t ig = line.find("Maximum gradient component =");
+                if (ig!=std::string::npos) std::istringstream(line.substr(ig+28))>>maxGrad;
+            }
+        } else if (lbl.size()) {
+            std::istringstream iss(line);
+            double v;
+            while (iss>>v) vals.push_back(v);
+        }
+    }
+    if (lbl.size()){
+        dvector v(1,vals.size());
+        for (unsigned int i=0;i<vals.size();i++) v(i+1) = vals[i];
+        values[lbl] = v;
+    }
+    if (debug) {
+        cout<<"read "<<values.size()<<" parameter labels"<<endl;
+        cout<<"finished ParFileValues::read("<<fn<<")"<<endl;
+    }
+    return 1;
+}
+
+/**
+ * Test whether values exist for the parameter with the given label.
+ *
+ * @param lbl - parameter label (e.g., "pLnR[1]" or "pDevsLnR[2]")
+ *
+ * @return 1 if values exist, 0 otherwise
+ */
+int ParFileValues::hasValues(adstring lbl){
+    return (values.find(std::string((char*) lbl))!=values.end());
+}
+
+/**
+ * Get the values for the parameter with the given label.
+ * Returned dvector has indices starting at 1.
+ *
+ * @param lbl - parameter label
+ *
+ * @return dvector of values
+ */
+dvector ParFileValues::getValues(adstring lbl){
+    std::map<std::string,dvector>::iterator it = values.find(std::string((char*) lbl));
+    if (it==values.end()){
+        cout<<"Error in ParFileValues::getValues("<<lbl<<")"<<endl;
+        cout<<"No values were read for this label."<<endl;
+        cout<<"Aborting..."<<endl;
+        exit(-1);
+    }
+    return it->second;
+}
+
+/**
+ * Get the value for the i-th element of a parameter number vector.
+ * Labels of the form "lbl[i]" are checked first, then the i-th value
+ * for "lbl".
+ *
+ * @param lbl - parameter vector label
+ * @param i - element index
+ * @param val - (output) value
+ *
+ * @return 1 if a value was found, 0 otherwise
+ */
+int ParFileValues::getValue(adstring lbl, int i, double& val){
+    adstring lbli = lbl+"["+itoa(i,10)+"]";
+    if (hasValues(lbli)){
+        dvector v = getValues(lbli);
+        if (v.size()) {val = v(1); return 1;}
+    } else if (hasValues(lbl)){
+        dvector v = getValues(lbl);
+        if ((v.indexmin()<=i)&&(i<=v.indexmax())) {val = v(i); return 1;}
+    }
+    return 0;
+}
+
+/**
+ * Set values from a flattened vector of parameter values, replacing
+ * any existing values. Consecutive repeated labels are collected
+ * into a single vector (e.g., elements of "pDevsLnR[1]").
+ *
+ * @param lbls - labels for the values
+ * @param vals - values (indices starting at 1)
+ */
+void ParFileValues::setValues(const std::vector<std::string>& lbls, const dvector& vals){
+    values.clear();
+    unsigned int i = 0;
+    while (i<lbls.size()){
+        unsigned int j = i;
+        while ((j+1<lbls.size())&&(lbls[j+1]==lbls[i])) j++;
+        dvector v(1,j-i+1);
+        for (unsigned int k=i;k<=j;k++) v(k-i+1) = vals(k+1);
+        values[lbls[i]] = v;
+        i = j+1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//ParameterVectorsTable
+////////////////////////////////////////////////////////////////////////////////
+/**flag to print debug info*/
+int ParameterVectorsTable::debug = 0;
+/**
+ * Read the table from a file.
+ *
+ * @param fn - name of file
+ *
+ * @return 1 if successful, 0 otherwise
+ */
+int ParameterVectorsTable::read(adstring fn){
+    if (debug) cout<<"starting ParameterVectorsTable::read("<<fn<<")"<<endl;
+    ifstream is((char*) fn);
+    if (!is.good()) {
+        cout<<"Error in ParameterVectorsTable::read(...)"<<endl;
+        cout<<"Could not open parameter vectors file '"<<fn<<"'"<<endl;
+        return 0;
+    }
+    lbls.clear();
+    std::vector<std::vector<double> > rows;
+    std::string line;
+    while (std::getline(is,line)){
+        if ((!line.size())||(line[0]=='#')) continue;
+        for (unsigned int i=0;i<line.size();i++) if (line[i]==',') line[i]=' ';
+        std::istringstream iss(line);
+        if (!lbls.size()){
+            std::string lbl;
+            while (iss>>lbl) lbls.push_back(lbl);
+        } else {
+            std::vector<double> row;
+            double v;
+            while (iss>>v) row.push_back(v);
+            if (!row.size()) continue;
+            if (row.size()!=lbls.size()){
+                cout<<"Error in ParameterVectorsTable::read(...)"<<endl;
+                cout<<"Row "<<rows.size()+1<<" in '"<<fn<<"' has "<<row.size()<<" values but there are "<<lbls.size()<<" labels."<<endl;
+                return 0;
+            }
+            rows.push_back(row);
+        }
+    }
+    nRows = rows.size();
+    if (!nRows){
+        cout<<"Error in ParameterVectorsTable::read(...)"<<endl;
+        cout<<"No parameter vectors found in '"<<fn<<"'"<<endl;
+        return 0;
+    }
+    vals.allocate(1,nRows,1,lbls.size());
+    for (int r=1;r<=nRows;r++){
+        for (unsigned int c=0;c<lbls.size();c++) vals(r,c+1) = rows[r-1][c];
+    }
+    if (debug) cout<<"finished ParameterVectorsTable::read("<<fn<<"): "<<nRows<<" rows"<<endl;
+    return 1;
+}
+
+/**
+ * Copy the values for a row into a ParFileValues object.
+ *
+ * @param r - row
+ * @param pfv - ParFileValues object to copy values into
+ */
+void ParameterVectorsTable::getRow(int r, ParFileValues& pfv){
+    pfv.setValues(lbls,vals(r));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//RetroPeelsResults
+////////////////////////////////////////////////////////////////////////////////
+/**flag to print debug info*/
+int RetroPeelsResults::debug = 0;
+/**
+ * Constructor.
+ *
+ * @param npPeels - number of peels (excluding peel 0)
+ * @param mny - min model year
+ * @param mxy - max model year for peel 0
+ */
+RetroPeelsResults::RetroPeelsResults(int npPeels, int mny, int mxy){
+    nPeels = npPeels;
+    mnYr = mny;
+    mxYr = mxy;
+    hasPeel.allocate(0,nPeels); hasPeel.initialize();
+    mmb_py.allocate(0,nPeels,mnYr,mxYr); mmb_py.initialize();
+    mfb_py.allocate(0,nPeels,mnYr,mxYr); mfb_py.initialize();
+    R_py.allocate(0,nPeels,mnYr,mxYr);   R_py.initialize();
+    ofl_p.allocate(0,nPeels);            ofl_p.initialize();
+    objFun_p.allocate(0,nPeels);         objFun_p.initialize();
+}
+
+/**
+ * Read results for a single peel from a csv file written by
+ * tcsam::writeRetroPeelResults(...).
+ *
+ * File format is one header line ("peel,type,year,value") followed by
+ * one line per value.
+ *
+ * @param p - peel
+ * @param fn - name of csv file
+ *
+ * @return 1 if successful, 0 otherwise
+ */
+int RetroPeelsResults::readPeel(int p, adstring fn){
+    if (debug) cout<<"starting RetroPeelsResults::readPeel("<<p<<cc<<fn<<")"<<endl;
+    ifstream is((char*) fn);
+    if (!is.good()) {
+        cout<<"Warning in RetroPeelsResults::readPeel(...)"<<endl;
+        cout<<"Could not open results file '"<<fn<<"' for peel "<<p<<endl;
+        return 0;
+    }
+    std::string line;
+    std::getline(is,line);//skip header
+    while (std::getline(is,line)){
+        for (unsigned int i=0;i<line.size();i++) if (line[i]==',') line[i]=' ';
+        std::istringstream iss(line);
+        int peel; std::string type; int y; double v;
+        if (!(iss>>peel>>type>>y>>v)) continue;
+        if (type=="objFun") objFun_p(p) = v; else
+        if (type=="OFL")    ofl_p(p)    = v; else
+        if ((mnYr<=y)&&(y<=mxYr)){
+            if (type=="MMB") mmb_py(p,y) = v; else
+            if (type=="MFB") mfb_py(p,y) = v; else
+            if (type=="R")   R_py(p,y)   = v;
+        }
+    }
+    hasPeel(p) = 1;
+    if (debug) cout<<"finished RetroPeelsResults::readPeel("<<p<<cc<<fn<<")"<<endl;
+    return 1;
+}
+
+/**
+ * Calculate Mohn's rho for a quantity by peel and year, using the
+ * terminal year of each peel relative to peel 0:
+ *  rho = (1/n) sum_p [v(p,mxYr-p) - v(0,mxYr-p)]/v(0,mxYr-p)
+ *
+ * Peels without results are skipped.
+ *
+ * @param v_py - dmatrix with values by peel, year
+ *
+ * @return Mohn's rho
+ */
+double RetroPeelsResults::calcMohnsRho(dmatrix& v_py){
+    double rho = 0.0;
+    int n = 0;
+    if (hasPeel(0)){
+        for (int p=1;p<=nPeels;p++){
+            int y = mxYr-p;
+            if (hasPeel(p)&&(y>=mnYr)&&(v_py(0,y)>0.0)){
+                rho += (v_py(p,y)-v_py(0,y))/v_py(0,y);
+                n++;
+            }
+        }
+    }
+    if (n) rho /= n;
+    return rho;
+}
+
+/**
+ * Calculate Mohn's rho for a quantity with a single value per peel.
+ *
+ * @param v_p - dvector with values by peel
+ *
+ * @return Mohn's rho
+ */
+double RetroPeelsResults::calcMohnsRho(dvector& v_p){
+    double rho = 0.0;
+    int n = 0;
+    if (hasPeel(0)&&(v_p(0)>0.0)){
+        for (int p=1;p<=nPeels;p++){
+            if (hasPeel(p)){
+                rho += (v_p(p)-v_p(0))/v_p(0);
+                n++;
+            }
+        }
+    }
+    if (n) rho /= n;
+    return rho;
+}
+
+/**
+ * Write all peel results and Mohn's rho values to an output
+ * stream in csv format.
+ *
+ * @param os - output stream
+ */
+void RetroPeelsResults::writeToCSV(ostream& os){
+    os<<"peel,terminal.year,type,year,value"<<endl;
+    for (int p=0;p<=nPeels;p++){
+        if (hasPeel(p)){
+            os<<p<<cc<<mxYr-p<<cc<<"objFun"<<cc<<"NA"<<cc<<objFun_p(p)<<endl;
+            os<<p<<cc<<mxYr-p<<cc<<"OFL"   <<cc<<"NA"<<cc<<ofl_p(p)<<endl;
+            for (int y=mnYr;y<=mxYr-p;y++) os<<p<<cc<<mxYr-p<<cc<<"MMB"<<cc<<y<<cc<<mmb_py(p,y)<<endl;
+            for (int y=mnYr;y<=mxYr-p;y++) os<<p<<cc<<mxYr-p<<cc<<"MFB"<<cc<<y<<cc<<mfb_py(p,y)<<endl;
+            for (int y=mnYr;y<=mxYr-p;y++) os<<p<<cc<<mxYr-p<<cc<<"R"  <<cc<<y<<cc<<R_py(p,y)<<endl;
+        }
+    }
+    os<<"NA,NA,rho.MMB,NA,"<<calcMohnsRho(mmb_py)<<endl;
+    os<<"NA,NA,rho.MFB,NA,"<<calcMohnsRho(mfb_py)<<endl;
+    os<<"NA,NA,rho.R,NA," <<calcMohnsRho(R_py)<<endl;
+    os<<"NA,NA,rho.OFL,NA,"<<calcMohnsRho(ofl_p)<<endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//JitterRunsResults
+////////////////////////////////////////////////////////////////////////////////
+/**flag to print debug info*/
+int JitterRunsResults::debug = 0;
+/**
+ * Constructor.
+ *
+ * @param npRuns - number of jitter runs
+ * @param pTol - tolerance on objective function for convergence to best run
+ */
+JitterRunsResults::JitterRunsResults(int npRuns, double pTol){
+    nRuns = npRuns;
+    nStop = 0;
+    tol = pTol;
+    done.allocate(1,nRuns);    done.initialize();
+    seed.allocate(1,nRuns);    seed.initialize();
+    objFun.allocate(1,nRuns);  objFun.initialize();
+    maxGrad.allocate(1,nRuns); maxGrad.initialize();
+    mmb.allocate(1,nRuns);     mmb.initialize();
+    R.allocate(1,nRuns);       R.initialize();
+    hasOFL.allocate(1,nRuns);  hasOFL.initialize();
+    ofl.allocate(1,nRuns);     ofl.initialize();
+}
+
+/**
+ * Read results for a single run from a csv file written by
+ * tcsam::writeJitterRunResults(...).
+ *
+ * @param r - run
+ * @param fn - name of csv file
+ *
+ * @return 1 if successful, 0 otherwise
+ */
+int JitterRunsResults::readRun(int r, adstring fn){
+    if (debug) cout<<"starting JitterRunsResults::readRun("<<r<<cc<<fn<<")"<<endl;
+    ifstream is((char*) fn);
+    if (!is.good()) {
+        cout<<"Warning in JitterRunsResults::readRun(...)"<<endl;
+        cout<<"Could not open results file '"<<fn<<"' for run "<<r<<endl;
+        return 0;
+    }
+    std::string line;
+    std::getline(is,line);//skip header
+    std::getline(is,line);
+    for (unsigned int i=0;i<line.size();i++) if (line[i]==',') line[i]=' ';
+    std::istringstream iss(line);
+    int run; std::string strOFL;
+    if (!(iss>>run>>seed(r)>>objFun(r)>>maxGrad(r)>>mmb(r)>>R(r)>>strOFL)) {
+        cout<<"Warning in JitterRunsResults::readRun(...)"<<endl;
+        cout<<"Could not parse results for run "<<r<<" from '"<<fn<<"'"<<endl;
+        return 0;
+    }
+    hasOFL(r) = (strOFL!="NA");
+    ofl(r) = hasOFL(r) ? atof(strOFL.c_str()) : 0.0;
+    done(r) = 1;
+    if (debug) cout<<"finished JitterRunsResults::readRun("<<r<<cc<<fn<<")"<<endl;
+    return 1;
+}
+
+/**
+ * Read the results for a finished run from its sub-folder (jitter.r) and 
+ * test whether nStop runs have converged to the best run.
+ *
+ * @param r - run
+ * @param status - exit status of the run (results are read only if 0)
+ *
+ * @return 1 to stop the remaining runs, 0 to continue
+ */
+int JitterRunsResults::finished(int r, int status){
+    if (status==0) readRun(r,"jitter."+itoa(r,10)+"/TCSAM2015.jitter.csv");
+    if (nStop&&(getNumConverged()>=nStop)){
+        cout<<"#--"<<getNumConverged()<<" jitter runs converged to best."<<endl;
+        rpt::echo<<"#--"<<getNumConverged()<<" jitter runs converged to best."<<endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Get the index of the finished run with the smallest objective function value.
+ *
+ * @return run index (0 if no runs have finished)
+ */
+int JitterRunsResults::getBestRun(void){
+    int best = 0;
+    for (int r=1;r<=nRuns;r++){
+        if (done(r)&&((best==0)||(objFun(r)<objFun(best)))) best = r;
+    }
+    return best;
+}
+
+/**
+ * Get the number of finished runs with objective function values
+ * within tol of the best run.
+ *
+ * @return number of converged runs
+ */
+int JitterRunsResults::getNumConverged(void){
+    int best = getBestRun();
+    if (!best) return 0;
+    int n = 0;
+    for (int r=1;r<=nRuns;r++){
+        if (done(r)&&(objFun(r)-objFun(best)<=tol)) n++;
+    }
+    return n;
+}
+
+/**
+ * Write results for all finished runs to an output stream in csv format.
+ *
+ * @param os - output stream
+ */
+void JitterRunsResults::writeToCSV(ostream& os){
+    int best = getBestRun();
+    os<<"run,seed,objfun,maxgrad,MMB,R,OFL,converged,best"<<endl;
+    for (int r=1;r<=nRuns;r++){
+        if (done(r)){
+            os<<r<<cc<<seed(r)<<cc<<objFun(r)<<cc<<maxGrad(r)<<cc<<mmb(r)<<cc<<R(r)<<cc;
+            if (hasOFL(r)) os<<ofl(r)<<cc; else os<<"NA"<<cc;
+            os<<(objFun(r)-objFun(best)<=tol)<<cc<<(r==best)<<endl;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//ProfileResults
+////////////////////////////////////////////////////////////////////////////////
+/**flag to print debug info*/
+int ProfileResults::debug = 0;
+/**
+ * Constructor.
+ *
+ * @param plbl - label of profiled parameter
+ * @param pGrid - profiled parameter values
+ */
+ProfileResults::ProfileResults(adstring plbl, const dvector& pGrid){
+    lbl = plbl;
+    nPoints = pGrid.size();
+    grid.allocate(1,nPoints);    grid = pGrid;
+    done.allocate(1,nPoints);    done.initialize();
+    objFun.allocate(1,nPoints);  objFun.initialize();
+    maxGrad.allocate(1,nPoints); maxGrad.initialize();
+    nll_kc.allocate(1,nPoints,1,tcsam::nObjFunComps); nll_kc.initialize();
+}
+
+/**
+ * Read results for a single grid point from a csv file written by
+ * tcsam::writeProfilePointResults(...).
+ *
+ * @param k - grid point
+ * @param fn - name of csv file
+ *
+ * @return 1 if successful, 0 otherwise
+ */
+int ProfileResults::readPoint(int k, adstring fn){
+    if (debug) cout<<"starting ProfileResults::readPoint("<<k<<cc<<fn<<")"<<endl;
+    ifstream is((char*) fn);
+    if (!is.good()) {
+        cout<<"Warning in ProfileResults::readPoint(...)"<<endl;
+        cout<<"Could not open results file '"<<fn<<"' for point "<<k<<endl;
+        return 0;
+    }
+    std::string line;
+    std::getline(is,line);//skip header
+    std::getline(is,line);
+    for (unsigned int i=0;i<line.size();i++) if (line[i]==',') line[i]=' ';
+    std::istringstream iss(line);
+    int pt; double val;
+    iss>>pt>>val>>objFun(k)>>maxGrad(k);
+    for (int c=1;c<=tcsam::nObjFunComps;c++) iss>>nll_kc(k,c);
+    if (iss.fail()) {
+        cout<<"Warning in ProfileResults::readPoint(...)"<<endl;
+        cout<<"Could not parse results for point "<<k<<" from '"<<fn<<"'"<<endl;
+        return 0;
+    }
+    done(k) = 1;
+    if (debug) cout<<"finished ProfileResults::readPoint("<<k<<cc<<fn<<")"<<endl;
+    return 1;
+}
+
+/**
+ * Write results for all finished grid points to an output stream
+ * in csv format, including differences from the minimum objective
+ * function value for each component.
+ *
+ * @param os - output stream
+ */
+void ProfileResults::writeToCSV(ostream& os){
+    int best = 0;
+    for (int k=1;k<=nPoints;k++) if (done(k)&&((best==0)||(objFun(k)<objFun(best)))) best = k;
+    os<<"point,parameter,value,objfun,maxgrad,delta.objfun";
+    for (int c=1;c<=tcsam::nObjFunComps;c++) os<<cc<<tcsam::STR_OBJFUN_COMPS[c-1];
+    for (int c=1;c<=tcsam::nObjFunComps;c++) os<<cc<<"delta."<<tcsam::STR_OBJFUN_COMPS[c-1];
+    os<<endl;
+    for (int k=1;k<=nPoints;k++){
+        if (done(k)){
+            os<<k<<cc<<lbl<<cc<<grid(k)<<cc<<objFun(k)<<cc<<maxGrad(k)<<cc<<objFun(k)-objFun(best);
+            for (int c=1;c<=tcsam::nObjFunComps;c++) os<<cc<<nll_kc(k,c);
+            for (int c=1;c<=tcsam::nObjFunComps;c++) os<<cc<<nll_kc(k,c)-nll_kc(best,c);
+            os<<endl;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//EnvelopeCholesky
+////////////////////////////////////////////////////////////////////////////////
+/**flag to print debug info*/
+int EnvelopeCholesky::debug = 0;
+/**
+ * Constructor. Allocates the envelope (initialized to zero).
+ *
+ * @param first_ - index of the first element in the envelope, by row
+ * (indices starting at 1, first(i)<=i)
+ */
+EnvelopeCholesky::EnvelopeCholesky(const ivector& first_){
+    n = first_.indexmax();
+    ok = 0;
+    first.allocate(1,n);
+    ivector last(1,n);
+    for (int i=1;i<=n;i++){
+        first(i) = ((1<=first_(i))&&(first_(i)<=i)) ? first_(i) : 1;
+        last(i)  = i;
+    }
+    if (debug) cout<<"EnvelopeCholesky: envelope fraction = "<<getEnvelopeFraction()<<endl;
+    L.allocate(1,n,first,last); L.initialize();
+}
+
+/**
+ * Add v to H(i,j) (stored as H(max(i,j),min(i,j))) if it is inside the
+ * envelope. Must be called before factor().
+ *
+ * @param i - row index
+ * @param j - column index
+ * @param v - value to add
+ *
+ * @return 1 if inside the envelope, 0 otherwise (v is ignored)
+ */
+int EnvelopeCholesky::add(int i, int j, double v){
+    if (i<j) {int k = i; i = j; j = k;}
+    if (j<first(i)) return 0;
+    L(i,j) += v;
+    return 1;
+}
+
+/**
+ * Factor H in place (fill-in is confined to the envelope).
+ *
+ * @return 1 if successful (i.e., H is positive definite), 0 otherwise
+ */
+int EnvelopeCholesky::factor(void){
+    ok = 0;
+    for (int i=1;i<=n;i++){
+        for (int j=first(i);j<=i;j++){
+            double s = L(i,j);
+            for (int k=max(first(i),first(j));k<j;k++) s -= L(i,k)*L(j,k);
+            if (j<i) {
+                L(i,j) = s/L(j,j);
+            } else {
+                if (s<=0.0) return 0;
+                L(i,i) = sqrt(s);
+            }
+        }
+    }
+    ok = 1;
+    return 1;
+}
+
+/**
+ * Get the fraction of the lower triangle of H stored in the envelope.
+ *
+ * @return envelope fraction
+ */
+double EnvelopeCholesky::getEnvelopeFraction(void){
+    double nEnv = 0.0;
+    for (int i=1;i<=n;i++) nEnv += i-first(i)+1;
+    return nEnv/(0.5*n*(n+1));
+}
+
+/**
+ * Calculate b'inv(H)b by solving L z = b (so b'inv(H)b = z'z). Leading
+ * zeros in b are skipped.
+ *
+ * @param b - vector (indices starting at 1)
+ *
+ * @return b'inv(H)b
+ */
+double EnvelopeCholesky::calcQuadForm(const dvector& b){
+    int i0 = 1;
+    while ((i0<=n)&&(b(i0)==0.0)) i0++;
+    dvector z(1,n); z.initialize();
+    double q = 0.0;
+    for (int i=i0;i<=n;i++){
+        double s = b(i);
+        for (int k=max(first(i),i0);k<i;k++) s -= L(i,k)*z(k);
+        z(i) = s/L(i,i);
+        q += z(i)*z(i);
+    }
+    return q;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//RunManifest
+////////////////////////////////////////////////////////////////////////////////
+/**flag to print debug info*/
+int RunManifest::debug = 0;
+/**
+ * Read the manifest from a file. Each line that is not blank and does not
+ * start with '#' defines a task as a task name followed by the command line
+ * options for the task.
+ *
+ * @param fn - name of file
+ *
+ * @return 1 if successful, 0 otherwise
+ */
+int RunManifest::read(adstring fn){
+    if (debug) cout<<"starting RunManifest::read("<<fn<<")"<<endl;
+    ifstream is((char*) fn);
+    if (!is.good()) {
+        cout<<"Error in RunManifest::read(...)"<<endl;
+        cout<<"Could not open manifest file '"<<fn<<"'"<<endl;
+        return 0;
+    }
+    names.clear();
+    opts.clear();
+    std::string line;
+    while (std::getline(is,line)){
+        std::istringstream iss(line);
+        std::string name;
+        if ((!(iss>>name))||(name[0]=='#')) continue;
+        std::vector<std::string> taskOpts;
+        std::string opt;
+        while (iss>>opt) taskOpts.push_back(opt);
+        names.push_back(name);
+        opts.push_back(taskOpts);
+    }
+    nTasks = names.size();
+    if (!nTasks){
+        cout<<"Error in RunManifest::read(...)"<<endl;
+        cout<<"No tasks found in '"<<fn<<"'"<<endl;
+        return 0;
+    }
+    if (debug) cout<<"finished RunManifest::read("<<fn<<"): "<<nTasks<<" tasks"<<endl;
+    return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//tcsam functions
+////////////////////////////////////////////////////////////////////////////////
+/**
+ * Makes a filename relative to directory 'dir' (e.g., "..") if it is not
+ * an absolute path.
+ *
+ * @param dir - directory to rebase to
+ * @param fn - filename
+ *
+ * @return rebased filename
+ */
+adstring tcsam::rebaseFilePath(adstring dir, adstring fn){
+    if (!fn.size()) return fn;
+    if ((fn(1)=='/')||(fn(1)=='\\')) return fn;          //absolute path
+    if ((fn.size()>1)&&(fn(2)==':')) return fn;          //absolute path (Windows)
+    return wts::concatenateFilePaths(dir,fn);
+}
+
+/**
+ * Creates a directory (if it doesn't exist).
+ *
+ * @param dir - name of directory
+ *
+ * @return 1 if the directory exists after the call, 0 otherwise
+ */
+int tcsam::makeDirectory(adstring dir){
+#if !defined(_WIN32)
+    mkdir((char*) dir,0755);//ok if it already exists
+#else
+    _mkdir((char*) dir);//ok if it already exists
+#endif
+    struct stat info;
+    return ((stat((char*) dir,&info)==0)&&(info.st_mode&S_IFDIR));
+}
+
+/**
+ * Tests whether a file exists (and can be opened for reading).
+ *
+ * @param fn - name of file
+ *
+ * @return 1 if the file exists, 0 otherwise
+ */
+int tcsam::fileExists(adstring fn){
+    ifstream is((char*) fn);
+    return is.good();
+}
+
+/**
+ * Calculates a short signature (64-bit FNV-1a hash, as a hex string)
+ * for a string (e.g., a description of the parameter structure).
+ *
+ * @param str - string to calculate signature for
+ *
+ * @return signature as 16-character hex string
+ */
+adstring tcsam::calcSignature(const std::string& str){
+    uint64_t h = 14695981039346656037ULL;
+    for (unsigned int i=0;i<str.size();i++){
+        h ^= (unsigned char) str[i];
+        h *= 1099511628211ULL;
+    }
+    char buf[17];
+    for (int i=15;i>=0;i--) {buf[i] = "0123456789abcdef"[h&0xf]; h >>= 4;}
+    buf[16] = '\0';
+    return adstring(buf);
+}
+
+/**
+ * Gets the current wall-clock time, in seconds (with sub-second resolution).
+ *
+ * @return wall-clock time in seconds since an arbitrary origin
+ */
+double tcsam::getWallTime(void){
+#if !defined(_WIN32)
+    struct timeval tv;
+    gettimeofday(&tv,0);
+    return ((double) tv.tv_sec)+1.0e-6*tv.tv_usec;
+#else
+    struct _timeb tb;
+    _ftime(&tb);
+    return ((double) tb.time)+1.0e-3*tb.millitm;
+#endif
+}
+
+/**
+ * Appends options to the command line (ad_comm::argc, ad_comm::argv)
+ * so they are found by subsequent calls to option_match(...).
+ *
+ * The new argv array (and the appended strings) persist for the life
+ * of the process.
+ *
+ * @param opts - vector of options to append
+ */
+void tcsam::appendCommandLineOptions(const std::vector<std::string>& opts){
+    int n = ad_comm::argc+opts.size();
+    char** argv = new char*[n+1];
+    for (int i=0;i<ad_comm::argc;i++) argv[i] = ad_comm::argv[i];
+    for (unsigned int i=0;i<opts.size();i++){
+        argv[ad_comm::argc+i] = new char[opts[i].size()+1];
+        strcpy(argv[ad_comm::argc+i],opts[i].c_str());
+    }
+    argv[n] = 0;
+    ad_comm::argc = n;
+    ad_comm::argv = argv;
+}
+
+/**
+ * Rebases the filename following a command line option (if the option
+ * is present) relative to directory 'dir' (see rebaseFilePath(...)).
+ *
+ * @param opt - command line option (e.g., "-ainp")
+ * @param dir - directory to rebase to
+ *
+ * @return 1 if the option was found, 0 otherwise
+ */
+int tcsam::rebaseCommandLineOption(adstring opt, adstring dir){
+    int on = option_match(ad_comm::argc,ad_comm::argv,(char*) opt);
+    if ((on<0)||(on+1>=ad_comm::argc)) return 0;
+    adstring fn = tcsam::rebaseFilePath(dir,adstring(ad_comm::argv[on+1]));
+    ad_comm::argv[on+1] = new char[fn.size()+1];
+    strcpy(ad_comm::argv[on+1],(char*) fn);
+    return 1;
+}
+
+/**
+ * Marks the task run in the current working directory as completed
+ * by writing the file TCSAM2015.task.done.
+ */
+void tcsam::markTaskDone(void){
+    time_t now;
+    time(&now);
+    ofstream os("TCSAM2015.task.done", ios::trunc);
+    os<<"completed "<<ctime(&now);
+    os.close();
+}
+
+/**
+ * Exits a driver process (-retroPeels, -jitterRuns, -profile, -parHess,
+ * -opModBatch) after it has written its results. If the process runs a
+ * manifest task (iTask>0), the task is marked as completed only if every 
+ * worker was successful, so a re-submitted task is run again.
+ *
+ * @param iTask - manifest task being run (<=0 if none)
+ * @param res - result from runWorkers(...) in the driver (0 if every worker was successful)
+ *
+ * does not return (exits with status 0 if res==0, 1 otherwise)
+ */
+void tcsam::exitDriver(int iTask, int res){
+    if (res==0){
+        if (iTask>0) tcsam::markTaskDone();
+        exit(0);
+    }
+    cout<<"#--Not all workers finished successfully (see above)."<<endl;
+    rpt::echo<<"#--Not all workers finished successfully."<<endl;
+    if (iTask>0) cout<<"#--Task "<<iTask<<" was not marked as completed."<<endl;
+    exit(1);
+}
+
+/**
+ * Tests whether the task run in directory 'dir' has been completed.
+ *
+ * @param dir - task directory
+ *
+ * @return 1 if the task was completed, 0 otherwise
+ */
+int tcsam::isTaskDone(adstring dir){
+    return tcsam::fileExists(wts::concatenateFilePaths(dir,"TCSAM2015.task.done"));
+}
+
+/**
+ * Creates a sub-directory for a worker run (if it doesn't exist) and
+ * changes the working directory to it. The input filenames in the
+ * ModelConfiguration object are rebased so they can still be read.
+ *
+ * The rpt::echo stream is re-opened in the sub-directory.
+ *
+ * @param dir - name of sub-directory
+ * @param ptrMC - pointer to ModelConfiguration object
+ *
+ * @return 1 if successful, 0 otherwise
+ */
+int tcsam::changeToRunDirectory(adstring dir, ModelConfiguration* ptrMC){
+    tcsam::makeDirectory(dir);
+#if !defined(_WIN32)
+    if (chdir((char*) dir)){
+#else
+    if (_chdir((char*) dir)){
+#endif
+        cout<<"Error in tcsam::changeToRunDirectory(...)"<<endl;
+        cout<<"Could not change working directory to '"<<dir<<"'"<<endl;
+        return 0;
+    }
+    ptrMC->fnMPI = tcsam::rebaseFilePath("..",ptrMC->fnMPI);
+    ptrMC->fnMDS = tcsam::rebaseFilePath("..",ptrMC->fnMDS);
+    ptrMC->fnMOs = tcsam::rebaseFilePath("..",ptrMC->fnMOs);
+    rpt::echo.close();
+    rpt::echo.open("EchoData.dat",std::ios::trunc);
+    return 1;
+}
+
+/**
+ * Forks a worker process without waiting for it to finish.
+ *
+ * @return 0 in the worker process, the worker's process id in the
+ * parent, -1 if the fork failed
+ */
+int tcsam::forkWorker(void){
+    cout.flush();
+#if defined(_WIN32)
+    cout<<"Error in tcsam::forkWorker(): worker processes are not supported on Windows."<<endl;
+    return -1;
+#else
+    pid_t pid = fork();
+    if (pid<0) cout<<"Error in tcsam::forkWorker(): fork failed."<<endl;
+    return (int) pid;
+#endif
+}
+
+/**
+ * Waits for any worker process to finish.
+ *
+ * @param status - (output) exit status of the finished worker
+ *
+ * @return process id of the finished worker (<=0 if there are no workers)
+ */
+int tcsam::waitForWorker(int& status){
+    status = 0;
+#if defined(_WIN32)
+    return -1;
+#else
+    int res = 0;
+    pid_t pid;
+    while (((pid = waitpid(-1,&res,0))<0)&&(errno==EINTR));//retry if interrupted by a signal
+    status = WIFEXITED(res) ? WEXITSTATUS(res) : -1;
+    return (int) pid;
+#endif
+}
+
+/**
+ * Terminates a worker process.
+ *
+ * @param pid - process id of the worker
+ */
+void tcsam::killWorker(int pid){
+#if !defined(_WIN32)
+    if (pid>0) kill((pid_t) pid,SIGTERM);
+#endif
+}
+
+/**
+ * Runs r1:r2 in forked worker processes, at most nConcurrent at a time,
+ * starting them in order. In the driver, waits for every worker and 
+ * records its exit status. If pWM is given, it is notified as each run
+ * finishes and can stop the remaining runs (running workers are 
+ * terminated). If a fork fails, no further runs are started and the 
+ * running workers are terminated.
+ *
+ * @param r1 - first run
+ * @param r2 - last run
+ * @param nConcurrent - maximum number of concurrent workers (1 runs them sequentially)
+ * @param lbl - label for a run in progress messages (e.g., "jitter run")
+ * @param r - (output) run to do in a worker process (r1-1 in the driver)
+ * @param status_r - (output) exit status by run (driver only): 0 if successful,
+ *      >0 if the run exited with an error, -1 if it terminated abnormally,
+ *      -2 if it was stopped (or never started)
+ * @param pWM - pointer to a WorkerMonitor (may be 0)
+ *
+ * @return 1 in a worker process, 0 in the driver if every run that was not 
+ * stopped was successful, -1 in the driver otherwise (or if a fork failed)
+ */
+int tcsam::runWorkers(int r1, int r2, int nConcurrent, adstring lbl, int& r, ivector& status_r, WorkerMonitor* pWM){
+    r = r1-1;
+    status_r.deallocate();
+    status_r.allocate(r1,r2); status_r = -2;
+    ivector pids(r1,r2); pids.initialize();//process id by run (0 if not running)
+    int nxt = r1;   //next run to start
+    int nActive = 0;//number of running workers
+    int stop = 0;   //flag to stop starting new runs
+    int ok = 1;     //flag indicating all runs (not stopped) were successful
+    while (((!stop)&&(nxt<=r2))||(nActive>0)){
+        if ((!stop)&&(nxt<=r2)&&(nActive<nConcurrent)){
+            int pid = tcsam::forkWorker();
+            if (pid==0) {r = nxt; return 1;}//worker process for run nxt
+            if (pid<0){
+                ok = 0; stop = 1;
+                for (int i=r1;i<nxt;i++) tcsam::killWorker(pids(i));
+                continue;
+            }
+            cout<<"#--Started "<<lbl<<" "<<nxt<<endl;
+            rpt::echo<<"#--Started "<<lbl<<" "<<nxt<<endl;
+            pids(nxt++) = pid;
+            nActive++;
+        } else {
+            int status = 0;
+            int pid = tcsam::waitForWorker(status);
+            if (pid<=0) {ok = 0; break;}//lost track of running workers
+            for (int i=r1;i<nxt;i++){
+                if (pids(i)==pid){
+                    pids(i) = 0;
+                    nActive--;
+                    status_r(i) = (stop&&(status==-1)) ? -2 : status;//terminated by the driver
+                    if (status_r(i)==-2){
+                        cout<<"#--Stopped "<<lbl<<" "<<i<<endl;
+                        rpt::echo<<"#--Stopped "<<lbl<<" "<<i<<endl;
+                    } else {
+                        cout<<"#--Finished "<<lbl<<" "<<i<<" with exit status "<<status_r(i)<<endl;
+                        rpt::echo<<"#--Finished "<<lbl<<" "<<i<<" with exit status "<<status_r(i)<<endl;
+                        if (status_r(i)!=0) ok = 0;
+                    }
+                    if ((!stop)&&pWM&&pWM->finished(i,status_r(i))){
+                        cout<<"#--Stopping remaining "<<lbl<<"s"<<endl;
+                        rpt::echo<<"#--Stopping remaining "<<lbl<<"s"<<endl;
+                        stop = 1;
+                        for (int j=r1;j<nxt;j++) tcsam::killWorker(pids(j));
+                    }
+                }
+            }
+        }
+    }
+    return ok ? 0 : -1;
+}
+
+/**
+ * Write single-peel retrospective results to csv file for
+ * later aggregation by RetroPeelsResults.
+ *
+ * @param os - output stream
+ * @param peel - retrospective peel
+ * @param objFun - objective function value
+ * @param spB_yx - mature biomass at mating time, by year and sex
+ * @param R_y - total recruitment, by year
+ * @param doOFL - flag indicating OFL was calculated
+ * @param OFL - OFL value
+ */
+void tcsam::writeRetroPeelResults(ostream& os, int peel, double objFun,
+                                  const dmatrix& spB_yx, const dvector& R_y,
+                                  int doOFL, double OFL){
+    os<<"peel,type,year,value"<<endl;
+    os<<peel<<cc<<"objFun"<<cc<<0<<cc<<objFun<<endl;
+    if (doOFL) os<<peel<<cc<<"OFL"<<cc<<0<<cc<<OFL<<endl;
+    for (int y=spB_yx.indexmin();y<=spB_yx.indexmax();y++){
+        os<<peel<<cc<<"MMB"<<cc<<y<<cc<<spB_yx(y,tcsam::MALE)<<endl;
+        if (tcsam::nSXs>1) os<<peel<<cc<<"MFB"<<cc<<y<<cc<<spB_yx(y,tcsam::FEMALE)<<endl;
+    }
+    for (int y=R_y.indexmin();y<=R_y.indexmax();y++) os<<peel<<cc<<"R"<<cc<<y<<cc<<R_y(y)<<endl;
+}
+
+/**
+ * Write results for a single jitter run to csv file for later
+ * aggregation by JitterRunsResults.
+ *
+ * @param os - output stream
+ * @param run - jitter run
+ * @param seed - rng seed used for jittering
+ * @param objFun - objective function value
+ * @param maxGrad - max gradient
+ * @param mmb - final year mature male biomass
+ * @param R - final year recruitment
+ * @param doOFL - flag indicating OFL was calculated
+ * @param OFL - OFL value (written as NA if not calculated)
+ */
+void tcsam::writeJitterRunResults(ostream& os, int run, int seed, double objFun, double maxGrad,
+                                  double mmb, double R, int doOFL, double OFL){
+    os<<"run,seed,objfun,maxgrad,MMB,R,OFL"<<endl;
+    os<<run<<cc<<seed<<cc<<objFun<<cc<<maxGrad<<cc<<mmb<<cc<<R<<cc;
+    if (doOFL) os<<OFL<<endl; else os<<"NA"<<endl;
+}
+
+/**
+ * Parse a parameter label of the form "name[i]" (or "name", for i=1).
+ *
+ * @param lbl - parameter label
+ * @param name - (output) parameter name
+ * @param idx - (output) element index
+ *
+ * @return 1 if successful, 0 otherwise
+ */
+int tcsam::parseParameterLabel(adstring lbl, adstring& name, int& idx){
+    std::string str((char*) lbl);
+    size_t i1 = str.find('[');
+    idx = 1;
+    if (i1==std::string::npos) {name = lbl; return (str.size()>0);}
+    size_t i2 = str.find(']',i1);
+    if ((i1==0)||(i2==std::string::npos)) return 0;
+    name = adstring(str.substr(0,i1).c_str());
+    std::istringstream(str.substr(i1+1,i2-i1-1))>>idx;
+    return (idx>0);
+}
+
+/**
+ * Parse a grid of values specified as "min:max:n" (n equally-spaced
+ * values) or as a comma-separated list.
+ *
+ * @param str - grid specification
+ *
+ * @return dvector of grid values (indices starting at 1, empty on error)
+ */
+dvector tcsam::parseGrid(adstring str){
+    std::string s((char*) str);
+    std::vector<double> vals;
+    if (s.find(':')!=std::string::npos){
+        for (unsigned int i=0;i<s.size();i++) if (s[i]==':') s[i]=' ';
+        std::istringstream iss(s);
+        double mn, mx; int n;
+        if ((iss>>mn>>mx>>n)&&(n>0)){
+            for (int i=0;i<n;i++) vals.push_back((n>1) ? mn+i*(mx-mn)/(n-1) : mn);
+        }
+    } else {
+        for (unsigned int i=0;i<s.size();i++) if (s[i]==',') s[i]=' ';
+        std::istringstream iss(s);
+        double v;
+        while (iss>>v) vals.push_back(v);
+    }
+    dvector grid;
+    if (vals.size()){
+        grid.allocate(1,vals.size());
+        for (unsigned int i=0;i<vals.size();i++) grid(i+1) = vals[i];
+    }
+    return grid;
+}
+
+/**
+ * Write results for a single likelihood profile point to csv file
+ * for later aggregation by ProfileResults.
+ *
+ * @param os - output stream
+ * @param k - grid point
+ * @param val - profiled parameter value
+ * @param objFun - objective function value
+ * @param maxGrad - max gradient
+ * @param nlls - objective function components (see tcsam::STR_OBJFUN_COMPS)
+ */
+void tcsam::writeProfilePointResults(ostream& os, int k, double val, double objFun, double maxGrad,
+                                     const dvector& nlls){
+    os<<"point,value,objfun,maxgrad";
+    for (int c=1;c<=tcsam::nObjFunComps;c++) os<<cc<<tcsam::STR_OBJFUN_COMPS[c-1];
+    os<<endl;
+    os<<k<<cc<<val<<cc<<objFun<<cc<<maxGrad;
+    for (int c=nlls.indexmin();c<=nlls.indexmax();c++) os<<cc<<nlls(c);
+    os<<endl;
+}
+
+/**
+ * Write a row of values to a binary output stream as doubles.
+ *
+ * @param os - output stream (opened in binary mode)
+ * @param row - values to write
+ */
+void tcsam::writeBinaryRow(ostream& os, const dvector& row){
+    for (int i=row.indexmin();i<=row.indexmax();i++){
+        double v = row(i);
+        os.write((char*) &v,sizeof(double));
+    }
+}
+
+/**
+ * Merge binary files with rows of doubles written by worker processes
+ * (named fn.1, fn.2, ..., fn.nParts) into a single binary table. The
+ * table starts with the number of rows and columns (as 32-bit ints),
+ * followed by the values (as doubles) in row-major order.
+ *
+ * All part files are checked (existence and total size) before the
+ * table is written. The table is written to a temporary file that
+ * replaces fn only on success; the part files are then removed. On
+ * failure, fn is removed and the part files are kept.
+ *
+ * @param fn - name of binary table file
+ * @param nParts - number of part files
+ * @param nRows - total number of rows
+ * @param nCols - number of columns
+ *
+ * @return 1 if successful, 0 otherwise
+ */
+int tcsam::mergeBinaryTables(adstring fn, int nParts, int nRows, int nCols){
+    //check part files before writing anything
+    long nBytes = 0;
+    for (int k=1;k<=nParts;k++){
+        adstring fnp = fn+"."+itoa(k,10);
+        struct stat st;
+        if (stat((char*) fnp,&st)!=0){
+            cout<<"Error in tcsam::mergeBinaryTables(...)"<<endl;
+            cout<<"Could not find part file '"<<fnp<<"'"<<endl;
+            remove((char*) fn);
+            return 0;
+        }
+        nBytes += (long) st.st_size;
+    }
+    if (nBytes!=((long) nRows)*nCols*((long) sizeof(double))){
+        cout<<"Error in tcsam::mergeBinaryTables(...)"<<endl;
+        cout<<"Part files for '"<<fn<<"' have "<<nBytes<<" bytes of values, expected "
+            <<((long) nRows)*nCols*((long) sizeof(double))<<endl;
+        remove((char*) fn);
+        return 0;
+    }
+    
+    adstring fnt = fn+".tmp";
+    ofstream os((char*) fnt, ios::binary|ios::trunc);
+    if (!os.good()){
+        cout<<"Error in tcsam::mergeBinaryTables(...)"<<endl;
+        cout<<"Could not open binary table file '"<<fnt<<"'"<<endl;
+        remove((char*) fn);
+        return 0;
+    }
+    int32_t hdr[2] = {nRows,nCols};
+    os.write((char*) hdr,sizeof(hdr));
+    int res = 1;
+    for (int k=1;(k<=nParts)&&res;k++){
+        adstring fnp = fn+"."+itoa(k,10);
+        ifstream is((char*) fnp, ios::binary);
+        if (!is.good()){
+            cout<<"Error in tcsam::mergeBinaryTables(...)"<<endl;
+            cout<<"Could not open part file '"<<fnp<<"'"<<endl;
+            res = 0;
+            break;
+        }
+        os<<is.rdbuf();
+        is.close();
+    }
+    os.close();
+    if (res&&os.good()) remove((char*) fn);//rename does not replace existing files on Windows
+    if (res&&os.good()&&(rename((char*) fnt,(char*) fn)==0)){
+        for (int k=1;k<=nParts;k++){adstring fnp = fn+"."+itoa(k,10); remove((char*) fnp);}
+        return 1;
+    }
+    cout<<"Error in tcsam::mergeBinaryTables(...)"<<endl;
+    cout<<"Could not write binary table file '"<<fn<<"'"<<endl;
+    remove((char*) fnt);
+    remove((char*) fn);
+    return 0;
+}
+
+/**
+ * Write a dmatrix to a binary table file. The table starts with the 
+ * number of rows and columns (as 32-bit ints), followed by the values 
+ * (as doubles) in row-major order.
+ *
+ * @param fn - name of binary table file
+ * @param m - dmatrix to write
+ *
+ * @return 1 if successful, 0 otherwise
+ */
+int tcsam::writeBinaryTable(adstring fn, const dmatrix& m){
+    ofstream os((char*) fn, ios::binary|ios::trunc);
+    if (!os.good()){
+        cout<<"Error in tcsam::writeBinaryTable(...)"<<endl;
+        cout<<"Could not open binary table file '"<<fn<<"'"<<endl;
+        return 0;
+    }
+    int32_t hdr[2] = {m.rowsize(),m.colsize()};
+    os.write((char*) hdr,sizeof(hdr));
+    for (int i=m.rowmin();i<=m.rowmax();i++) tcsam::writeBinaryRow(os,m(i));
+    os.close();
+    return 1;
+}
+
+/**
+ * Read the next row of doubles (written using writeBinaryRow(...))
+ * from a binary input stream.
+ *
+ * @param is - input stream (opened in binary mode)
+ * @param row - (output) vector to fill (its size is the number of values read)
+ *
+ * @return 1 if a complete row was read, 0 otherwise
+ */
+int tcsam::readBinaryRow(istream& is, dvector& row){
+    for (int i=row.indexmin();i<=row.indexmax();i++){
+        double v;
+        if (!is.read((char*) &v,sizeof(double))) return 0;
+        row(i) = v;
+    }
+    return 1;
+}
+
+/**
+ * Read all complete rows of nCols doubles (written using writeBinaryRow(...))
+ * from a binary file.
+ *
+ * @param fn - name of binary file
+ * @param nCols - number of values in each row
+ * @param nRows - (output) number of rows read
+ *
+ * @return dmatrix with rows 1:nRows and columns 1:nCols (unallocated if nRows=0)
+ */
+dmatrix tcsam::readBinaryRows(adstring fn, int nCols, int& nRows){
+    nRows = 0;
+    dmatrix m;
+    ifstream is((char*) fn, ios::binary);
+    if (!is.good()){
+        cout<<"Warning in tcsam::readBinaryRows(...)"<<endl;
+        cout<<"Could not open binary file '"<<fn<<"'"<<endl;
+        return m;
+    }
+    std::vector<double> vals;
+    double v;
+    while (is.read((char*) &v,sizeof(double))) vals.push_back(v);
+    nRows = vals.size()/nCols;
+    if (nRows){
+        m.allocate(1,nRows,1,nCols);
+        for (int i=1;i<=nRows;i++){
+            for (int j=1;j<=nCols;j++) m(i,j) = vals[(i-1)*nCols+j-1];
+        }
+    }
+    return m;
+}
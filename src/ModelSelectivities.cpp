@@ -158,6 +158,159 @@ const adstring SelFcns::STR_DBLLOGISTIC50LN95  ="dbllogistic50ln95";
 const adstring SelFcns::STR_DBLLOGISTICLN50LN95="dbllogisticln50ln95";
 const adstring SelFcns::STR_DBLNORMAL          ="dblnormal";
 
+/**
+ * Returns a copy of the size bins z extended by one element holding 
+ * the fully-selected size fsZ (if fsZ>0), so the normalization constant
+ * can be evaluated by the same kernel call as the curve itself.
+ * 
+ * @param z   - dvector of sizes at which to compute function values
+ * @param fsZ - size at which function = 1 (i.e., fully-selected size) [double]
+ * 
+ * @return - dvector
+ */
+dvector SelFcns::extendZ(dvector& z, double fsZ){
+    int mn = z.indexmin();
+    int mx = z.indexmax();
+    if (fsZ>0) mx++;
+    dvector zx(mn,mx);
+    for (int i=z.indexmin();i<=z.indexmax();i++) zx(i) = z(i);
+    if (fsZ>0) zx(mx) = fsZ;
+    return zx;
+}
+
+/**
+ * Evaluates the (unnormalized) ascending logistic kernel
+ *      r(z) = 1/(1+exp(-b*(z-a)))
+ * in double precision, together with its partial derivatives 
+ * w.r.t. q = (a,b).
+ * 
+ * @param z    - dvector of sizes
+ * @param a    - size at which r = 0.5
+ * @param b    - slope
+ * @param r    - (output) kernel values
+ * @param drdq - (output) dmatrix of partial derivatives (rows: z, columns: a,b)
+ */
+void SelFcns::kerLogistic(dvector& z, double a, double b, dvector& r, dmatrix& drdq){
+    int mn = z.indexmin();
+    int mx = z.indexmax();
+    r.allocate(mn,mx);
+    drdq.allocate(mn,mx,1,2);
+    for (int i=mn;i<=mx;i++){
+        double ri = 1.0/(1.0+exp(-b*(z(i)-a)));
+        double vi = ri*(1.0-ri);
+        r(i)      = ri;
+        drdq(i,1) = -b*vi;
+        drdq(i,2) = (z(i)-a)*vi;
+    }
+}
+
+/**
+ * Evaluates the (unnormalized) double logistic kernel
+ *      r(z) = 1/(1+exp(-ba*(z-a))) * 1/(1+exp(-bd*(d-z)))
+ * in double precision, together with its partial derivatives 
+ * w.r.t. q = (a,ba,d,bd).
+ * 
+ * @param z    - dvector of sizes
+ * @param a    - size at which ascending limb = 0.5
+ * @param ba   - ascending limb slope
+ * @param d    - size at which descending limb = 0.5
+ * @param bd   - descending limb slope
+ * @param r    - (output) kernel values
+ * @param drdq - (output) dmatrix of partial derivatives (rows: z, columns: a,ba,d,bd)
+ */
+void SelFcns::kerDblLogistic(dvector& z, double a, double ba, double d, double bd, dvector& r, dmatrix& drdq){
+    int mn = z.indexmin();
+    int mx = z.indexmax();
+    r.allocate(mn,mx);
+    drdq.allocate(mn,mx,1,4);
+    for (int i=mn;i<=mx;i++){
+        double ai = 1.0/(1.0+exp(-ba*(z(i)-a)));
+        double di = 1.0/(1.0+exp(-bd*(d-z(i))));
+        double va = ai*(1.0-ai)*di;
+        double vd = di*(1.0-di)*ai;
+        r(i)      = ai*di;
+        drdq(i,1) = -ba*va;
+        drdq(i,2) = (z(i)-a)*va;
+        drdq(i,3) = bd*vd;
+        drdq(i,4) = (d-z(i))*vd;
+    }
+}
+
+/**
+ * Normalizes kernel values r and records the resulting selectivity curve 
+ * on the gradient stack as a single node. The partial derivatives of the 
+ * curve w.r.t. the function parameters are computed here from drdp and saved, 
+ * so the adjoint (dfSelFcn) only has to apply the transposed jacobian.
+ * 
+ * Normalization follows the selectivity functions:
+ *      fsZ>0: divide by kernel value at fsZ (last element of r)
+ *      fsZ<0: divide by max kernel value over z
+ *      fsZ=0: no normalization
+ * 
+ * @param mn     - min index of size bins
+ * @param mx     - max index of size bins
+ * @param fsZ    - size at which function = 1 (i.e., fully-selected size) [double]
+ * @param r      - kernel values (from extendZ(z,fsZ))
+ * @param drdp   - partial derivatives of r w.r.t. params (columns indexed as params)
+ * @param params - dvar_vector of function parameters
+ * 
+ * @return - selectivity function values as dvar_vector
+ */
+dvar_vector SelFcns::assembleSelFcn(int mn, int mx, double fsZ, dvector& r, dmatrix& drdp, dvar_vector& params){
+    RETURN_ARRAYS_INCREMENT();
+    int mnp = params.indexmin();
+    int mxp = params.indexmax();
+    int k = mn;//index of normalizing value
+    int nrm = 0;
+    if (fsZ>0) {
+        k = mx+1; nrm = 1;
+    } else if (fsZ<0) {
+        for (int i=mn+1;i<=mx;i++) if (r(i)>r(k)) k = i;
+        nrm = 1;
+    }
+    dvector  v(mn,mx);
+    dmatrix dvdp(mn,mx,mnp,mxp);
+    for (int i=mn;i<=mx;i++){
+        if (nrm){
+            v(i) = r(i)/r(k);
+            for (int j=mnp;j<=mxp;j++) dvdp(i,j) = (drdp(i,j)-v(i)*drdp(k,j))/r(k);
+        } else {
+            v(i) = r(i);
+            for (int j=mnp;j<=mxp;j++) dvdp(i,j) = drdp(i,j);
+        }
+    }
+    
+    dvar_vector s(nograd_assign(v));
+    save_identifier_string("selA");
+    s.save_dvar_vector_position();
+    params.save_dvar_vector_position();
+    dvdp.save_dmatrix_value();
+    dvdp.save_dmatrix_position();
+    save_identifier_string("selB");
+    gradient_structure::GRAD_STACK1->set_gradient_stack(dfSelFcn);
+    RETURN_ARRAYS_DECREMENT();
+    return s;
+}
+
+/**
+ * Adjoint for assembleSelFcn: propagates the derivatives of the selectivity 
+ * curve back to the function parameters using the saved jacobian.
+ */
+void SelFcns::dfSelFcn(void){
+    verify_identifier_string("selB");
+    dmatrix_position dvdppos = restore_dmatrix_position();
+    dmatrix dvdp = restore_dmatrix_value(dvdppos);
+    dvar_vector_position ppos = restore_dvar_vector_position();
+    dvar_vector_position spos = restore_dvar_vector_position();
+    dvector dfs = restore_dvar_vector_derivatives(spos);
+    verify_identifier_string("selA");
+    dvector dfp(ppos.indexmin(),ppos.indexmax()); dfp.initialize();
+    for (int i=dfs.indexmin();i<=dfs.indexmax();i++){
+        if (dfs(i)!=0.0) for (int j=dfp.indexmin();j<=dfp.indexmax();j++) dfp(j) += dfs(i)*dvdp(i,j);
+    }
+    dfp.save_dvector_derivatives(ppos);
+}
+
 /**
  * Calculates ascending logistic function parameterized by 
  *      params[1]: size at 50% selected (z50)
@@ -172,19 +325,17 @@ const adstring SelFcns::STR_DBLNORMAL          ="dblnormal";
 dvar_vector SelFcns::asclogistic(dvector& z, dvar_vector& params, double fsZ){
     RETURN_ARRAYS_INCREMENT();
     if (debug) rpt::echo<<"Starting SelFcns::asclogistic(...)"<<endl;
-    dvariable n; n.initialize();
-    dvar_vector s(z.indexmin(),z.indexmax()); s.initialize();
-    s = 1.0/(1.0+exp(-params(2)*(z-params(1))));
-    if (fsZ>0){
-        n = 1.0+exp(-params(2)*(fsZ-params(1)));//normalize so (s(fsZ) = 1
-        s *= n;
-    } else if (fsZ<0) {
-        n = 1.0/max(s);
-        s *= n; //normalize by max
-    } //otherwise don't normalize it
+    dvector p = value(params);
+    dmatrix dqdp(1,2,params.indexmin(),params.indexmax()); dqdp.initialize();
+    double a = p(1); dqdp(1,1) = 1.0;
+    double b = p(2); dqdp(2,2) = 1.0;
+    dvector zx = extendZ(z,fsZ);
+    dvector r; dmatrix drdq;
+    kerLogistic(zx,a,b,r,drdq);
+    dmatrix drdp = drdq*dqdp;
+    dvar_vector s = assembleSelFcn(z.indexmin(),z.indexmax(),fsZ,r,drdp,params);
     if (debug) {
         rpt::echo<<"params, fsZ = "<<params(1)<<tb<<params(2)<<tb<<fsZ<<endl;
-        rpt::echo<<"n = "<<n<<endl;
         rpt::echo<<"z = "<<z<<endl;
         rpt::echo<<"s = "<<s<<endl;
         cout<<"Finished SelFcns::asclogistic(...)"<<endl;
@@ -207,19 +358,17 @@ dvar_vector SelFcns::asclogistic(dvector& z, dvar_vector& params, double fsZ){
 dvar_vector SelFcns::asclogistic5095(dvector& z, dvar_vector& params, double fsZ){
     RETURN_ARRAYS_INCREMENT();
     if (debug) cout<<"Starting SelFcns::asclogistic5095(...)"<<endl;
-    dvariable n; n.initialize();
-    dvar_vector s(z.indexmin(),z.indexmax()); s.initialize();
-    s = 1.0/(1.0+exp(-log(19.0)*(z-params(1))/params(2)));
-    if (fsZ>0){
-        n = 1.0+exp(-log(19.0)*(fsZ-params(1))/params(2));//normalization constant
-        s *= n;
-     } else if (fsZ<0) {
-        n = 1.0/max(s);
-        s *= n; //normalize by max
-    } //otherwise don't normalize it
+    dvector p = value(params);
+    dmatrix dqdp(1,2,params.indexmin(),params.indexmax()); dqdp.initialize();
+    double a = p(1);           dqdp(1,1) = 1.0;
+    double b = log(19.0)/p(2); dqdp(2,2) = -b/p(2);
+    dvector zx = extendZ(z,fsZ);
+    dvector r; dmatrix drdq;
+    kerLogistic(zx,a,b,r,drdq);
+    dmatrix drdp = drdq*dqdp;
+    dvar_vector s = assembleSelFcn(z.indexmin(),z.indexmax(),fsZ,r,drdp,params);
     if (debug) {
         rpt::echo<<"params, fsZ = "<<params(1)<<tb<<params(2)<<tb<<fsZ<<endl;
-        rpt::echo<<"n = "<<n<<endl;
         rpt::echo<<"z = "<<z<<endl;
         rpt::echo<<"s = "<<s<<endl;
         cout<<"Finished SelFcns::asclogistic5095(...)"<<endl;
@@ -242,21 +391,19 @@ dvar_vector SelFcns::asclogistic5095(dvector& z, dvar_vector& params, double fsZ
 dvar_vector SelFcns::asclogistic50Ln95(dvector& z, dvar_vector& params, double fsZ){
     RETURN_ARRAYS_INCREMENT();
     if (debug) cout<<"Starting SelFcns::asclogistic50Ln95(...)"<<endl;
-    dvariable n; n.initialize();
-    dvar_vector s(z.indexmin(),z.indexmax()); s.initialize();
-    dvariable z50    = params(1);
-    dvariable dz5095 = exp(params(2));
-    s = 1.0/(1.0+exp(-log(19.0)*(z-z50)/dz5095));
-    if (fsZ>0){
-        n = 1.0+exp(-log(19.0)*(fsZ-z50)/dz5095);//normalization constant
-        s *= n;
-    } else if (fsZ<0) {
-        n = 1.0/max(s);
-        s *= n; //normalize by max
-    } //otherwise don't normalize it
+    dvector p = value(params);
+    dmatrix dqdp(1,2,params.indexmin(),params.indexmax()); dqdp.initialize();
+    double z50    = p(1);
+    double dz5095 = exp(p(2));
+    double a = z50;              dqdp(1,1) = 1.0;
+    double b = log(19.0)/dz5095; dqdp(2,2) = -b;
+    dvector zx = extendZ(z,fsZ);
+    dvector r; dmatrix drdq;
+    kerLogistic(zx,a,b,r,drdq);
+    dmatrix drdp = drdq*dqdp;
+    dvar_vector s = assembleSelFcn(z.indexmin(),z.indexmax(),fsZ,r,drdp,params);
     if (debug) {
         rpt::echo<<"params, fsZ = "<<params(1)<<tb<<params(2)<<tb<<fsZ<<endl;
-        rpt::echo<<"n = "<<n<<endl;
         rpt::echo<<"z = "<<z<<endl;
         rpt::echo<<"s = "<<s<<endl;
         cout<<"Finished SelFcns::asclogistic50Ln95(...)"<<endl;
@@ -279,21 +426,19 @@ dvar_vector SelFcns::asclogistic50Ln95(dvector& z, dvar_vector& params, double f
 dvar_vector SelFcns::asclogisticLn50Ln95(dvector& z, dvar_vector& params, double fsZ){
     RETURN_ARRAYS_INCREMENT();
     if (debug) cout<<"Starting SelFcns::asclogisticLn50Ln95(...)"<<endl;
-    dvariable n; n.initialize();
-    dvar_vector s(z.indexmin(),z.indexmax()); s.initialize();
-    dvariable z50    = exp(params(1));
-    dvariable dz5095 = exp(params(2));
-    s = 1.0/(1.0+exp(-log(19.0)*(z-z50)/dz5095));
-    if (fsZ>0){
-        n = 1.0+exp(-log(19.0)*(fsZ-z50)/dz5095);//normalization constant
-        s *= n;
-    } else if (fsZ<0) {
-        n = 1.0/max(s);
-        s *= n; //normalize by max
-    } //otherwise don't normalize it
+    dvector p = value(params);
+    dmatrix dqdp(1,2,params.indexmin(),params.indexmax()); dqdp.initialize();
+    double z50    = exp(p(1));
+    double dz5095 = exp(p(2));
+    double a = z50;              dqdp(1,1) = z50;
+    double b = log(19.0)/dz5095; dqdp(2,2) = -b;
+    dvector zx = extendZ(z,fsZ);
+    dvector r; dmatrix drdq;
+    kerLogistic(zx,a,b,r,drdq);
+    dmatrix drdp = drdq*dqdp;
+    dvar_vector s = assembleSelFcn(z.indexmin(),z.indexmax(),fsZ,r,drdp,params);
     if (debug) {
         rpt::echo<<"params, fsZ = "<<params(1)<<tb<<params(2)<<tb<<fsZ<<endl;
-        rpt::echo<<"n = "<<n<<endl;
         rpt::echo<<"z = "<<z<<endl;
         rpt::echo<<"s = "<<s<<endl;
         cout<<"Finished SelFcns::asclogisticLn50Ln95(...)"<<endl;
@@ -318,19 +463,19 @@ dvar_vector SelFcns::asclogisticLn50Ln95(dvector& z, dvar_vector& params, double
 dvar_vector SelFcns::dbllogistic(dvector& z, dvar_vector& params, double fsZ){
     RETURN_ARRAYS_INCREMENT();
     if (debug) cout<<"Starting SelFcns::dbllogistic(...)"<<endl;
-    dvariable n; n.initialize();
-    dvar_vector s(z.indexmin(),z.indexmax()); s.initialize();
-    s = elem_prod(1.0/(1.0+exp(-params(2)*(z-params(1)))),1.0/(1.0+exp(-params(4)*(params(3)-z))));
-    if (fsZ>0){
-        n = (1.0+exp(-params(2)*(fsZ-params(1))))*(1.0+exp(-params(4)*(params(3)-fsZ)));//normalization constant
-        s *= n;
-    } else if (fsZ<0) {
-        n = 1.0/max(s);
-        s *= n; //normalize by max
-    } //otherwise don't normalize it
+    dvector p = value(params);
+    dmatrix dqdp(1,4,params.indexmin(),params.indexmax()); dqdp.initialize();
+    double a  = p(1); dqdp(1,1) = 1.0;
+    double ba = p(2); dqdp(2,2) = 1.0;
+    double d  = p(3); dqdp(3,3) = 1.0;
+    double bd = p(4); dqdp(4,4) = 1.0;
+    dvector zx = extendZ(z,fsZ);
+    dvector r; dmatrix drdq;
+    kerDblLogistic(zx,a,ba,d,bd,r,drdq);
+    dmatrix drdp = drdq*dqdp;
+    dvar_vector s = assembleSelFcn(z.indexmin(),z.indexmax(),fsZ,r,drdp,params);
     if (debug) {
         rpt::echo<<"params, fsZ = "<<params(1)<<tb<<params(2)<<tb<<fsZ<<endl;
-        rpt::echo<<"n = "<<n<<endl;
         rpt::echo<<"z = "<<z<<endl;
         rpt::echo<<"s = "<<s<<endl;
         cout<<"Finished SelFcns::dbllogistic(...)"<<endl;
@@ -355,19 +500,19 @@ dvar_vector SelFcns::dbllogistic(dvector& z, dvar_vector& params, double fsZ){
 dvar_vector SelFcns::dbllogistic5095(dvector& z, dvar_vector& params, double fsZ){
     RETURN_ARRAYS_INCREMENT();
     if (debug) cout<<"Starting SelFcns::dbllogistic5095(...)"<<endl;
-    dvariable n; n.initialize();
-    dvar_vector s(z.indexmin(),z.indexmax()); s.initialize();
-    s = elem_prod(1.0/(1.0+exp(-log(19.0)*(z-params(1))/params(2))),1.0/(1.0+exp(-log(19.0)*(params(3)-z)/params(4))));
-    if (fsZ>0){
-        n = (1.0+exp(-log(19.0)*(fsZ-params(1))/params(2)))*(1.0+exp(-log(19.0)*(params(3)-fsZ)/params(4)));//normalization constant
-        s *= n;
-    } else if (fsZ<0) {
-        n = 1.0/max(s);
-        s *= n; //normalize by max
-    } //otherwise don't normalize it
+    dvector p = value(params);
+    dmatrix dqdp(1,4,params.indexmin(),params.indexmax()); dqdp.initialize();
+    double a  = p(1);           dqdp(1,1) = 1.0;
+    double ba = log(19.0)/p(2); dqdp(2,2) = -ba/p(2);
+    double d  = p(3);           dqdp(3,3) = 1.0;
+    double bd = log(19.0)/p(4); dqdp(4,4) = -bd/p(4);
+    dvector zx = extendZ(z,fsZ);
+    dvector r; dmatrix drdq;
+    kerDblLogistic(zx,a,ba,d,bd,r,drdq);
+    dmatrix drdp = drdq*dqdp;
+    dvar_vector s = assembleSelFcn(z.indexmin(),z.indexmax(),fsZ,r,drdp,params);
     if (debug) {
         rpt::echo<<"params, fsZ = "<<params(1)<<tb<<params(2)<<tb<<fsZ<<endl;
-        rpt::echo<<"n = "<<n<<endl;
         rpt::echo<<"z = "<<z<<endl;
         rpt::echo<<"s = "<<s<<endl;
         cout<<"Finished SelFcns::dbllogistic5095(...)"<<endl;
@@ -392,24 +537,26 @@ dvar_vector SelFcns::dbllogistic5095(dvector& z, dvar_vector& params, double fsZ
 dvar_vector SelFcns::dbllogistic50Ln95(dvector& z, dvar_vector& params, double fsZ){
     RETURN_ARRAYS_INCREMENT();
     if (debug) cout<<"Starting SelFcns::dbllogistic50Ln95(...)"<<endl;
-    dvariable n; n.initialize();
-    dvar_vector s(z.indexmin(),z.indexmax()); s.initialize();
-    dvariable z50a = params(1);
-    dvariable dza  = exp(params(2));//increment from z50a to z95a
-    dvariable dzz  = exp(params(3));//increment from z95a to z95d
-    dvariable dzd  = exp(params(4));//increment from z95d to z50d
-    dvariable z50d = z50a+dza+dzz+dzd; 
-    s = elem_prod(1.0/(1.0+exp(-log(19.0)*(z-z50a)/dza)),1.0/(1.0+exp(-log(19.0)*(z50d-z)/dzd)));
-    if (fsZ>0){
-        n = (1.0+exp(-log(19.0)*(fsZ-z50a)/dza))*(1.0+exp(-log(19.0)*(z50d-fsZ)/dzd));//normalization constant
-        s *= n;
-    } else if (fsZ<0) {
-        n = 1.0/max(s);
-        s *= n; //normalize by max
-    } //otherwise don't normalize it
+    dvector p = value(params);
+    dmatrix dqdp(1,4,params.indexmin(),params.indexmax()); dqdp.initialize();
+    double z50a = p(1);
+    double dza  = exp(p(2));//increment from z50a to z95a
+    double dzz  = exp(p(3));//increment from z95a to z95d
+    double dzd  = exp(p(4));//increment from z95d to z50d
+    double z50d = z50a+dza+dzz+dzd; 
+    double ba   = log(19.0)/dza;
+    double bd   = log(19.0)/dzd;
+    dqdp(1,1) = 1.0; 
+    dqdp(2,2) = -ba;
+    dqdp(3,1) = 1.0; dqdp(3,2) = dza; dqdp(3,3) = dzz; dqdp(3,4) = dzd;
+    dqdp(4,4) = -bd;
+    dvector zx = extendZ(z,fsZ);
+    dvector r; dmatrix drdq;
+    kerDblLogistic(zx,z50a,ba,z50d,bd,r,drdq);
+    dmatrix drdp = drdq*dqdp;
+    dvar_vector s = assembleSelFcn(z.indexmin(),z.indexmax(),fsZ,r,drdp,params);
     if (debug) {
         rpt::echo<<"params, fsZ = "<<params(1)<<tb<<params(2)<<tb<<fsZ<<endl;
-        rpt::echo<<"n = "<<n<<endl;
         rpt::echo<<"z = "<<z<<endl;
         rpt::echo<<"s = "<<s<<endl;
         cout<<"Finished SelFcns::dbllogistic50Ln95(...)"<<endl;
@@ -434,24 +581,26 @@ dvar_vector SelFcns::dbllogistic50Ln95(dvector& z, dvar_vector& params, double f
 dvar_vector SelFcns::dbllogisticLn50Ln95(dvector& z, dvar_vector& params, double fsZ){
     RETURN_ARRAYS_INCREMENT();
     if (debug) cout<<"Starting SelFcns::dbllogisticLn50Ln95(...)"<<endl;
-    dvariable n; n.initialize();
-    dvar_vector s(z.indexmin(),z.indexmax()); s.initialize();
-    dvariable z50a = exp(params(1));
-    dvariable dza  = exp(params(2));//increment from z50a to z95a
-    dvariable dzz  = exp(params(3));//increment from z95a to z95d
-    dvariable dzd  = exp(params(4));//increment from z95d to z50d
-    dvariable z50d = z50a+dza+dzz+dzd; 
-    s = elem_prod(1.0/(1.0+exp(-log(19.0)*(z-z50a)/dza)),1.0/(1.0+exp(-log(19.0)*(z50d-z)/dzd)));
-    if (fsZ>0){
-        n = (1.0+exp(-log(19.0)*(fsZ-z50a)/dza))*(1.0+exp(-log(19.0)*(z50d-fsZ)/dzd));//normalization constant
-        s *= n;
-    } else if (fsZ<0) {
-        n = 1.0/max(s);
-        s *= n; //normalize by max
-    } //otherwise don't normalize it
+    dvector p = value(params);
+    dmatrix dqdp(1,4,params.indexmin(),params.indexmax()); dqdp.initialize();
+    double z50a = exp(p(1));
+    double dza  = exp(p(2));//increment from z50a to z95a
+    double dzz  = exp(p(3));//increment from z95a to z95d
+    double dzd  = exp(p(4));//increment from z95d to z50d
+    double z50d = z50a+dza+dzz+dzd; 
+    double ba   = log(19.0)/dza;
+    double bd   = log(19.0)/dzd;
+    dqdp(1,1) = z50a; 
+    dqdp(2,2) = -ba;
+    dqdp(3,1) = z50a; dqdp(3,2) = dza; dqdp(3,3) = dzz; dqdp(3,4) = dzd;
+    dqdp(4,4) = -bd;
+    dvector zx = extendZ(z,fsZ);
+    dvector r; dmatrix drdq;
+    kerDblLogistic(zx,z50a,ba,z50d,bd,r,drdq);
+    dmatrix drdp = drdq*dqdp;
+    dvar_vector s = assembleSelFcn(z.indexmin(),z.indexmax(),fsZ,r,drdp,params);
     if (debug) {
         rpt::echo<<"params, fsZ = "<<params(1)<<tb<<params(2)<<tb<<fsZ<<endl;
-        rpt::echo<<"n = "<<n<<endl;
         rpt::echo<<"z = "<<z<<endl;
         rpt::echo<<"s = "<<s<<endl;
         cout<<"Finished SelFcns::dbllogisticLn50Ln95(...)"<<endl;
@@ -37,7 +37,7 @@ PopDyInfo::PopDyInfo(int npZBs){
  * 
  * @return mature biomass (units??)
  */
-double PopDyInfo::calcMatureBiomass(d3_array& n_msz, ostream& cout){
+double PopDyInfo::calcMatureBiomass(const d3_array& n_msz, ostream& cout){
     if (debug) cout<<"starting double PopDyInfo::calcMMB(n_msz)"<<endl;
     double mmb = 0.0; 
     for (int s=1;s<=nSCs;s++) mmb += n_msz(MATURE,s)*w_mz(MATURE);//dot product here
@@ -52,7 +52,7 @@ double PopDyInfo::calcMatureBiomass(d3_array& n_msz, ostream& cout){
  * 
  * @return total biomass (units??)
  */
-double PopDyInfo::calcTotalBiomass(d3_array& n_msz, ostream& cout){
+double PopDyInfo::calcTotalBiomass(const d3_array& n_msz, ostream& cout){
     if (debug) cout<<"starting PopDyInfo::calcBiomass()"<<endl;
     double bio = 0.0;
     for (int s=1;s<=nSCs;s++){
@@ -73,17 +73,28 @@ double PopDyInfo::calcTotalBiomass(d3_array& n_msz, ostream& cout){
  * @return d3_array S_msz
  */
 d3_array PopDyInfo::calcSurvival(double dt, ostream& cout){
-    if (debug) cout<<"starting PopDyInfo::calcSurvival(dt)"<<endl;
     d3_array S_msz(1,nMSs,1,nSCs,1,nZBs);
-    for (int s=1;s<=nSCs;s++){
-        for (int m=1;m<=nMSs;m++){ 
-            S_msz(m,s) = exp(-M_msz(m,s)*dt); //survival over dt
-        }//m
-    }//s  
-    if (debug) cout<<"finished PopDyInfo::calcSurvival(dt)"<<endl;
+    calcSurvivalInto(S_msz,dt,cout);
     return S_msz;
 }
 
+/**
+ * Calculate single-sex survival probabilities, given natural mortality rates,
+ * over a given period of time (dt) into a caller-provided array.
+ * 
+ * @param S_msz - (output) survival probabilities
+ * @param dt - period of time (in years)
+ */
+void PopDyInfo::calcSurvivalInto(d3_array& S_msz, double dt, ostream& cout){
+    if (debug) cout<<"starting PopDyInfo::calcSurvival(dt)"<<endl;
+    for (int m=1;m<=nMSs;m++){
+        for (int s=1;s<=nSCs;s++){ 
+            for (int z=1;z<=nZBs;z++) S_msz(m,s,z) = exp(-M_msz(m,s,z)*dt); //survival over dt
+        }//s
+    }//m  
+    if (debug) cout<<"finished PopDyInfo::calcSurvival(dt)"<<endl;
+}
+
 /**
  * Apply natural mortality rates over a given period of time (dt) to
  * a single sex component of a population.
@@ -92,34 +103,65 @@ d3_array PopDyInfo::calcSurvival(double dt, ostream& cout){
  * 
  * @return d3_array - final population abundance
  */
-d3_array PopDyInfo::applyNM(double dt, d3_array& n_msz, ostream& cout){
-    if (debug) cout<<"starting PopDyInfo::applyNM(dt,n_msz)"<<endl;
+d3_array PopDyInfo::applyNM(double dt, const d3_array& n_msz, ostream& cout){
     d3_array np_msz(1,nMSs,1,nSCs,1,nZBs);
-    for (int s=1;s<=nSCs;s++){
-        for (int m=1;m<=nMSs;m++){ 
-            np_msz(m,s) = elem_prod(exp(-M_msz(m,s)*dt),n_msz(m,s)); //survival over dt
-        }//m
-    }//s  
-    if (debug) cout<<"finished PopDyInfo::applyNM(dt,n_msz)"<<endl;
+    applyNMInto(np_msz,dt,n_msz,cout);
     return np_msz;
 }
 
+/**
+ * Apply natural mortality rates over a given period of time (dt) to
+ * a single sex component of a population, writing the result into a 
+ * caller-provided array (which may be n_msz itself).
+ * 
+ * @param np_msz - (output) final population abundance
+ * @param dt - period of time (in years)
+ * @param n_msz - initial population abundance
+ */
+void PopDyInfo::applyNMInto(d3_array& np_msz, double dt, const d3_array& n_msz, ostream& cout){
+    if (debug) cout<<"starting PopDyInfo::applyNM(dt,n_msz)"<<endl;
+    for (int m=1;m<=nMSs;m++){
+        for (int s=1;s<=nSCs;s++){ 
+            for (int z=1;z<=nZBs;z++) np_msz(m,s,z) = exp(-M_msz(m,s,z)*dt)*n_msz(m,s,z); //survival over dt
+        }//s
+    }//m  
+    if (debug) cout<<"finished PopDyInfo::applyNM(dt,n_msz)"<<endl;
+}
+
 /** Apply molting/growth to population */
 /**
  * 
  * @param n_msz
  * @return 
  */
-d3_array PopDyInfo::applyMG(d3_array& n_msz, ostream& cout){
-    if (debug) cout<<"starting PopDyInfo::applyMG(n_msz)"<<endl;
+d3_array PopDyInfo::applyMG(const d3_array& n_msz, ostream& cout){
     d3_array np_msz(1,nMSs,1,nSCs,1,nZBs);
+    applyMGInto(np_msz,n_msz,cout);
+    return np_msz;
+}
+
+/**
+ * Apply molting/growth to population, writing the result into a 
+ * caller-provided array (which must not be n_msz itself).
+ * 
+ * @param np_msz - (output) final population abundance
+ * @param n_msz - initial population abundance
+ */
+void PopDyInfo::applyMGInto(d3_array& np_msz, const d3_array& n_msz, ostream& cout){
+    if (debug) cout<<"starting PopDyInfo::applyMG(n_msz)"<<endl;
     np_msz.initialize();
-    np_msz(IMMATURE,NEW_SHELL) = T_szz(NEW_SHELL)*elem_prod(1.0-Th_sz(NEW_SHELL),n_msz(IMMATURE,NEW_SHELL));
-//    np_msz(IMMATURE,OLD_SHELL) = 0.0;
-    np_msz(MATURE,NEW_SHELL)   = T_szz(NEW_SHELL)*elem_prod(    Th_sz(NEW_SHELL),n_msz(IMMATURE,NEW_SHELL));
-    np_msz(MATURE,OLD_SHELL)   = n_msz(MATURE,NEW_SHELL)+n_msz(MATURE,OLD_SHELL);
+    for (int z=1;z<=nZBs;z++){
+        double ni = 0.0; double nm = 0.0;
+        for (int zp=1;zp<=nZBs;zp++){
+            ni += T_szz(NEW_SHELL,z,zp)*((1.0-Th_sz(NEW_SHELL,zp))*n_msz(IMMATURE,NEW_SHELL,zp));
+            nm += T_szz(NEW_SHELL,z,zp)*(     Th_sz(NEW_SHELL,zp) *n_msz(IMMATURE,NEW_SHELL,zp));
+        }
+        np_msz(IMMATURE,NEW_SHELL,z) = ni;
+//        np_msz(IMMATURE,OLD_SHELL,z) = 0.0;
+        np_msz(MATURE,NEW_SHELL,z)   = nm;
+        np_msz(MATURE,OLD_SHELL,z)   = n_msz(MATURE,NEW_SHELL,z)+n_msz(MATURE,OLD_SHELL,z);
+    }
     if (debug) cout<<"finished PopDyInfo::applyMG(n_msz)"<<endl;
-    return np_msz;
 }
 ////////////////////////////////////////////////////////////////////////////////
 //CatchInfo
@@ -140,9 +182,13 @@ CatchInfo::CatchInfo(int npZBs, int npFsh){
     nSCs = tcsam::nSCs;
     
     maxF = 1.0;//default scale
+    capF_fmsz.allocate(1,nFsh,1,nMSs,1,nSCs,1,nZBs);
+    retF_fmsz.allocate(1,nFsh,1,nMSs,1,nSCs,1,nZBs);
+    hm_f.allocate(1,nFsh);
     ct_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
     rm_fmsz.allocate(1,nFsh,1,nMSs,1,nSCs,1,nZBs);
     dm_fmsz.allocate(1,nFsh,1,nMSs,1,nSCs,1,nZBs);
+    totFM_z.allocate(1,nZBs);
 }
 
 /**
@@ -170,32 +216,45 @@ double CatchInfo::findMaxTargetCaptureRate(ostream& cout){
  * @return np_msz - post-fisheries population size
  * 
  */
-d3_array CatchInfo::applyFM(double dirF, d3_array& n_msz, ostream& cout){
+d3_array CatchInfo::applyFM(double dirF, const d3_array& n_msz, ostream& cout){
+    d3_array np_msz(1,nMSs,1,nSCs,1,nZBs);
+    applyFMInto(np_msz,dirF,n_msz,cout);
+    return np_msz;
+}
+
+/**
+ * Calculate catch abundance (ct_msz, rm_fmsz, dm_fmsz) and post-fisheries
+ * abundance based on target fishing mortality rate 'dirF' and initial population 
+ * abundance n_msz, writing post-fisheries abundance into a caller-provided 
+ * array (which must not be n_msz itself).
+ * 
+ * Modifies: ct_msz, rm_fmsz, dm_fmsz
+ * 
+ * @param np_msz - (output) post-fisheries population size
+ * @param dirF - directed fishery fishing mortality rate
+ * @param n_msz - pre-fisheries population size
+ */
+void CatchInfo::applyFMInto(d3_array& np_msz, double dirF, const d3_array& n_msz, ostream& cout){
     if (debug) cout<<"starting Catch_Calculator::calcCatch(double dirF, d3_array n_msz)"<<endl;
     double ratF = dirF/maxF;//target fishery (f=1) scaling ratio
-    dvector totFM(1,nZBs);
-    d3_array np_msz(1,nMSs,1,nSCs,1,nZBs);
     np_msz.initialize();
     for (int s=1;s<=nSCs;s++){
         for (int m=1;m<=nMSs;m++){ 
-            totFM.initialize();
-            totFM += elem_prod(ratF*capF_fmsz(1,m,s),
-                               retF_fmsz(1,m,s) + hm_f(1)*(1.0-retF_fmsz(1,m,s)));
-            for (int f=2;f<=nFsh;f++)
-                totFM += elem_prod(capF_fmsz(f,m,s),
-                                   retF_fmsz(f,m,s) + hm_f(f)*(1.0-retF_fmsz(f,m,s)));
-            np_msz(m,s) = elem_prod(exp(-totFM),n_msz(m,s));//survival after all fisheries
-            ct_msz(m,s) = n_msz(m,s)-np_msz(m,s);           //total catch, all fisheries
-            for (int f=1;f<=nFsh;f++){
-                rm_fmsz(f,m,s) = elem_prod(elem_div(elem_prod(capF_fmsz(f,m,s),retF_fmsz(f,m,s)),totFM),
-                                              ct_msz(m,s));//retained catch mortality
-                dm_fmsz(f,m,s) = elem_prod(elem_div(elem_prod(capF_fmsz(f,m,s),hm_f(f)*(1.0-retF_fmsz(f,m,s))),totFM),
-                                              ct_msz(m,s));//discard catch mortality
-            }//f
+            for (int z=1;z<=nZBs;z++){
+                totFM_z(z) = 0.0;
+                totFM_z(z) += (ratF*capF_fmsz(1,m,s,z))*(retF_fmsz(1,m,s,z) + hm_f(1)*(1.0-retF_fmsz(1,m,s,z)));
+                for (int f=2;f<=nFsh;f++)
+                    totFM_z(z) += capF_fmsz(f,m,s,z)*(retF_fmsz(f,m,s,z) + hm_f(f)*(1.0-retF_fmsz(f,m,s,z)));
+                np_msz(m,s,z) = exp(-totFM_z(z))*n_msz(m,s,z);//survival after all fisheries
+                ct_msz(m,s,z) = n_msz(m,s,z)-np_msz(m,s,z);   //total catch, all fisheries
+                for (int f=1;f<=nFsh;f++){
+                    rm_fmsz(f,m,s,z) = ((capF_fmsz(f,m,s,z)*retF_fmsz(f,m,s,z))/totFM_z(z))*ct_msz(m,s,z);              //retained catch mortality
+                    dm_fmsz(f,m,s,z) = ((capF_fmsz(f,m,s,z)*(hm_f(f)*(1.0-retF_fmsz(f,m,s,z))))/totFM_z(z))*ct_msz(m,s,z);//discard catch mortality
+                }//f
+            }//z
         }//m
     }//s
     if (debug) cout<<"finished Catch_Calculator::calcCatch(double dirF, d3_array n_msz)"<<endl;
-    return np_msz;
 }
 
 /**
@@ -207,22 +266,32 @@ d3_array CatchInfo::applyFM(double dirF, d3_array& n_msz, ostream& cout){
  * @return d3_array of survival probabilities S_msz.
  */
 d3_array CatchInfo::calcSurvival(double dirF, ostream& cout){
-    double ratF = dirF/maxF;//target fishery (f=1) scaling ratio
-    dvector totFM(1,nZBs);
     d3_array S_msz(1,nMSs,1,nSCs,1,nZBs);
+    calcSurvivalInto(S_msz,dirF,cout);
+    return S_msz;
+}
+
+/**
+ * Calculates probabilities of surviving fisheries, given directed 
+ * fishing capture rate 'dirF', into a caller-provided array.
+ * 
+ * @param S_msz - (output) survival probabilities
+ * @param dirF - capture rate for target fishery (f=1)
+ */
+void CatchInfo::calcSurvivalInto(d3_array& S_msz, double dirF, ostream& cout){
+    double ratF = dirF/maxF;//target fishery (f=1) scaling ratio
     S_msz.initialize();
     for (int s=1;s<=nSCs;s++){
         for (int m=1;m<=nMSs;m++){ 
-            totFM.initialize();
-            totFM += elem_prod(ratF*capF_fmsz(1,m,s),
-                              retF_fmsz(1,m,s) + hm_f(1)*(1.0-retF_fmsz(1,m,s)));
-            for (int f=2;f<=nFsh;f++)
-                totFM += elem_prod(dirF*capF_fmsz(f,m,s),
-                                  retF_fmsz(f,m,s) + hm_f(f)*(1.0-retF_fmsz(f,m,s)));
-            S_msz(m,s) = exp(-totFM);                //survival of fisheries
+            for (int z=1;z<=nZBs;z++){
+                totFM_z(z) = 0.0;
+                totFM_z(z) += (ratF*capF_fmsz(1,m,s,z))*(retF_fmsz(1,m,s,z) + hm_f(1)*(1.0-retF_fmsz(1,m,s,z)));
+                for (int f=2;f<=nFsh;f++)
+                    totFM_z(z) += (dirF*capF_fmsz(f,m,s,z))*(retF_fmsz(f,m,s,z) + hm_f(f)*(1.0-retF_fmsz(f,m,s,z)));
+                S_msz(m,s,z) = exp(-totFM_z(z));//survival of fisheries
+            }//z
         }//m
     }//s
-    return S_msz;
 }
 /**
  * Set sex-specific fishery capture rates.
@@ -230,8 +299,7 @@ d3_array CatchInfo::calcSurvival(double dirF, ostream& cout){
  * @param x - sex to select
  * @param capF_fxmsz - input capture rates
  */
-void CatchInfo::setCaptureRates(int x, d5_array& capF_fxmsz){
-    capF_fmsz.allocate(1,nFsh,1,nMSs,1,nSCs,1,nZBs);
+void CatchInfo::setCaptureRates(int x, const d5_array& capF_fxmsz){
     capF_fmsz.initialize();
     for (int f=1;f<=nFsh;f++){
         for (int m=1;m<=nMSs;m++){
@@ -246,8 +314,7 @@ void CatchInfo::setCaptureRates(int x, d5_array& capF_fxmsz){
  * @param x - sex to select
  * @param retF_fxmsz - input retention functions
  */
-void CatchInfo::setRetentionFcns(int x, d5_array& retF_fxmsz){
-    retF_fmsz.allocate(1,nFsh,1,nMSs,1,nSCs,1,nZBs);
+void CatchInfo::setRetentionFcns(int x, const d5_array& retF_fxmsz){
     retF_fmsz.initialize();
     for (int f=1;f<=nFsh;f++){
         for (int m=1;m<=nMSs;m++){
@@ -261,8 +328,7 @@ void CatchInfo::setRetentionFcns(int x, d5_array& retF_fxmsz){
  * 
  * @param pHM_f - dvector of handling mortality rates
  */
-void CatchInfo::setHandlingMortality(dvector& pHM_f){
-    hm_f.allocate(1,nFsh);
+void CatchInfo::setHandlingMortality(const dvector& pHM_f){
     hm_f.initialize();
     hm_f = pHM_f;
 }
@@ -383,7 +449,7 @@ double OFL_Calculator::calcHCR(double currMMB, double Bmsy, double Fmsy, ostream
  * 
  * @return Fofl
  */
-double OFL_Calculator::calcFofl(double Bmsy, double Fmsy, d3_array& n_msz, ostream& cout){
+double OFL_Calculator::calcFofl(double Bmsy, double Fmsy, const d3_array& n_msz, ostream& cout){
     if (debug) {
         cout<<"starting double OFL_Calculator::calcFofl(Bmsy, Fmsy,n_msz)"<<endl;
         cout<<"Bmsy = "<<Bmsy<<"; Fmsy = "<<Fmsy<<endl;
@@ -429,12 +495,12 @@ double OFL_Calculator::calcFofl(double Bmsy, double Fmsy, d3_array& n_msz, ostre
  * 
  * @return total OFL (biomass)
  */
-double OFL_Calculator::calcOFL(double Fofl, d4_array& n_xmsz, ostream& cout){
+double OFL_Calculator::calcOFL(double Fofl, const d4_array& n_xmsz, ostream& cout){
     if (debug) cout<<"starting double OFL_Calculator::calcOFL(Fofl,n_xmsz)"<<endl;
     
     ofl_fx.initialize();
     //calc catch of males
-    pPrjM->project(Fofl,n_xmsz(  MALE),cout);
+    pPrjM->projectInto(pPrjM->np_msz,Fofl,n_xmsz(  MALE),cout);
     //retained catch biomass (directed fishery only)
     ofl_fx(0,  MALE) = pPrjM->pPI->calcTotalBiomass(pPrjM->pCI->rm_fmsz(1),cout);
     //discard mortality biomass
@@ -444,7 +510,7 @@ double OFL_Calculator::calcOFL(double Fofl, d4_array& n_xmsz, ostream& cout){
     prjMMB = pPrjM->matBio;
     
     //calc catch of females
-    pPrjF->project(Fofl,n_xmsz(FEMALE),cout);
+    pPrjF->projectInto(pPrjF->np_msz,Fofl,n_xmsz(FEMALE),cout);
     //retained catch biomass (directed fishery only)
     ofl_fx(0,FEMALE) = pPrjF->pPI->calcTotalBiomass(pPrjF->pCI->rm_fmsz(1),cout);
     //discard mortality biomass
@@ -465,7 +531,7 @@ double OFL_Calculator::calcOFL(double Fofl, d4_array& n_xmsz, ostream& cout){
  * 
  * @return - the (projected) MMB
  */
-double OFL_Calculator::calcPrjMMB(double Fofl, d3_array& n_msz, ostream& cout){
+double OFL_Calculator::calcPrjMMB(double Fofl, const d3_array& n_msz, ostream& cout){
     if (debug) cout<<"starting double OFL_Calculator::calcPrjMMB(Fofl,n_msz)"<<endl;
     double mmb = pPrjM->projectMatureBiomass(Fofl,n_msz,cout);
     if (debug) cout<<"finished double OFL_Calculator::calcPrjMMB(Fofl,n_msz)"<<endl;
@@ -492,6 +558,17 @@ Tier3_Calculator::Tier3_Calculator(int npZBs, int npFsh){
     
     //set other constants
     XX = 0.35;//SPR rate for MSY calculations
+    
+    //allocate work arrays
+    R_zp.allocate(1,nZBs);
+    S1_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
+    S2_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
+    neq_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
+    wrk1_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
+    wrk2_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
+    wrk3_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
+    cD_z.allocate(1,nZBs);
+    A_zz.allocate(1,nZBs,1,nZBs);
 }
 
 /**
@@ -506,68 +583,121 @@ Tier3_Calculator::Tier3_Calculator(int npZBs, int npFsh){
  * 
  * @return equlibrium (longterm) population abundance on July 1 (as d3_array)
  */
-d3_array Tier3_Calculator::calcEqNatZ(dvector& R_z, d3_array& S1_msz, 
-                                      dmatrix& Th_sz, d3_array& T_szz, 
-                                      d3_array& S2_msz, ostream& cout){
-    if (debug) cout<<"starting d3_array calcEqNatZ(...)"<<endl;
-
+d3_array Tier3_Calculator::calcEqNatZ(const dvector& R_z, const d3_array& S1_msz, 
+                                      const dmatrix& Th_sz, const d3_array& T_szz, 
+                                      const d3_array& S2_msz, ostream& cout){
     //the equilibrium solution
     d3_array n_msz(1,nMSs,1,nSCs,1,nZBs);
-    
-    //create an identity matrix
-    dmatrix I = identity_matrix(1,nZBs);
-    
-    //--calc the state transition matrices
+    calcEqNatZInto(n_msz,R_z,S1_msz,Th_sz,T_szz,S2_msz,cout);
+    return n_msz;
+}
+
+/**
+ * Calculate equilibrium (longterm) population abundance on July 1 
+ * into a caller-provided array.
+ * 
+ * @param n_msz - (output) equilibrium abundance
+ * @param R_z - longterm recruitment at size
+ * @param S1_msz - survival prior to molting/growth
+ * @param Th_sz - pr(molt-to-maturity|size) for immature crab
+ * @param T_szz - growth transition matrix for molting crab
+ * @param S2_msz - survival following molting/growth
+ * @param cout - output stream for debug info
+ */
+void Tier3_Calculator::calcEqNatZInto(d3_array& n_msz, const dvector& R_z, const d3_array& S1_msz, 
+                                      const dmatrix& Th_sz, const d3_array& T_szz, 
+                                      const d3_array& S2_msz, ostream& cout){
+    if (debug) cout<<"starting d3_array calcEqNatZ(...)"<<endl;
+
     int i = tcsam::IMMATURE; 
     int m = tcsam::MATURE;
     int n = tcsam::NEW_SHELL;
     int o = tcsam::OLD_SHELL;
-    //immature new shell crab
-    dmatrix S2_in = wts::diag(S2_msz(i,n)); //pr(survival|size) for immature new shell crab after molting occurs
-    dmatrix Tr_in = T_szz(n);               //pr(Z_post|Z_pre, molt) for immature new shell crab pre-terminal molt
-    dmatrix Th_in = wts::diag(Th_sz(n));    //pr(molt to maturity|pre-molt size,new shell, molting)
-    dmatrix Ph_in = identity_matrix(1,nZBs);//pr(molt|pre-molt size, new shell) [assumed that all immature crab molt]
-    dmatrix S1_in = wts::diag(S1_msz(i,n)); //pr(survival|size) for immature new shell crab before molting occurs
-    //immature old shell crab [shouldn't be any of these]
-    dmatrix S2_io = wts::diag(S2_msz(i,o)); //pr(survival|size) for immature old shell crab after molting occurs (but they didn't molt)
-    dmatrix Tr_io = T_szz(o);               //pr(Z_post|Z_pre, molt) for immature old shell crab pre-terminal molt
-    dmatrix Th_io = wts::diag(Th_sz(o));    //pr(molt to maturity|pre-molt size,old shell, molting)
-    dmatrix Ph_io = identity_matrix(1,nZBs);//pr(molt|pre-molt size, old shell) [assumed all immature crab molt]
-    dmatrix S1_io = wts::diag(S1_msz(i,o)); //pr(survival|size) for immature old shell crab before molting occurs
-    //mature new shell crab
-    dmatrix Tr_mn = T_szz(n);               //pr(Z_post|Z_pre, molt) for immature new shell crab undergoing terminal molt (same as non-terminal molt)
-    dmatrix Tr_mo = T_szz(o);               //pr(Z_post|Z_pre, molt) for immature old shell crab undergoing terminal molt (same as non-terminal molt)
-    dmatrix S2_mn = wts::diag(S2_msz(m,n)); //pr(survival|size) for mature new shell crab after molting occurs
-    dmatrix S1_mn = wts::diag(S1_msz(m,n)); //pr(survival|size) for mature new shell crab before molting occurs (but they won't molt)
-    //mature old shell crab
-    dmatrix S2_mo = wts::diag(S2_msz(m,o)); //pr(survival|size) for mature old shell crab after molting occurs (but they didn't molt)
-    dmatrix S1_mo = wts::diag(S1_msz(m,o)); //pr(survival|size) for mature old shell crab before molting occurs (but they won't molt)
+    double Ph_in = 1.0;//pr(molt|pre-molt size, new shell) [assumed that all immature crab molt]
+    double Ph_io = 1.0;//pr(molt|pre-molt size, old shell) [assumed that all immature crab molt]
     
-    //full state transition matrices
-    dmatrix lA = S2_in * Tr_in * (I-Th_in) * Ph_in * S1_in;//imm, new -> imm, new
-    dmatrix lB = S2_in * Tr_io * (I-Th_io) * Ph_io * S1_io;//imm, old -> imm, new
-    dmatrix lC = S2_io * (I-Ph_in) * S1_in;                //imm, new -> imm, old
-    dmatrix lD = S2_io * (I-Ph_io) * S1_io;                //imm, old -> imm, old
-    dmatrix lE = S2_mn * Tr_mn * Th_in * Ph_in * S1_in;    //imm, new -> mat, new (terminal molt)
-    dmatrix lF = S2_mn * Tr_mo * Th_io * Ph_io * S1_io;    //imm, old -> mat, new (terminal molt)
-    dmatrix lG = S2_mo * S1_mn;                            //mat, new -> mat, old
-    dmatrix lH = S2_mo * S1_mo;                            //mat, old -> mat, old
-    //--done calculating transition matrices
+    //--the state transition matrices are
+    //  lA = S2_in * Tr_in * (I-Th_in) * Ph_in * S1_in;//imm, new -> imm, new
+    //  lB = S2_in * Tr_io * (I-Th_io) * Ph_io * S1_io;//imm, old -> imm, new
+    //  lC = S2_io * (I-Ph_in) * S1_in;                //imm, new -> imm, old
+    //  lD = S2_io * (I-Ph_io) * S1_io;                //imm, old -> imm, old
+    //  lE = S2_mn * Tr_mn * Th_in * Ph_in * S1_in;    //imm, new -> mat, new (terminal molt)
+    //  lF = S2_mn * Tr_mo * Th_io * Ph_io * S1_io;    //imm, old -> mat, new (terminal molt)
+    //  lG = S2_mo * S1_mn;                            //mat, new -> mat, old
+    //  lH = S2_mo * S1_mo;                            //mat, old -> mat, old
+    //where Tr_in = Tr_mn = T_szz(n), Tr_io = Tr_mo = T_szz(o) and the survival (S), 
+    //molt-to-maturity (Th) and molt (Ph) matrices are diagonal, e.g. S2_in = diag(S2_msz(i,n)).
+    //Multiplying by a diagonal matrix only scales rows (on the left) or columns (on 
+    //the right), so lA, lB, lE and lF are scaled growth matrices and lC, lD, lG and lH
+    //are diagonal. The equilibrium solution
+    //  n(i,n) = inv(I - lA - lB * inv(I-lD) * lC) * R_z
+    //  n(i,o) = inv(I-lD) * lC * n(i,n)
+    //  n(m,n) = lE * n(i,n) + lF * n(i,o)
+    //  n(m,o) = inv(I-lH) * lG * n(m,n)
+    //is calculated below on that basis, using only the work arrays cD_z and A_zz.
     
-    //calculate inverses of matrix quantities
-    dmatrix iM1 = inv(I - lD);
-    dmatrix iM2 = inv(I - lA - lB * iM1 * lC);
-    dmatrix iM3 = inv(I - lH);
+    //diagonal of inv(I-lD) * lC
+    for (int z=1;z<=nZBs;z++) 
+        cD_z(z) = (S2_msz(i,o,z)*(1.0-Ph_in)*S1_msz(i,n,z))/(1.0-S2_msz(i,o,z)*(1.0-Ph_io)*S1_msz(i,o,z));
+    
+    //I - lA - lB * inv(I-lD) * lC
+    for (int r=1;r<=nZBs;r++){
+        for (int c=1;c<=nZBs;c++){
+            A_zz(r,c) = -S2_msz(i,n,r)*(T_szz(n,r,c)*(1.0-Th_sz(n,c))*Ph_in*S1_msz(i,n,c)
+                                       +T_szz(o,r,c)*(1.0-Th_sz(o,c))*Ph_io*S1_msz(i,o,c)*cD_z(c));
+        }
+        A_zz(r,r) += 1.0;
+    }
     
     //the equilibrium solution is
     n_msz.initialize();
-    n_msz(i,n) = iM2 * R_z;                         //immature, new shell
-    n_msz(i,o) = iM1 * lC * n_msz(i,n);             //immature, old shell
-    n_msz(m,n) = lE * n_msz(i,n) + lF * n_msz(i,o); //  mature, new shell
-    n_msz(m,o) = iM3 * lG * n_msz(m,n);             //  mature, old shell
+    n_msz(i,n) = R_z;                                                  //immature, new shell
+    solveInPlace(A_zz,n_msz(i,n));
+    for (int z=1;z<=nZBs;z++) n_msz(i,o,z) = cD_z(z)*n_msz(i,n,z);     //immature, old shell
+    for (int r=1;r<=nZBs;r++){                                         //  mature, new shell
+        double nmn = 0.0;
+        for (int c=1;c<=nZBs;c++) 
+            nmn += T_szz(n,r,c)*Th_sz(n,c)*Ph_in*S1_msz(i,n,c)*n_msz(i,n,c)
+                  +T_szz(o,r,c)*Th_sz(o,c)*Ph_io*S1_msz(i,o,c)*n_msz(i,o,c);
+        n_msz(m,n,r) = S2_msz(m,n,r)*nmn;
+    }
+    for (int z=1;z<=nZBs;z++)                                          //  mature, old shell
+        n_msz(m,o,z) = (S2_msz(m,o,z)*S1_msz(m,n,z))/(1.0-S2_msz(m,o,z)*S1_msz(m,o,z))*n_msz(m,n,z);
         
     if (debug) cout<<"finished d3_array calcEqNatZ(...)"<<endl;
-    return n_msz;
+}
+
+/**
+ * Solve A*x = b by Gaussian elimination with partial pivoting, 
+ * without allocating. A is overwritten.
+ * 
+ * @param A - (input/work) square matrix
+ * @param x - (input/output) b on input, the solution on output
+ */
+void Tier3_Calculator::solveInPlace(dmatrix& A, dvector& x){
+    int mn = A.indexmin(); int mx = A.indexmax();
+    for (int k=mn;k<=mx;k++){
+        //pivot on the largest remaining element in column k
+        int p = k;
+        for (int r=k+1;r<=mx;r++) if (sfabs(A(r,k))>sfabs(A(p,k))) p = r;
+        if (p!=k){
+            for (int c=k;c<=mx;c++) {double t = A(k,c); A(k,c) = A(p,c); A(p,c) = t;}
+            double t = x(k); x(k) = x(p); x(p) = t;
+        }
+        //eliminate column k below the diagonal
+        for (int r=k+1;r<=mx;r++){
+            double f = A(r,k)/A(k,k);
+            if (f==0.0) continue;
+            for (int c=k+1;c<=mx;c++) A(r,c) -= f*A(k,c);
+            x(r) -= f*x(k);
+        }
+    }
+    //back substitution
+    for (int r=mx;r>=mn;r--){
+        double v = x(r);
+        for (int c=r+1;c<=mx;c++) v -= A(r,c)*x(c);
+        x(r) = v/A(r,r);
+    }
 }
 
 /**
@@ -580,21 +710,30 @@ d3_array Tier3_Calculator::calcEqNatZ(dvector& R_z, d3_array& S1_msz,
  * @return equilibrium (male) population abundance on July 1
  */
 d3_array Tier3_Calculator::calcEqNatZF0(double R, ostream& cout){
+    d3_array n_msz(1,nMSs,1,nSCs,1,nZBs);  //equilibrium size distribution
+    calcEqNatZF0Into(n_msz,R,cout);
+    return n_msz;
+}
+
+/**
+ * Calculate equilibrium unfished abundance on July 1 when 
+ * longterm (average) male recruitment is R, into a caller-provided array.
+ * 
+ * @param n_msz - (output) equilibrium (male) population abundance on July 1
+ * @param R - longterm (average) male recruitment
+ * @param cout - output stream for debug info
+ */
+void Tier3_Calculator::calcEqNatZF0Into(d3_array& n_msz, double R, ostream& cout){
     if (debug) cout<<"starting d3_array calcEqNatZF0(double R)"<<endl;
 
-    d3_array S1_msz(1,nMSs,1,nSCs,1,nZBs);
-    d3_array S2_msz(1,nMSs,1,nSCs,1,nZBs);
-    d3_array n_msz(1,nMSs,1,nSCs,1,nZBs);  //equilibrium size distribution
+    pPI->calcSurvivalInto(S1_msz,dtM,cout);
+    pPI->calcSurvivalInto(S2_msz,1.0-dtM,cout);
     
-    S1_msz = pPI->calcSurvival(dtM,cout);
-    S2_msz = pPI->calcSurvival(1.0-dtM,cout);
+    for (int z=1;z<=nZBs;z++) R_zp(z) = R*pPI->R_z(z);
     
-    dvector R_zp = R*pPI->R_z;
-    
-    n_msz = calcEqNatZ(R_zp, S1_msz, pPI->Th_sz, pPI->T_szz, S2_msz,cout);
+    calcEqNatZInto(n_msz, R_zp, S1_msz, pPI->Th_sz, pPI->T_szz, S2_msz,cout);
     
     if (debug) cout<<"finished d3_array Tier3_Calculator::calcEqNatZF0(double R)"<<endl;
-    return n_msz;
 }
 
 /**
@@ -609,31 +748,52 @@ d3_array Tier3_Calculator::calcEqNatZF0(double R, ostream& cout){
  * @return equilibrium (male) population abundance on July 1
  */
 d3_array Tier3_Calculator::calcEqNatZFM(double R, double dirF, ostream& cout){
-    if (debug) cout<<"starting d3_array Tier3_Calculator::calcEqNatZFM(double R)"<<endl;
-    d3_array S1_msz(1,nMSs,1,nSCs,1,nZBs);//survival until molting/mating
-    d3_array S2_msz(1,nMSs,1,nSCs,1,nZBs);//survival after molting/mating
     d3_array n_msz(1,nMSs,1,nSCs,1,nZBs); //equilibrium size distribution on July 1
-    
+    calcEqNatZFMInto(n_msz,R,dirF,cout);
+    return n_msz; 
+}
+
+/**
+ * Calculate equilibrium abundance on July 1 when dirF is the 
+ * directed fishery capture rate and the longterm (average) 
+ * male recruitment is R, into a caller-provided array.
+ * 
+ * Uses work arrays S1_msz, S2_msz and wrk1_msz-wrk3_msz.
+ * 
+ * @param n_msz - (output) equilibrium (male) population abundance on July 1
+ * @param R - longterm (average) male recruitment
+ * @param dirF - directed fishery capture rate
+ * @param cout - output stream for debug info
+ */
+void Tier3_Calculator::calcEqNatZFMInto(d3_array& n_msz, double R, double dirF, ostream& cout){
+    if (debug) cout<<"starting d3_array Tier3_Calculator::calcEqNatZFM(double R)"<<endl;
     if (dtF<=dtM){
         //fisheries occur BEFORE molting/growth/maturity 
-        d3_array S1a_msz = pPI->calcSurvival(dtF,cout);     //survival prior to fisheries
-        d3_array S1F_msz = pCI->calcSurvival(dirF,cout);    //survival of fisheries
-        d3_array S1b_msz = pPI->calcSurvival(dtM-dtF,cout); //survival after fisheries, before mating
-        S1_msz = elem_prod(S1b_msz,elem_prod(S1F_msz,S1a_msz));//total survival before mating
-        S2_msz = pPI->calcSurvival(1.0-dtM,cout);//survival after mating/molting/growth
+        pPI->calcSurvivalInto(wrk1_msz,dtF,cout);     //survival prior to fisheries
+        pCI->calcSurvivalInto(wrk2_msz,dirF,cout);    //survival of fisheries
+        pPI->calcSurvivalInto(wrk3_msz,dtM-dtF,cout); //survival after fisheries, before mating
+        for (int m=1;m<=nMSs;m++){
+            for (int s=1;s<=nSCs;s++){
+                for (int z=1;z<=nZBs;z++) S1_msz(m,s,z) = wrk3_msz(m,s,z)*wrk2_msz(m,s,z)*wrk1_msz(m,s,z);//total survival before mating
+            }
+        }
+        pPI->calcSurvivalInto(S2_msz,1.0-dtM,cout);//survival after mating/molting/growth
     } else {
         //fisheries occur AFTER molting/growth/maturity 
-        S1_msz = pPI->calcSurvival(dtM,cout);                   //survival before mating/molting/growth
-        d3_array S2a_msz = pPI->calcSurvival(dtF-dtM,cout);     //survival afterMGM, before fisheries
-        d3_array S2F_msz = pCI->calcSurvival(dirF,cout);        //survival of fisheries
-        d3_array S2b_msz = pPI->calcSurvival(1.0-dtF,cout);     //survival after fisheries, to year end
-        S2_msz = elem_prod(S2b_msz,elem_prod(S2F_msz,S2a_msz)); //total survival after MGM to year end
+        pPI->calcSurvivalInto(S1_msz,dtM,cout);       //survival before mating/molting/growth
+        pPI->calcSurvivalInto(wrk1_msz,dtF-dtM,cout); //survival afterMGM, before fisheries
+        pCI->calcSurvivalInto(wrk2_msz,dirF,cout);    //survival of fisheries
+        pPI->calcSurvivalInto(wrk3_msz,1.0-dtF,cout); //survival after fisheries, to year end
+        for (int m=1;m<=nMSs;m++){
+            for (int s=1;s<=nSCs;s++){
+                for (int z=1;z<=nZBs;z++) S2_msz(m,s,z) = wrk3_msz(m,s,z)*wrk2_msz(m,s,z)*wrk1_msz(m,s,z);//total survival after MGM to year end
+            }
+        }
     }
-    dvector R_zp = R*pPI->R_z;
-    n_msz = calcEqNatZ(R_zp, S1_msz, pPI->Th_sz, pPI->T_szz, S2_msz, cout);
+    for (int z=1;z<=nZBs;z++) R_zp(z) = R*pPI->R_z(z);
+    calcEqNatZInto(n_msz, R_zp, S1_msz, pPI->Th_sz, pPI->T_szz, S2_msz, cout);
     
     if (debug) cout<<"finished Ter3_Calculator::calcEqNatZFM(double R)"<<endl;
-    return n_msz; 
 }
 
 /**
@@ -691,13 +851,13 @@ double Tier3_Calculator::calcFmsy(double R, ostream& cout){
 double Tier3_Calculator::calcB100(double R, ostream& cout){
     if (debug) cout<<"finished d3_array calcB100(double R)"<<endl;
     //calculate July 1 unfished size distribution
-    d3_array n_msz = calcEqNatZF0(R,cout);
+    calcEqNatZF0Into(neq_msz,R,cout);
     
     //advance to mating in unfished population
-    d3_array nm_msz = pPI->applyNM(dtM,n_msz,cout);
+    pPI->applyNMInto(wrk1_msz,dtM,neq_msz,cout);
     
     //calculate mature biomass at time of mating
-    double B100 = pPI->calcMatureBiomass(nm_msz,cout);
+    double B100 = pPI->calcMatureBiomass(wrk1_msz,cout);
     if (debug) cout<<"finished double Tier3_Calculator::calcB100(double R)"<<endl;
     return B100;
 }
@@ -731,43 +891,40 @@ double Tier3_Calculator::calcBmsy(double R, ostream& cout){
 double Tier3_Calculator::calcEqMMBatF(double R, double dirF, ostream& cout){
     if (debug) cout<<"starting Tier3_Calculator::calcEqMMBatF(double R, double dirF)"<<endl;
     //calculate equilibrium size distribution on July 1
-    d3_array n_msz = calcEqNatZFM(R,dirF,cout);
+    calcEqNatZFMInto(neq_msz,R,dirF,cout);
     
     //equilibrium MMB
     double mmb = 0;//dummy value    
     //advance to population to time of mating
     if (dtF<=dtM){ //fisheries occur BEFORE molting/growth/maturity 
-        d3_array n1_msz(1,nMSs,1,nSCs,1,nZBs);
-        d3_array n2_msz(1,nMSs,1,nSCs,1,nZBs);
-        d3_array n3_msz(1,nMSs,1,nSCs,1,nZBs);
         if (debug) cout<<"dtF<=dtM"<<endl;
         //apply natural mortality BEFORE fisheries
-        n1_msz = pPI->applyNM(dtF,n_msz, cout);
-        if (debug) {cout<<"n1_msz ="<<endl; wts::print(n1_msz,cout,1);}
+        pPI->applyNMInto(wrk1_msz,dtF,neq_msz, cout);
+        if (debug) {cout<<"n1_msz ="<<endl; wts::print(wrk1_msz,cout,1);}
         //apply fisheries
-        n2_msz = pCI->applyFM(dirF, n1_msz, cout);
-        if (debug) {cout<<"n2_msz ="<<endl; wts::print(n2_msz,cout,1);}
+        pCI->applyFMInto(wrk2_msz,dirF, wrk1_msz, cout);
+        if (debug) {cout<<"n2_msz ="<<endl; wts::print(wrk2_msz,cout,1);}
         //apply natural mortality after fisheries but before molting/growth
+        d3_array* pn3_msz = &wrk2_msz;
         if (dtF==dtM){
             if (debug) cout<<"dtF=dtM"<<endl;
-            n3_msz = n2_msz;
         } else {
             if (debug) cout<<"dtF<dtM"<<endl;
-            n3_msz = pPI->applyNM(dtM-dtF,n2_msz,cout);
+            pPI->applyNMInto(wrk3_msz,dtM-dtF,wrk2_msz,cout);
+            pn3_msz = &wrk3_msz;
         }
-        if (debug) {cout<<"n3_msz ="<<endl; wts::print(n3_msz,cout,1);}
+        if (debug) {cout<<"n3_msz ="<<endl; wts::print(*pn3_msz,cout,1);}
         
         //calculate mature biomass at mating
-        mmb = pPI->calcMatureBiomass(n3_msz,cout);
+        mmb = pPI->calcMatureBiomass(*pn3_msz,cout);
     } else { //fisheries occur AFTER molting/growth/maturity 
-        d3_array n1_msz(1,nMSs,1,nSCs,1,nZBs);
         if (debug) cout<<"dtF>dtM"<<endl;
         //apply natural mortality BEFORE molting/growth
-        n1_msz = pPI->applyNM(dtM,n_msz,cout);
-        if (debug) {cout<<"n1_msz ="<<endl; wts::print(n1_msz,cout,1);}
+        pPI->applyNMInto(wrk1_msz,dtM,neq_msz,cout);
+        if (debug) {cout<<"n1_msz ="<<endl; wts::print(wrk1_msz,cout,1);}
         
         //calculate mature biomass at mating
-        mmb = pPI->calcMatureBiomass(n1_msz,cout);
+        mmb = pPI->calcMatureBiomass(wrk1_msz,cout);
     }
     if (debug) cout<<"finished Tier3_Calculator::calcEqMMBatF(double R, double dirF)"<<endl;
     return mmb;
@@ -786,6 +943,14 @@ PopProjector::PopProjector(int npZBs, int npFsh){
     nMSs = tcsam::nMSs;
     nSCs = tcsam::nSCs;
     nZBs = npZBs;
+    nFsh = npFsh;
+    
+    //allocate output and work arrays
+    np_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
+    wrk1_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
+    wrk2_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
+    wrk3_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
+    wrk4_msz.allocate(1,nMSs,1,nSCs,1,nZBs);
 }
 
 /**
@@ -802,53 +967,60 @@ PopProjector::PopProjector(int npZBs, int npFsh){
  * 
  * @return final numbers-at-maturity state/shell condition/size, WITHOUT recruitment
  */
-d3_array PopProjector::project(double dirF, d3_array& n_msz, ostream& cout){
-    if (debug) cout<<"starting PopProjector::project(dirF, n_msz)"<<endl;
-    d3_array n1_msz(1,nMSs,1,nSCs,1,nZBs);
-    d3_array n2_msz(1,nMSs,1,nSCs,1,nZBs);
-    d3_array n3_msz(1,nMSs,1,nSCs,1,nZBs);
-    d3_array n4_msz(1,nMSs,1,nSCs,1,nZBs);
+d3_array PopProjector::project(double dirF, const d3_array& n_msz, ostream& cout){
     d3_array n5_msz(1,nMSs,1,nSCs,1,nZBs);
+    projectInto(n5_msz,dirF,n_msz,cout);
+    return n5_msz;
+}
+
+/**
+ * Project sex-specific component of population ahead one year, WITHOUT recruitment,
+ * into a caller-provided array (which may be n_msz itself). Intermediate 
+ * abundances are calculated in the work arrays wrk1_msz-wrk4_msz.
+ * Also calculates matBio and the pCI catch elements (see project(...)).
+ * 
+ * @param np_msz - (output) final numbers-at-maturity state/shell condition/size
+ * @param dirF - multiplier on fishing mortality rate in directed fishery
+ * @param n_msz - initial numbers-at-maturity state/shell condition/size
+ */
+void PopProjector::projectInto(d3_array& np_msz, double dirF, const d3_array& n_msz, ostream& cout){
+    if (debug) cout<<"starting PopProjector::project(dirF, n_msz)"<<endl;
+    d3_array* pn3_msz = &wrk2_msz;
     if (dtF<=dtM){ //fisheries occur BEFORE molting/growth/maturity 
         //apply natural mortality BEFORE fisheries
-        n1_msz = pPI->applyNM(dtF, n_msz,cout);
+        pPI->applyNMInto(wrk1_msz,dtF, n_msz,cout);
         //apply fisheries
-        n2_msz = pCI->applyFM(dirF, n1_msz,cout);
+        pCI->applyFMInto(wrk2_msz,dirF, wrk1_msz,cout);
         //apply natural mortality after fisheries but before molting/growth
-        if (dtF==dtM){
-            n3_msz = n2_msz;
-        } else {
-            n3_msz = pPI->applyNM(dtM-dtF, n2_msz,cout);
+        if (dtF!=dtM){
+            pPI->applyNMInto(wrk3_msz,dtM-dtF, wrk2_msz,cout);
+            pn3_msz = &wrk3_msz;
         }        
         //apply molting/growth
-        n4_msz = pPI->applyMG(n3_msz,cout);
-        //apply natural mortality AFTER molting/growth
-        n5_msz = pPI->applyNM(1.0-dtM, n4_msz,cout);
-        
+        pPI->applyMGInto(wrk4_msz,*pn3_msz,cout);
         //calculate spawning biomass from pre-molting/growth abundance
-        matBio = pPI->calcMatureBiomass(n3_msz,cout);
+        matBio = pPI->calcMatureBiomass(*pn3_msz,cout);
+        //apply natural mortality AFTER molting/growth
+        pPI->applyNMInto(np_msz,1.0-dtM, wrk4_msz,cout);
     } else { //fisheries occur AFTER molting/growth/maturity 
         //apply natural mortality BEFORE molting/growth
-        n1_msz = pPI->applyNM(dtM, n_msz,cout);        
+        pPI->applyNMInto(wrk1_msz,dtM, n_msz,cout);        
         //apply molting/growth
-        n2_msz = pPI->applyMG(n1_msz,cout);
+        pPI->applyMGInto(wrk2_msz,wrk1_msz,cout);
         //apply natural mortality after molting/growth but before fisheries
-        if (dtF==dtM){
-            n3_msz = n2_msz;
-        } else {
-            n3_msz = pPI->applyNM(dtF-dtM, n2_msz,cout);
+        if (dtF!=dtM){
+            pPI->applyNMInto(wrk3_msz,dtF-dtM, wrk2_msz,cout);
+            pn3_msz = &wrk3_msz;
         }
         //apply fisheries
-        n4_msz = pCI->applyFM(dirF, n3_msz,cout);
-        //apply natural mortality AFTER fisheries
-        n5_msz = pPI->applyNM(1.0-dtF, n4_msz,cout);
-        
+        pCI->applyFMInto(wrk4_msz,dirF, *pn3_msz,cout);
         //calculate spawning biomass from pre-molting/growth abundance
-        matBio = pPI->calcMatureBiomass(n1_msz,cout);
+        matBio = pPI->calcMatureBiomass(wrk1_msz,cout);
+        //apply natural mortality AFTER fisheries
+        pPI->applyNMInto(np_msz,1.0-dtF, wrk4_msz,cout);
     }
     
     if (debug) cout<<"finished PopProjector::project(dirF, n_msz)"<<endl;   
-    return n5_msz;
 }
 
 /**
@@ -858,41 +1030,38 @@ d3_array PopProjector::project(double dirF, d3_array& n_msz, ostream& cout){
  * 
  * @return MMB-at-mating
  */
-double PopProjector::projectMatureBiomass(double dirF, d3_array& n_msz, ostream& cout){
+double PopProjector::projectMatureBiomass(double dirF, const d3_array& n_msz, ostream& cout){
     if (debug) cout<<"starting PopProjector::projectMatureBiomass(dirF, n_msz)"<<endl;
     if (debug) cout<<"dtF = "<<dtF<<"; dtM = "<<dtM<<endl;
     if (dtF<=dtM){ //fisheries occur BEFORE molting/growth/maturity 
         if (debug) cout<<"dtF<=dtM"<<endl;
-        d3_array n1_msz(1,nMSs,1,nSCs,1,nZBs);
-        d3_array n2_msz(1,nMSs,1,nSCs,1,nZBs);
-        d3_array n3_msz(1,nMSs,1,nSCs,1,nZBs);
         //apply natural mortality BEFORE fisheries
-        n1_msz = pPI->applyNM(dtF,n_msz, cout);
-        if (debug) {cout<<"n1_msz ="<<endl; wts::print(n1_msz,cout,1);}
+        pPI->applyNMInto(wrk1_msz,dtF,n_msz, cout);
+        if (debug) {cout<<"n1_msz ="<<endl; wts::print(wrk1_msz,cout,1);}
         //apply fisheries
-        n2_msz = pCI->applyFM(dirF, n1_msz, cout);
-        if (debug) {cout<<"n2_msz ="<<endl; wts::print(n2_msz,cout,1);}
+        pCI->applyFMInto(wrk2_msz,dirF, wrk1_msz, cout);
+        if (debug) {cout<<"n2_msz ="<<endl; wts::print(wrk2_msz,cout,1);}
         //apply natural mortality after fisheries but before molting/growth
+        d3_array* pn3_msz = &wrk2_msz;
         if (dtF==dtM){
             if (debug) cout<<"dtF=dtM"<<endl;
-            n3_msz = n2_msz;
         } else {
             if (debug) cout<<"dtF<dtM"<<endl;
-            n3_msz = pPI->applyNM(dtM-dtF,n2_msz,cout);
+            pPI->applyNMInto(wrk3_msz,dtM-dtF,wrk2_msz,cout);
+            pn3_msz = &wrk3_msz;
         }
-        if (debug) {cout<<"n3_msz ="<<endl; wts::print(n3_msz,cout,1);}
+        if (debug) {cout<<"n3_msz ="<<endl; wts::print(*pn3_msz,cout,1);}
         
         //calculate mature biomass at mating
-        matBio = pPI->calcMatureBiomass(n3_msz,cout);
+        matBio = pPI->calcMatureBiomass(*pn3_msz,cout);
     } else { //fisheries occur AFTER molting/growth/maturity 
         if (debug) cout<<"dtF>dtM"<<endl;
-        d3_array n1_msz(1,nMSs,1,nSCs,1,nZBs);
         //apply natural mortality BEFORE molting/growth
-        n1_msz = pPI->applyNM(dtM,n_msz,cout);
-        if (debug) {cout<<"n1_msz ="<<endl; wts::print(n1_msz,cout,1);}
+        pPI->applyNMInto(wrk1_msz,dtM,n_msz,cout);
+        if (debug) {cout<<"n1_msz ="<<endl; wts::print(wrk1_msz,cout,1);}
         
         //calculate mature biomass at mating
-        matBio = pPI->calcMatureBiomass(n1_msz,cout);
+        matBio = pPI->calcMatureBiomass(wrk1_msz,cout);
     }
     
     if (debug) {
@@ -10,7 +10,7 @@
  * @param  w    - weighting vector
  * @return n_i  - dvector
  */
-dvector tcsam::sumOverLastDim(const dmatrix& n_ij, dvector& w){
+dvector tcsam::sumOverLastDim(const dmatrix& n_ij, const dvector& w){
     ivector bnds = wts::getBounds(n_ij);
     int d = 1;
     int mni = bnds(d++); int mxi = bnds(d++);
@@ -28,7 +28,7 @@ dvector tcsam::sumOverLastDim(const dmatrix& n_ij, dvector& w){
  * @param  w     - weighting vector
  * @return n_ij  - dmatrix
  */
-dmatrix tcsam::sumOverLastDim(const d3_array& n_ijk, dvector& w){
+dmatrix tcsam::sumOverLastDim(const d3_array& n_ijk, const dvector& w){
     ivector bnds = wts::getBounds(n_ijk);
     int d = 1;
     int mni = bnds(d++); int mxi = bnds(d++);
@@ -47,7 +47,7 @@ dmatrix tcsam::sumOverLastDim(const d3_array& n_ijk, dvector& w){
  * @param  w      - weighting vector
  * @return n_ijk  - d3_array
  */
-d3_array tcsam::sumOverLastDim(const d4_array& n_ijkl, dvector& w){
+d3_array tcsam::sumOverLastDim(const d4_array& n_ijkl, const dvector& w){
     ivector bnds = wts::getBounds(n_ijkl);
     int d = 1;
     int mni = bnds(d++); int mxi = bnds(d++);
@@ -67,7 +67,7 @@ d3_array tcsam::sumOverLastDim(const d4_array& n_ijkl, dvector& w){
  * @param  w    - weighting vector
  * @return n_ijkl  - d4_array
  */
-d4_array tcsam::sumOverLastDim(const d5_array& n_ijklm, dvector& w){
+d4_array tcsam::sumOverLastDim(const d5_array& n_ijklm, const dvector& w){
     ivector bnds = wts::getBounds(n_ijklm);
     int d = 1;
     int mni = bnds(d++); int mxi = bnds(d++);
@@ -88,7 +88,7 @@ d4_array tcsam::sumOverLastDim(const d5_array& n_ijklm, dvector& w){
  * @param  w    - weighting vector
  * @return n_ijklm  - d4_array
  */
-d5_array tcsam::sumOverLastDim(const d6_array& n_ijklmn, dvector& w){
+d5_array tcsam::sumOverLastDim(const d6_array& n_ijklmn, const dvector& w){
     ivector bnds = wts::getBounds(n_ijklmn);
     int d = 1;
     int mni = bnds(d++); int mxi = bnds(d++);
@@ -110,7 +110,7 @@ d5_array tcsam::sumOverLastDim(const d6_array& n_ijklmn, dvector& w){
  * @param  w         - weighting vector
  * @return n_ijklmn  - d6_array
  */
-d6_array tcsam::sumOverLastDim(const d7_array& n_ijklmno, dvector& w){
+d6_array tcsam::sumOverLastDim(const d7_array& n_ijklmno, const dvector& w){
     ivector bnds = wts::getBounds(n_ijklmno);
     int d = 1;
     int mni = bnds(d++); int mxi = bnds(d++);
@@ -126,29 +126,224 @@ d6_array tcsam::sumOverLastDim(const d7_array& n_ijklmno, dvector& w){
     return n;
 }
     
+//--------------------------------------------------------------------------------
+//          MarginalSums
+//--------------------------------------------------------------------------------
 /**
- * Calculate marginal sums over msz by iyx.
- * @param n_iyxmsz - array to calculate sums on
- * @return d3_array with dims iyx.
+ * Remove all requested marginals.
+ */
+void tcsam::MarginalSums::clear(){
+    types.clear(); isVar.clear(); pWs.clear(); pRs.clear();
+}
+
+/**
+ * Add a request for a marginal sum after checking that the marginal type
+ * is consistent with the rank of the destination array.
+ * 
+ * @param type - marginal type
+ * @param rank - number of dimensions of the destination array
+ * @param var  - flag indicating destination is a dvar array
+ * @param pR   - pointer to destination array
+ * @param pW   - pointer to weight-at-xmz array (0 for simple sums)
+ */
+void tcsam::MarginalSums::addRequest(int type, int rank, int var, void* pR, const d3_array* pW){
+    int rnk = 0;
+    switch (type){
+        case IYX: case IXY:                rnk = 3; break;
+        case IXYZ:                         rnk = 4; break;
+        case IYXMS: case IXMYZ: case IXSYZ: rnk = 5; break;
+    }
+    if (rnk!=rank){
+        cout<<"Error in tcsam::MarginalSums::add(...)"<<endl;
+        cout<<"Marginal type "<<type<<" is invalid for a destination array with "<<rank<<" dimensions."<<endl;
+        cout<<"Aborting..."<<endl;
+        exit(-1);
+    }
+    types.push_back(type);
+    isVar.push_back(var);
+    pWs.push_back(pW);
+    pRs.push_back(pR);
+}
+
+void tcsam::MarginalSums::add(int type, d3_array& r)                    {addRequest(type,3,0,&r,0);}
+void tcsam::MarginalSums::add(int type, d3_array& r, const d3_array& w_xmz)   {addRequest(type,3,0,&r,&w_xmz);}
+void tcsam::MarginalSums::add(int type, d4_array& r)                    {addRequest(type,4,0,&r,0);}
+void tcsam::MarginalSums::add(int type, d4_array& r, const d3_array& w_xmz)   {addRequest(type,4,0,&r,&w_xmz);}
+void tcsam::MarginalSums::add(int type, d5_array& r)                    {addRequest(type,5,0,&r,0);}
+void tcsam::MarginalSums::add(int type, d5_array& r, const d3_array& w_xmz)   {addRequest(type,5,0,&r,&w_xmz);}
+void tcsam::MarginalSums::add(int type, dvar3_array& r)                 {addRequest(type,3,1,&r,0);}
+void tcsam::MarginalSums::add(int type, dvar3_array& r, const d3_array& w_xmz){addRequest(type,3,1,&r,&w_xmz);}
+void tcsam::MarginalSums::add(int type, dvar4_array& r)                 {addRequest(type,4,1,&r,0);}
+void tcsam::MarginalSums::add(int type, dvar4_array& r, const d3_array& w_xmz){addRequest(type,4,1,&r,&w_xmz);}
+void tcsam::MarginalSums::add(int type, dvar5_array& r)                 {addRequest(type,5,1,&r,0);}
+void tcsam::MarginalSums::add(int type, dvar5_array& r, const d3_array& w_xmz){addRequest(type,5,1,&r,&w_xmz);}
+
+/**
+ * Check that all destination arrays are consistent with the source array type.
+ * 
+ * @param var - flag indicating source is a dvar array
+ */
+void tcsam::MarginalSums::checkRequests(int var){
+    for (int r=0;r<(int)types.size();r++){
+        if (isVar[r]!=var){
+            cout<<"Error in tcsam::MarginalSums::calc(...)"<<endl;
+            cout<<"Destination array for request "<<r+1<<" must be a "<<(var?"dvar":"double")<<" array"<<endl;
+            cout<<"to be consistent with the source array."<<endl;
+            cout<<"Aborting..."<<endl;
+            exit(-1);
+        }
+    }
+}
+
+/**
+ * Calculate all requested marginal sums of n_iyxmsz in a single
+ * traversal in storage order.
+ * 
+ * @param n_iyxmsz - source array
  */
-d3_array tcsam::calcIYXfromIYXMSZ(d6_array& n_iyxmsz){
-    ivector bnds = wts::getBounds(n_iyxmsz);
-    int mni = bnds( 1); int mxi = bnds( 2);
-    int mny = bnds( 3); int mxy = bnds( 4);
-    int mnx = bnds( 5); int mxx = bnds( 6);
-    int mnm = bnds( 7); int mxm = bnds( 8);
-    int mns = bnds( 9); int mxs = bnds(10);
-    int mnz = bnds(11); int mxz = bnds(12);
-    d3_array n_iyx(mni,mxi,mny,mxy,mnx,mxx);
-    n_iyx.initialize();
+void tcsam::MarginalSums::calc(const d6_array& n_iyxmsz){
+    checkRequests(0);
+    int mni = n_iyxmsz.indexmin();                 int mxi = n_iyxmsz.indexmax();
+    const d5_array& n1 = n_iyxmsz(mni);
+    int mny = n1.indexmin();                       int mxy = n1.indexmax();
+    int mnx = n1(mny).indexmin();                  int mxx = n1(mny).indexmax();
+    int mnm = n1(mny,mnx).indexmin();              int mxm = n1(mny,mnx).indexmax();
+    int mns = n1(mny,mnx,mnm).indexmin();          int mxs = n1(mny,mnx,mnm).indexmax();
+    int mnz = n1(mny,mnx,mnm,mns).indexmin();      int mxz = n1(mny,mnx,mnm,mns).indexmax();
+    
+    //allocate destination arrays
+    int nR = types.size();
+    int useTot = 0;//flag to calculate simple sums over z
+    for (int r=0;r<nR;r++){
+        if (!pWs[r]&&((types[r]==IYX)||(types[r]==IXY)||(types[r]==IYXMS))) useTot = 1;
+        switch (types[r]){
+            case IYX:   {d3_array& a = *((d3_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mny,mxy,mnx,mxx); a.initialize();} break;
+            case IXY:   {d3_array& a = *((d3_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mnx,mxx,mny,mxy); a.initialize();} break;
+            case IYXMS: {d5_array& a = *((d5_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mny,mxy,mnx,mxx,mnm,mxm,mns,mxs); a.initialize();} break;
+            case IXYZ:  {d4_array& a = *((d4_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mnx,mxx,mny,mxy,mnz,mxz); a.initialize();} break;
+            case IXMYZ: {d5_array& a = *((d5_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mnx,mxx,mnm,mxm,mny,mxy,mnz,mxz); a.initialize();} break;
+            case IXSYZ: {d5_array& a = *((d5_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mnx,mxx,mns,mxs,mny,mxy,mnz,mxz); a.initialize();} break;
+        }
+    }
+    
+    double tot = 0.0;
     for (int i=mni;i<=mxi;i++){
-        for (int x=mnx;x<=mxx;x++){
-            for (int y=mny;y<=mxy;y++){
-                n_iyx(i,y,x) = sum(n_iyxmsz(i,y,x));
-            }
+        for (int y=mny;y<=mxy;y++){
+            for (int x=mnx;x<=mxx;x++){
+                for (int m=mnm;m<=mxm;m++){
+                    for (int s=mns;s<=mxs;s++){
+                        const dvector& n_z = n_iyxmsz(i,y,x,m,s);
+                        if (useTot) tot = sum(n_z);
+                        for (int r=0;r<nR;r++){
+                            const d3_array* pW = pWs[r];
+                            switch (types[r]){
+                                case IYX:
+                                    if (pW) (*((d3_array*) pRs[r]))(i,y,x) += n_z*(*pW)(x,m); else (*((d3_array*) pRs[r]))(i,y,x) += tot;
+                                    break;
+                                case IXY:
+                                    if (pW) (*((d3_array*) pRs[r]))(i,x,y) += n_z*(*pW)(x,m); else (*((d3_array*) pRs[r]))(i,x,y) += tot;
+                                    break;
+                                case IYXMS:
+                                    if (pW) (*((d5_array*) pRs[r]))(i,y,x,m,s) = n_z*(*pW)(x,m);  else (*((d5_array*) pRs[r]))(i,y,x,m,s) = tot;
+                                    break;
+                                case IXYZ:
+                                    if (pW) (*((d4_array*) pRs[r]))(i,x,y) += elem_prod(n_z,(*pW)(x,m)); else (*((d4_array*) pRs[r]))(i,x,y) += n_z;
+                                    break;
+                                case IXMYZ:
+                                    if (pW) (*((d5_array*) pRs[r]))(i,x,m,y) += elem_prod(n_z,(*pW)(x,m)); else (*((d5_array*) pRs[r]))(i,x,m,y) += n_z;
+                                    break;
+                                case IXSYZ:
+                                    if (pW) (*((d5_array*) pRs[r]))(i,x,s,y) += elem_prod(n_z,(*pW)(x,m)); else (*((d5_array*) pRs[r]))(i,x,s,y) += n_z;
+                                    break;
+                            }
+                        }//r
+                    }//s
+                }//m
+            }//x
+        }//y
+    }//i
+}
+
+/**
+ * Calculate all requested marginal sums of n_iyxmsz in a single
+ * traversal in storage order.
+ * 
+ * @param n_iyxmsz - source array
+ */
+void tcsam::MarginalSums::calc(const dvar6_array& n_iyxmsz){
+    checkRequests(1);
+    int mni = n_iyxmsz.indexmin();                 int mxi = n_iyxmsz.indexmax();
+    const dvar5_array& n1 = n_iyxmsz(mni);
+    int mny = n1.indexmin();                       int mxy = n1.indexmax();
+    int mnx = n1(mny).indexmin();                  int mxx = n1(mny).indexmax();
+    int mnm = n1(mny,mnx).indexmin();              int mxm = n1(mny,mnx).indexmax();
+    int mns = n1(mny,mnx,mnm).indexmin();          int mxs = n1(mny,mnx,mnm).indexmax();
+    int mnz = n1(mny,mnx,mnm,mns).indexmin();      int mxz = n1(mny,mnx,mnm,mns).indexmax();
+    
+    //allocate destination arrays
+    int nR = types.size();
+    int useTot = 0;//flag to calculate simple sums over z
+    for (int r=0;r<nR;r++){
+        if (!pWs[r]&&((types[r]==IYX)||(types[r]==IXY)||(types[r]==IYXMS))) useTot = 1;
+        switch (types[r]){
+            case IYX:   {dvar3_array& a = *((dvar3_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mny,mxy,mnx,mxx); a.initialize();} break;
+            case IXY:   {dvar3_array& a = *((dvar3_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mnx,mxx,mny,mxy); a.initialize();} break;
+            case IYXMS: {dvar5_array& a = *((dvar5_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mny,mxy,mnx,mxx,mnm,mxm,mns,mxs); a.initialize();} break;
+            case IXYZ:  {dvar4_array& a = *((dvar4_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mnx,mxx,mny,mxy,mnz,mxz); a.initialize();} break;
+            case IXMYZ: {dvar5_array& a = *((dvar5_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mnx,mxx,mnm,mxm,mny,mxy,mnz,mxz); a.initialize();} break;
+            case IXSYZ: {dvar5_array& a = *((dvar5_array*) pRs[r]); a.deallocate(); a.allocate(mni,mxi,mnx,mxx,mns,mxs,mny,mxy,mnz,mxz); a.initialize();} break;
         }
     }
-    return n_iyx;
+    
+    dvariable tot;
+    for (int i=mni;i<=mxi;i++){
+        for (int y=mny;y<=mxy;y++){
+            for (int x=mnx;x<=mxx;x++){
+                for (int m=mnm;m<=mxm;m++){
+                    for (int s=mns;s<=mxs;s++){
+                        const dvar_vector& n_z = n_iyxmsz(i,y,x,m,s);
+                        if (useTot) tot = sum(n_z);
+                        for (int r=0;r<nR;r++){
+                            const d3_array* pW = pWs[r];
+                            switch (types[r]){
+                                case IYX:
+                                    if (pW) (*((dvar3_array*) pRs[r]))(i,y,x) += n_z*(*pW)(x,m); else (*((dvar3_array*) pRs[r]))(i,y,x) += tot;
+                                    break;
+                                case IXY:
+                                    if (pW) (*((dvar3_array*) pRs[r]))(i,x,y) += n_z*(*pW)(x,m); else (*((dvar3_array*) pRs[r]))(i,x,y) += tot;
+                                    break;
+                                case IYXMS:
+                                    if (pW) (*((dvar5_array*) pRs[r]))(i,y,x,m,s) = n_z*(*pW)(x,m);  else (*((dvar5_array*) pRs[r]))(i,y,x,m,s) = tot;
+                                    break;
+                                case IXYZ:
+                                    if (pW) (*((dvar4_array*) pRs[r]))(i,x,y) += elem_prod(n_z,(*pW)(x,m)); else (*((dvar4_array*) pRs[r]))(i,x,y) += n_z;
+                                    break;
+                                case IXMYZ:
+                                    if (pW) (*((dvar5_array*) pRs[r]))(i,x,m,y) += elem_prod(n_z,(*pW)(x,m)); else (*((dvar5_array*) pRs[r]))(i,x,m,y) += n_z;
+                                    break;
+                                case IXSYZ:
+                                    if (pW) (*((dvar5_array*) pRs[r]))(i,x,s,y) += elem_prod(n_z,(*pW)(x,m)); else (*((dvar5_array*) pRs[r]))(i,x,s,y) += n_z;
+                                    break;
+                            }
+                        }//r
+                    }//s
+                }//m
+            }//x
+        }//y
+    }//i
+}
+
+/**
+ * Calculate marginal sums over msz by iyx.
+ * @param n_iyxmsz - array to calculate sums on
+ * @return d3_array with dims iyx.
+ */
+d3_array tcsam::calcIYXfromIYXMSZ(const d6_array& n_iyxmsz){
+    d3_array r;
+    MarginalSums ms;
+    ms.add(MarginalSums::IYX,r);
+    ms.calc(n_iyxmsz);
+    return r;
 }
 
 /**
@@ -157,26 +352,12 @@ d3_array tcsam::calcIYXfromIYXMSZ(d6_array& n_iyxmsz){
  * @param w_xmz - weight-at-xmz array
  * @return d3_array with dims iyx.
  */
-d3_array tcsam::calcIYXfromIYXMSZ(d6_array& n_iyxmsz, d3_array w_xmz){
-    ivector bnds = wts::getBounds(n_iyxmsz);
-    int mni = bnds( 1); int mxi = bnds( 2);
-    int mny = bnds( 3); int mxy = bnds( 4);
-    int mnx = bnds( 5); int mxx = bnds( 6);
-    int mnm = bnds( 7); int mxm = bnds( 8);
-    int mns = bnds( 9); int mxs = bnds(10);
-    int mnz = bnds(11); int mxz = bnds(12);
-    d3_array b_iyx(mni,mxi,mny,mxy,mnx,mxx);
-    b_iyx.initialize();
-    for (int i=mni;i<=mxi;i++){
-        for (int x=mnx;x<=mxx;x++){
-            for (int y=mny;y<=mxy;y++){
-                for (int m=mnm;m<=mxm;m++){
-                    for (int s=mns;s<=mxs;s++) b_iyx(i,y,x) += n_iyxmsz(i,y,x,m,s)*w_xmz(x,m);//dot product here
-                }
-            }
-        }
-    }
-    return b_iyx;
+d3_array tcsam::calcIYXfromIYXMSZ(const d6_array& n_iyxmsz, const d3_array& w_xmz){
+    d3_array r;
+    MarginalSums ms;
+    ms.add(MarginalSums::IYX,r,w_xmz);
+    ms.calc(n_iyxmsz);
+    return r;
 }
 
 /**
@@ -185,27 +366,12 @@ d3_array tcsam::calcIYXfromIYXMSZ(d6_array& n_iyxmsz, d3_array w_xmz){
  * @param w_xmz - weight-at-xmz array
  * @return d5_array with dims iyxms.
  */
-d5_array tcsam::calcIYXMSfromIYXMSZ(d6_array& n_iyxmsz, d3_array w_xmz){
-    ivector bnds = wts::getBounds(n_iyxmsz);
-    int d = 1;
-    int mni = bnds(d++); int mxi = bnds(d++);
-    int mny = bnds(d++); int mxy = bnds(d++);
-    int mnx = bnds(d++); int mxx = bnds(d++);
-    int mnm = bnds(d++); int mxm = bnds(d++);
-    int mns = bnds(d++); int mxs = bnds(d++);
-    int mnz = bnds(d++); int mxz = bnds(d++);
-    d5_array b_iyxms(mni,mxi,mny,mxy,mnx,mxx,mnm,mxm,mns,mxs);
-    b_iyxms.initialize();
-    for (int i=mni;i<=mxi;i++){
-        for (int x=mnx;x<=mxx;x++){
-            for (int y=mny;y<=mxy;y++){
-                for (int m=mnm;m<=mxm;m++){
-                    for (int s=mns;s<=mxs;s++) b_iyxms(i,y,x,m,s) = n_iyxmsz(i,y,x,m,s)*w_xmz(x,m);//dot product here
-                }
-            }
-        }
-    }
-    return b_iyxms;
+d5_array tcsam::calcIYXMSfromIYXMSZ(const d6_array& n_iyxmsz, const d3_array& w_xmz){
+    d5_array r;
+    MarginalSums ms;
+    ms.add(MarginalSums::IYXMS,r,w_xmz);
+    ms.calc(n_iyxmsz);
+    return r;
 }
 
 /**
@@ -214,7 +380,7 @@ d5_array tcsam::calcIYXMSfromIYXMSZ(d6_array& n_iyxmsz, d3_array w_xmz){
  * @param w_xmz - weight-at-xmz array
  * @return d4_array with dims yxms.
  */
-d4_array tcsam::calcYXMSfromYXMSZ(d5_array& n_yxmsz, d3_array w_xmz){
+d4_array tcsam::calcYXMSfromYXMSZ(const d5_array& n_yxmsz, const d3_array& w_xmz){
     ivector bnds = wts::getBounds(n_yxmsz);
     int d = 1;
     int mny = bnds(d++); int mxy = bnds(d++);
@@ -224,8 +390,8 @@ d4_array tcsam::calcYXMSfromYXMSZ(d5_array& n_yxmsz, d3_array w_xmz){
     int mnz = bnds(d++); int mxz = bnds(d++);
     d4_array b_yxms(mny,mxy,mnx,mxx,mnm,mxm,mns,mxs);
     b_yxms.initialize();
-    for (int x=mnx;x<=mxx;x++){
-        for (int y=mny;y<=mxy;y++){
+    for (int y=mny;y<=mxy;y++){
+        for (int x=mnx;x<=mxx;x++){
             for (int m=mnm;m<=mxm;m++){
                 for (int s=mns;s<=mxs;s++) b_yxms(y,x,m,s) = n_yxmsz(y,x,m,s)*w_xmz(x,m);//dot product here
             }
@@ -239,24 +405,12 @@ d4_array tcsam::calcYXMSfromYXMSZ(d5_array& n_yxmsz, d3_array w_xmz){
  * @param n_iyxmsz - array to calculate sums on
  * @return d3_array with dims ixy.
  */
-d3_array tcsam::calcIXYfromIYXMSZ(d6_array& n_iyxmsz){
-    ivector bnds = wts::getBounds(n_iyxmsz);
-    int mni = bnds( 1); int mxi = bnds( 2);
-    int mny = bnds( 3); int mxy = bnds( 4);
-    int mnx = bnds( 5); int mxx = bnds( 6);
-    int mnm = bnds( 7); int mxm = bnds( 8);
-    int mns = bnds( 9); int mxs = bnds(10);
-    int mnz = bnds(11); int mxz = bnds(12);
-    d3_array n_ixy(mni,mxi,mnx,mxx,mny,mxy);
-    n_ixy.initialize();
-    for (int i=mni;i<=mxi;i++){
-        for (int x=mnx;x<=mxx;x++){
-            for (int y=mny;y<=mxy;y++){
-                n_ixy(i,x,y) = sum(n_iyxmsz(i,y,x));
-            }
-        }
-    }
-    return n_ixy;
+d3_array tcsam::calcIXYfromIYXMSZ(const d6_array& n_iyxmsz){
+    d3_array r;
+    MarginalSums ms;
+    ms.add(MarginalSums::IXY,r);
+    ms.calc(n_iyxmsz);
+    return r;
 }
 
 /**
@@ -265,26 +419,12 @@ d3_array tcsam::calcIXYfromIYXMSZ(d6_array& n_iyxmsz){
  * @param w_xmz - weight-at-xmz array
  * @return d3_array with dims ixy.
  */
-d3_array tcsam::calcIXYfromIYXMSZ(d6_array& n_iyxmsz, d3_array w_xmz){
-    ivector bnds = wts::getBounds(n_iyxmsz);
-    int mni = bnds( 1); int mxi = bnds( 2);
-    int mny = bnds( 3); int mxy = bnds( 4);
-    int mnx = bnds( 5); int mxx = bnds( 6);
-    int mnm = bnds( 7); int mxm = bnds( 8);
-    int mns = bnds( 9); int mxs = bnds(10);
-    int mnz = bnds(11); int mxz = bnds(12);
-    d3_array b_ixy(mni,mxi,mnx,mxx,mny,mxy);
-    b_ixy.initialize();
-    for (int i=mni;i<=mxi;i++){
-        for (int x=mnx;x<=mxx;x++){
-            for (int y=mny;y<=mxy;y++){
-                for (int m=mnm;m<=mxm;m++){
-                    for (int s=mns;s<=mxs;s++) b_ixy(i,x,y) += n_iyxmsz(i,y,x,m,s)*w_xmz(x,m);//dot product here
-                }
-            }
-        }
-    }
-    return b_ixy;
+d3_array tcsam::calcIXYfromIYXMSZ(const d6_array& n_iyxmsz, const d3_array& w_xmz){
+    d3_array r;
+    MarginalSums ms;
+    ms.add(MarginalSums::IXY,r,w_xmz);
+    ms.calc(n_iyxmsz);
+    return r;
 }
 
 /**
@@ -292,28 +432,12 @@ d3_array tcsam::calcIXYfromIYXMSZ(d6_array& n_iyxmsz, d3_array w_xmz){
  * @param n_iyxmsz - array to calculate sums on
  * @return d4_array with dims ixyz.
  */
-d4_array tcsam::calcIXYZfromIYXMSZ(d6_array& n_iyxmsz){
-    ivector bnds = wts::getBounds(n_iyxmsz);
-    int mni = bnds( 1); int mxi = bnds( 2);
-    int mny = bnds( 3); int mxy = bnds( 4);
-    int mnx = bnds( 5); int mxx = bnds( 6);
-    int mnm = bnds( 7); int mxm = bnds( 8);
-    int mns = bnds( 9); int mxs = bnds(10);
-    int mnz = bnds(11); int mxz = bnds(12);
-    d4_array n_ixyz(mni,mxi,mnx,mxx,mny,mxy,mnz,mxz);
-    n_ixyz.initialize();
-    for (int i=mni;i<=mxi;i++){
-        for (int x=mnx;x<=mxx;x++){
-            for (int y=mny;y<=mxy;y++){
-                for (int z=mnz;z<=mxz;z++) {
-                    for (int m=mnm;m<=mxm;m++) {
-                        for (int s=mns;s<=mxs;s++) n_ixyz(i,x,y,z) += n_iyxmsz(i,y,x,m,s,z);
-                    }
-                }
-            }
-        }
-    }
-    return n_ixyz;
+d4_array tcsam::calcIXYZfromIYXMSZ(const d6_array& n_iyxmsz){
+    d4_array r;
+    MarginalSums ms;
+    ms.add(MarginalSums::IXYZ,r);
+    ms.calc(n_iyxmsz);
+    return r;
 }
 
 /**
@@ -321,28 +445,12 @@ d4_array tcsam::calcIXYZfromIYXMSZ(d6_array& n_iyxmsz){
  * @param n_iyxmsz - array to calculate sums on
  * @return d5_array with dims ixmyz.
  */
-d5_array tcsam::calcIXMYZfromIYXMSZ(d6_array& n_iyxmsz){
-    ivector bnds = wts::getBounds(n_iyxmsz);
-    int mni = bnds( 1); int mxi = bnds( 2);
-    int mny = bnds( 3); int mxy = bnds( 4);
-    int mnx = bnds( 5); int mxx = bnds( 6);
-    int mnm = bnds( 7); int mxm = bnds( 8);
-    int mns = bnds( 9); int mxs = bnds(10);
-    int mnz = bnds(11); int mxz = bnds(12);
-    d5_array n_ixmyz(mni,mxi,mnx,mxx,mnm,mxm,mny,mxy,mnz,mxz);
-    n_ixmyz.initialize();
-    for (int i=mni;i<=mxi;i++){
-        for (int x=mnx;x<=mxx;x++){
-            for (int y=mny;y<=mxy;y++){
-                for (int z=mnz;z<=mxz;z++) {
-                    for (int m=mnm;m<=mxm;m++) {
-                        for (int s=mns;s<=mxs;s++) n_ixmyz(i,x,m,y,z) += n_iyxmsz(i,y,x,m,s,z);
-                    }
-                }
-            }
-        }
-    }
-    return n_ixmyz;
+d5_array tcsam::calcIXMYZfromIYXMSZ(const d6_array& n_iyxmsz){
+    d5_array r;
+    MarginalSums ms;
+    ms.add(MarginalSums::IXMYZ,r);
+    ms.calc(n_iyxmsz);
+    return r;
 }
 
 /**
@@ -352,28 +460,12 @@ d5_array tcsam::calcIXMYZfromIYXMSZ(d6_array& n_iyxmsz){
  * 
  * @return d5_array with indices ixsyz
  */
-d5_array tcsam::calcIXSYZfromIYXMSZ(d6_array& n_iyxmsz){
-    ivector bnds = wts::getBounds(n_iyxmsz);
-    int mni = bnds( 1); int mxi = bnds( 2);
-    int mny = bnds( 3); int mxy = bnds( 4);
-    int mnx = bnds( 5); int mxx = bnds( 6);
-    int mnm = bnds( 7); int mxm = bnds( 8);
-    int mns = bnds( 9); int mxs = bnds(10);
-    int mnz = bnds(11); int mxz = bnds(12);
-    d5_array n_ixsyz(mni,mxi,mnx,mxx,mns,mxs,mny,mxy,mnz,mxz);
-    n_ixsyz.initialize();
-    for (int i=mni;i<=mxi;i++){
-        for (int x=mnx;x<=mxx;x++){
-            for (int y=mny;y<=mxy;y++){
-                for (int z=mnz;z<=mxz;z++) {
-                    for (int m=mnm;m<=mxm;m++) {
-                        for (int s=mns;s<=mxs;s++) n_ixsyz(i,x,s,y,z) += n_iyxmsz(i,y,x,m,s,z);
-                    }
-                }
-            }
-        }
-    }
-    return n_ixsyz;
+d5_array tcsam::calcIXSYZfromIYXMSZ(const d6_array& n_iyxmsz){
+    d5_array r;
+    MarginalSums ms;
+    ms.add(MarginalSums::IXSYZ,r);
+    ms.calc(n_iyxmsz);
+    return r;
 }
 
 d5_array tcsam::rearrangeYXMSZtoXMSYZ(d5_array& n_yxmsz){
@@ -428,7 +520,7 @@ d6_array tcsam::rearrangeIYXMSZtoIXMSYZ(d6_array& n_iyxmsz){
  * 
  * @return extracted vector (indices consistent with z's)
  */
-dvector tcsam::extractFromXMSYZ(int x, int m, int s, int y, d5_array& n_xmsyz){
+dvector tcsam::extractFromXMSYZ(int x, int m, int s, int y, const d5_array& n_xmsyz){
     ivector bnds = wts::getBounds(n_xmsyz);
     dvector n_z(bnds(9,10));//dimension for z index
     int xmn, xmx;
@@ -460,7 +552,7 @@ dvector tcsam::extractFromXMSYZ(int x, int m, int s, int y, d5_array& n_xmsyz){
  * 
  * @return extracted double value
  */
-double tcsam::extractFromYXMS(int y, int x, int m, int s, d4_array& n_yxms){
+double tcsam::extractFromYXMS(int y, int x, int m, int s, const d4_array& n_yxms){
 //    rpt::echo<<"in extractFromYXMS"<<endl;
 //    rpt::echo<<y<<" "<<x<<" "<<m<<" "<<" "<<s<<endl;
     int xmn, xmx;
@@ -494,7 +586,7 @@ double tcsam::extractFromYXMS(int y, int x, int m, int s, d4_array& n_yxms){
  * 
  * @return extracted vector (indices consistent with z's)
  */
-dvector tcsam::extractFromYXMSZ(int y, int x, int m, int s, d5_array& n_yxmsz){
+dvector tcsam::extractFromYXMSZ(int y, int x, int m, int s, const d5_array& n_yxmsz){
     ivector bnds = wts::getBounds(n_yxmsz);
 //    cout<<"in extractFromYXMSZ"<<endl;
     dvector n_z(bnds(9),bnds(10));//dimension for z index
@@ -0,0 +1,84 @@
+#!/bin/bash
+#
+# Compare a new TCSAM2015 build against a baseline build on the Tanner2014 inputs.
+#
+# Usage: ./compareBaseline.TCSAM2015.sh path/to/baseline/tcsam2015 path/to/new/tcsam2015 [rel. tolerance]
+#
+# For each executable (run in sibling folders ../cmp.base.* and ../cmp.new.*,
+# so the relative paths in Model.Config.dat resolve):
+#   1. one evaluation per phase at the initial parameter values (-maxfn 0).
+#      n_yxmsz (written to EchoData.dat in PRELIMINARY_CALCS_SECTION), the
+#      objective function value and the gradient table printed by the
+#      minimizer for the final phase are extracted.
+#   2. a full estimation (-nohess), which is timed. The objective function
+#      value and maximum gradient from the .par header and the parameter
+#      values are extracted (the .par file is named after the executable).
+# Numbers are compared with the given relative tolerance (default 1.0e-10);
+# the script exits non-zero if any comparison fails.
+#
+DIR="$( cd "$( dirname "$0" )" && pwd )"
+cd ${DIR}
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 baselineExe newExe [tolerance]"
+    exit 1
+fi
+EXE_BASE="$( cd "$( dirname "$1" )" && pwd )/$( basename "$1" )"
+EXE_NEW="$( cd "$( dirname "$2" )" && pwd )/$( basename "$2" )"
+TOL=${3:-1.0e-10}
+OPTS="-rs -nox -configFile ../input.Tanner2014/Model.Config.dat -nohess"
+TIMEFORMAT=%R
+
+#--run the model in ../cmp.$1.eval0 and ../cmp.$1.est using executable $2
+runModel(){
+    #1. evaluation at initial values
+    rm -rf ${DIR}/../cmp.$1.eval0; mkdir -p ${DIR}/../cmp.$1.eval0; cd ${DIR}/../cmp.$1.eval0
+    $2 ${OPTS} -maxfn 0 > run.log 2>&1
+    awk '/^n_yxmsz:/{f=1;next} /^(testing|Test)/{f=0} f' EchoData.dat > n_yxmsz.txt
+    awk '/final statistics/{n=NR; delete g; k=0} n&&/^ *[0-9]+ +[-0-9.eE+]+ +[-0-9.eE+]+/{
+            gsub(/\|/," "); for (i=1;i<=NF;i+=3) g[++k]=$i" "$(i+2)} END{for (i=1;i<=k;i++) print g[i]}' run.log > gradients.txt
+    grep -h "Objective function value" *.par | sed 's/.*Objective function value = *\([^ ]*\).*/\1/' > objfun.txt
+    #2. full estimation
+    rm -rf ${DIR}/../cmp.$1.est; mkdir -p ${DIR}/../cmp.$1.est; cd ${DIR}/../cmp.$1.est
+    { time $2 ${OPTS} > run.log 2>&1 ; } 2> time.txt
+    head -1 *.par | sed 's/.*Objective function value = *\([^ ]*\).*Maximum gradient component = *\([^ ]*\).*/\1 \2/' > objfun.txt
+    grep -hv "^#" *.par > pars.txt
+    cd ${DIR}
+}
+
+#--compare numbers in files $1 and $2 (token by token), reporting the max. relative difference
+compareFiles(){
+    awk -v tol=${TOL} -v lbl="$3" '
+        NR==FNR {for (i=1;i<=NF;i++) a[++na]=$i; next}
+                {for (i=1;i<=NF;i++) b[++nb]=$i}
+        END {
+            if (na!=nb) {printf("%-28s FAILED: %d vs %d values\n",lbl,na,nb); exit 1}
+            if (na==0)  {printf("%-28s FAILED: no values found\n",lbl); exit 1}
+            mx = 0; nf = 0;
+            for (i=1;i<=na;i++){
+                if (a[i]==b[i]) continue;
+                if ((a[i]+0)!=a[i] || (b[i]+0)!=b[i]) {nf++; continue}
+                d = a[i]-b[i]; if (d<0) d = -d;
+                s = (a[i]<0 ? -a[i] : a[i]); if (s<1) s = 1;
+                if (d/s>mx) mx = d/s;
+                if (d/s>tol) nf++;
+            }
+            printf("%-28s %s: %d values, max rel. diff = %g\n",lbl,(nf ? "FAILED" : "ok"),na,mx);
+            exit (nf ? 1 : 0);
+        }' $1 $2
+}
+
+echo "running baseline: ${EXE_BASE}"
+runModel base ${EXE_BASE}
+echo "running new:      ${EXE_NEW}"
+runModel new  ${EXE_NEW}
+
+B=${DIR}/../cmp.base
+N=${DIR}/../cmp.new
+STATUS=0
+compareFiles ${B}.eval0/n_yxmsz.txt   ${N}.eval0/n_yxmsz.txt   "initial n_yxmsz"            || STATUS=1
+compareFiles ${B}.eval0/objfun.txt    ${N}.eval0/objfun.txt    "initial objective function" || STATUS=1
+compareFiles ${B}.eval0/gradients.txt ${N}.eval0/gradients.txt "initial gradients"          || STATUS=1
+compareFiles ${B}.est/objfun.txt      ${N}.est/objfun.txt      "final objfun, max gradient" || STATUS=1
+compareFiles ${B}.est/pars.txt        ${N}.est/pars.txt        "final parameter values"     || STATUS=1
+echo "estimation time (s): baseline = $(cat ${B}.est/time.txt), new = $(cat ${N}.est/time.txt)"
+exit ${STATUS}